@@ -0,0 +1,407 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "BreakableDestructionSubsystem.h"
+#include "TemporalDash.h"
+#include "BreakableStructure.h"
+#include "GeometryCollection/GeometryCollectionComponent.h"
+#include "GeometryCollection/GeometryCollectionObject.h"
+#include "GeometryCollection/GeometryCollection.h"
+#include "GeometryCollection/GeometryCollectionSimulationTypes.h"
+#include "Field/FieldSystemObjects.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+#include "GameFramework/PlayerController.h"
+
+DECLARE_CYCLE_STAT(TEXT("Destruction Budget Tick"), STAT_BreakableDestructionTick, STATGROUP_BreakableDestruction);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Active Debris Bodies (Estimated)"), STAT_BreakableActiveBodies, STATGROUP_BreakableDestruction);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Tracked Breaks"), STAT_BreakableTrackedBreaks, STATGROUP_BreakableDestruction);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Coarse Breaks"), STAT_BreakableCoarseBreaks, STATGROUP_BreakableDestruction);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Breaks Slept Over Budget"), STAT_BreakableBudgetSleeps, STATGROUP_BreakableDestruction);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Physics Phase Time (ms)"), STAT_BreakablePhysicsTime, STATGROUP_BreakableDestruction);
+
+void FBreakableDestructionTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Subsystem)
+	{
+		Subsystem->MarkPhysicsPhase(bPhysicsStart);
+	}
+}
+
+FString FBreakableDestructionTickFunction::DiagnosticMessage()
+{
+	return TEXT("FBreakableDestructionTickFunction");
+}
+
+FName FBreakableDestructionTickFunction::DiagnosticContext(bool bDetailed)
+{
+	return FName(TEXT("BreakableDestruction"));
+}
+
+void UBreakableDestructionSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// debris is put to sleep and removed through fields, filtered so the intact parts of the structure stay put
+	SleepField = NewObject<UUniformInteger>(this);
+	SleepField->SetUniformInteger(static_cast<int32>(EObjectStateTypeEnum::Chaos_Object_Sleeping));
+
+	RemoveField = NewObject<UUniformScalar>(this);
+	RemoveField->SetUniformScalar(1.0f);
+
+	DynamicFilter = NewObject<UFieldSystemMetaDataFilter>(this);
+	DynamicFilter->SetMetaDataFilterType(EFieldFilterType::Field_Filter_Dynamic, EFieldObjectType::Field_Object_Destruction, EFieldPositionType::Field_Position_CenterOfMass);
+
+	SleepingFilter = NewObject<UFieldSystemMetaDataFilter>(this);
+	SleepingFilter->SetMetaDataFilterType(EFieldFilterType::Field_Filter_Sleeping, EFieldObjectType::Field_Object_Destruction, EFieldPositionType::Field_Position_CenterOfMass);
+
+	DestructionHandle = ABreakableStructure::OnAnyStructureDestruction.AddUObject(this, &UBreakableDestructionSubsystem::OnStructureDestruction);
+}
+
+void UBreakableDestructionSubsystem::Deinitialize()
+{
+	ABreakableStructure::OnAnyStructureDestruction.Remove(DestructionHandle);
+
+	for (FBreakableDestructionTickFunction* TickFunction : { &PhysicsStartTickFunction, &PhysicsEndTickFunction })
+	{
+		if (TickFunction->IsTickFunctionRegistered())
+		{
+			TickFunction->UnRegisterTickFunction();
+		}
+
+		TickFunction->Subsystem = nullptr;
+	}
+
+	Breaks.Reset();
+	OriginalDamageThresholds.Reset();
+
+	Super::Deinitialize();
+}
+
+void UBreakableDestructionSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// time the physics phase from the moment the solver is kicked off until the frame waits on its results
+	PhysicsStartTickFunction.Subsystem = this;
+	PhysicsStartTickFunction.bPhysicsStart = true;
+	PhysicsStartTickFunction.bCanEverTick = true;
+	PhysicsStartTickFunction.bStartWithTickEnabled = true;
+	PhysicsStartTickFunction.bRunOnAnyThread = false;
+	PhysicsStartTickFunction.TickGroup = TG_StartPhysics;
+	PhysicsStartTickFunction.AddPrerequisite(&InWorld, InWorld.StartPhysicsTickFunction);
+	PhysicsStartTickFunction.RegisterTickFunction(InWorld.PersistentLevel);
+
+	PhysicsEndTickFunction.Subsystem = this;
+	PhysicsEndTickFunction.bPhysicsStart = false;
+	PhysicsEndTickFunction.bCanEverTick = true;
+	PhysicsEndTickFunction.bStartWithTickEnabled = true;
+	PhysicsEndTickFunction.bRunOnAnyThread = false;
+	PhysicsEndTickFunction.TickGroup = TG_PostPhysics;
+	PhysicsEndTickFunction.RegisterTickFunction(InWorld.PersistentLevel);
+}
+
+bool UBreakableDestructionSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UBreakableDestructionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBreakableDestructionSubsystem, STATGROUP_Tickables);
+}
+
+void UBreakableDestructionSubsystem::MarkPhysicsPhase(bool bStart)
+{
+	if (bStart)
+	{
+		PhysicsStartCycles = FPlatformTime::Cycles64();
+
+	} else if (PhysicsStartCycles != 0) {
+
+		SET_FLOAT_STAT(STAT_BreakablePhysicsTime, FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - PhysicsStartCycles));
+		PhysicsStartCycles = 0;
+	}
+}
+
+void UBreakableDestructionSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BreakableDestructionTick);
+
+	Super::Tick(DeltaTime);
+
+	UWorld* World = GetWorld();
+	const double Now = World->GetTimeSeconds();
+
+	// debris only matters near the players
+	TArray<FVector, TInlineAllocator<4>> ViewLocations;
+
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (const APlayerController* PC = It->Get())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+			ViewLocations.Add(ViewLocation);
+		}
+	}
+
+	NumActiveBodies = 0;
+
+	for (int32 i = Breaks.Num() - 1; i >= 0; --i)
+	{
+		FBreak& Break = Breaks[i];
+
+		if (!Break.Structure.IsValid())
+		{
+			Breaks.RemoveAtSwap(i, EAllowShrinking::No);
+			continue;
+		}
+
+		const double Age = Now - Break.StartTime;
+
+		double DistanceSquared = ViewLocations.IsEmpty() ? 0.0 : TNumericLimits<double>::Max();
+
+		for (const FVector& ViewLocation : ViewLocations)
+		{
+			DistanceSquared = FMath::Min(DistanceSquared, FVector::DistSquared(ViewLocation, Break.Location));
+		}
+
+		// old, far away and small debris is removed altogether
+		if (Age > (Break.bSmall ? SmallDebrisLifetime : RemoveAge) || DistanceSquared > FMath::Square(RemoveDistance))
+		{
+			RemoveBreak(Break);
+			Breaks.RemoveAtSwap(i, EAllowShrinking::No);
+			continue;
+		}
+
+		// settled or unseen debris stops simulating
+		if (!Break.bAsleep && (Age > SleepAge || DistanceSquared > FMath::Square(SleepDistance)))
+		{
+			SleepBreak(Break);
+		}
+
+		if (!Break.bAsleep)
+		{
+			NumActiveBodies += Break.NumBodies;
+		}
+	}
+
+	// restore full fracture detail once there's room in the budget again
+	if (NumActiveBodies < MaxActiveBodies * CoarseFractureBudgetFraction)
+	{
+		for (auto It = OriginalDamageThresholds.CreateIterator(); It; ++It)
+		{
+			if (UGeometryCollectionComponent* GeometryCollection = It->Key.ResolveObjectPtr())
+			{
+				GeometryCollection->SetDamageThreshold(It->Value);
+			}
+
+			It.RemoveCurrent();
+		}
+	}
+
+	SET_DWORD_STAT(STAT_BreakableActiveBodies, NumActiveBodies);
+	SET_DWORD_STAT(STAT_BreakableTrackedBreaks, Breaks.Num());
+}
+
+void UBreakableDestructionSubsystem::OnStructureDestruction(ABreakableStructure* Structure)
+{
+	// cached fractures aren't simulated, so they don't count against the budget
+	if (!IsValid(Structure) || Structure->GetWorld() != GetWorld() || Structure->IsCachingDestruction())
+	{
+		return;
+	}
+
+	// close to the budget, new breaks only shatter into big chunks
+	const bool bCoarse = NumActiveBodies >= MaxActiveBodies * CoarseFractureBudgetFraction;
+	const int32 MaxClusterLevel = bCoarse ? CoarseMaxClusterLevel : MAX_int32;
+
+	if (bCoarse)
+	{
+		INC_DWORD_STAT(STAT_BreakableCoarseBreaks);
+	}
+
+	// a structure that's hit again restarts its existing break
+	FBreak* Break = Breaks.FindByPredicate([Structure](const FBreak& Existing) { return Existing.Structure == Structure; });
+
+	if (Break)
+	{
+		if (!Break->bAsleep)
+		{
+			NumActiveBodies -= Break->NumBodies;
+		}
+
+	} else {
+
+		Break = &Breaks.AddDefaulted_GetRef();
+		Break->Structure = Structure;
+	}
+
+	Break->Components.Reset();
+	Break->StartTime = GetWorld()->GetTimeSeconds();
+	Break->NumBodies = 0;
+	Break->bAsleep = false;
+
+	FBox Bounds(ForceInit);
+
+	TInlineComponentArray<UGeometryCollectionComponent*> GeometryCollections(Structure);
+
+	for (UGeometryCollectionComponent* GeometryCollection : GeometryCollections)
+	{
+		SetMaxClusterLevel(GeometryCollection, MaxClusterLevel);
+
+		Break->Components.Add(GeometryCollection);
+		Break->NumBodies += CountReleasedPieces(GeometryCollection, MaxClusterLevel);
+
+		Bounds += GeometryCollection->Bounds.GetBox();
+	}
+
+	Break->Bounds = Bounds.IsValid ? Bounds : FBox(Structure->GetActorLocation(), Structure->GetActorLocation());
+	Break->Location = Break->Bounds.GetCenter();
+	Break->bSmall = Bounds.IsValid && Bounds.GetExtent().Size() < SmallDebrisRadius;
+
+	NumActiveBodies += Break->NumBodies;
+
+	EnforceBudget();
+}
+
+void UBreakableDestructionSubsystem::SetMaxClusterLevel(UGeometryCollectionComponent* GeometryCollection, int32 MaxClusterLevel)
+{
+	const TObjectKey<UGeometryCollectionComponent> Key(GeometryCollection);
+
+	if (MaxClusterLevel == MAX_int32)
+	{
+		// put back the authored thresholds
+		if (const TArray<float>* Original = OriginalDamageThresholds.Find(Key))
+		{
+			GeometryCollection->SetDamageThreshold(*Original);
+			OriginalDamageThresholds.Remove(Key);
+		}
+
+		return;
+	}
+
+	const TArray<float>& Original = OriginalDamageThresholds.Contains(Key) ? OriginalDamageThresholds[Key] : OriginalDamageThresholds.Add(Key, GeometryCollection->DamageThreshold);
+
+	// keep the authored thresholds down to the coarse level, and make every deeper level unbreakable.
+	// The last threshold applies to all the levels below it
+	TArray<float> Thresholds;
+	Thresholds.Reserve(MaxClusterLevel + 1);
+
+	for (int32 Level = 0; Level < MaxClusterLevel; ++Level)
+	{
+		Thresholds.Add(Original.IsEmpty() ? 0.0f : Original[FMath::Min(Level, Original.Num() - 1)]);
+	}
+
+	Thresholds.Add(TNumericLimits<float>::Max());
+
+	GeometryCollection->SetDamageThreshold(Thresholds);
+}
+
+void UBreakableDestructionSubsystem::SleepBreak(FBreak& Break)
+{
+	for (const TWeakObjectPtr<UGeometryCollectionComponent>& WeakGeometryCollection : Break.Components)
+	{
+		if (UGeometryCollectionComponent* GeometryCollection = WeakGeometryCollection.Get())
+		{
+			GeometryCollection->ApplyPhysicsField(true, EGeometryCollectionPhysicsTypeEnum::Chaos_DynamicState, DynamicFilter, SleepField);
+		}
+	}
+
+	Break.bAsleep = true;
+
+	OnDebrisSettled.Broadcast(Break.Structure.Get(), Break.Bounds);
+}
+
+void UBreakableDestructionSubsystem::RemoveBreak(FBreak& Break)
+{
+	for (const TWeakObjectPtr<UGeometryCollectionComponent>& WeakGeometryCollection : Break.Components)
+	{
+		if (UGeometryCollectionComponent* GeometryCollection = WeakGeometryCollection.Get())
+		{
+			GeometryCollection->ApplyPhysicsField(true, EGeometryCollectionPhysicsTypeEnum::Chaos_Kill, DynamicFilter, RemoveField);
+			GeometryCollection->ApplyPhysicsField(true, EGeometryCollectionPhysicsTypeEnum::Chaos_Kill, SleepingFilter, RemoveField);
+		}
+	}
+
+	// sleeping debris was already reported when it went to sleep
+	if (!Break.bAsleep)
+	{
+		OnDebrisSettled.Broadcast(Break.Structure.Get(), Break.Bounds);
+	}
+}
+
+void UBreakableDestructionSubsystem::EnforceBudget()
+{
+	if (NumActiveBodies <= MaxActiveBodies)
+	{
+		return;
+	}
+
+	// oldest debris first, it's had the most time to settle
+	TArray<FBreak*, TInlineAllocator<32>> Simulating;
+
+	for (FBreak& Break : Breaks)
+	{
+		if (!Break.bAsleep)
+		{
+			Simulating.Add(&Break);
+		}
+	}
+
+	Simulating.Sort([](const FBreak& A, const FBreak& B) { return A.StartTime < B.StartTime; });
+
+	for (FBreak* Break : Simulating)
+	{
+		if (NumActiveBodies <= MaxActiveBodies)
+		{
+			break;
+		}
+
+		SleepBreak(*Break);
+		NumActiveBodies -= Break->NumBodies;
+
+		INC_DWORD_STAT(STAT_BreakableBudgetSleeps);
+	}
+}
+
+int32 UBreakableDestructionSubsystem::CountReleasedPieces(const UGeometryCollectionComponent* GeometryCollection, int32 MaxClusterLevel)
+{
+	const UGeometryCollection* RestCollection = GeometryCollection->GetRestCollection();
+	const TSharedPtr<FGeometryCollection, ESPMode::ThreadSafe> Collection = RestCollection ? RestCollection->GetGeometryCollection() : nullptr;
+
+	if (!Collection)
+	{
+		return 0;
+	}
+
+	// a piece is released if it sits at the deepest level that can break, or it's a leaf above it.
+	// Without level data, assume the whole collection shatters into its leaves
+	const TManagedArray<int32>* Levels = Collection->FindAttribute<int32>("Level", FTransformCollection::TransformGroup);
+	const int32 NumTransforms = Collection->NumElements(FTransformCollection::TransformGroup);
+
+	int32 NumPieces = 0;
+
+	for (int32 Index = 0; Index < NumTransforms; ++Index)
+	{
+		const bool bLeaf = Collection->Children[Index].IsEmpty();
+
+		if (!Levels)
+		{
+			NumPieces += bLeaf ? 1 : 0;
+			continue;
+		}
+
+		const int32 Level = (*Levels)[Index];
+
+		if (Level > 0 && (Level == MaxClusterLevel || (Level < MaxClusterLevel && bLeaf)))
+		{
+			++NumPieces;
+		}
+	}
+
+	return NumPieces;
+}
@@ -0,0 +1,196 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineBaseTypes.h"
+#include "BreakableDestructionSubsystem.generated.h"
+
+class ABreakableStructure;
+class UGeometryCollectionComponent;
+class UBreakableDestructionSubsystem;
+class UUniformInteger;
+class UUniformScalar;
+class UFieldSystemMetaDataFilter;
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FBreakableDebrisSettledDelegate, ABreakableStructure*, const FBox&);
+
+/**
+ *  Marks the start or end of the physics phase of the frame, so the destruction subsystem can time the solver
+ */
+USTRUCT()
+struct FBreakableDestructionTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	/** Subsystem to notify */
+	UBreakableDestructionSubsystem* Subsystem = nullptr;
+
+	/** True for the start of the physics phase, false for its end */
+	bool bPhysicsStart = false;
+
+	/** Notifies the subsystem */
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+
+	/** Returns the tick function name for diagnostics */
+	virtual FString DiagnosticMessage() override;
+
+	/** Returns the tick function context for diagnostics */
+	virtual FName DiagnosticContext(bool bDetailed) override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FBreakableDestructionTickFunction> : public TStructOpsTypeTraitsBase2<FBreakableDestructionTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+/**
+ *  Keeps the cost of breakable structure debris under a global budget
+ *  Every break is tracked with an estimate of the rigid bodies it released. Debris is put to sleep after a while or when it's far from every player,
+ *  and removed once it's old or very far away. Small structures are removed early since their debris is barely noticeable
+ *  When the active body estimate gets close to the budget, new breaks only fracture down to a coarse cluster level,
+ *  and if it goes over, the oldest simulating debris is put to sleep
+ *  Coarse fracturing relies on per level damage thresholds, so it has no effect on geometry collections that use size specific thresholds
+ */
+UCLASS(config=Game)
+class TEMPORALDASH_API UBreakableDestructionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Max number of debris rigid bodies simulating at once */
+	UPROPERTY(config, EditAnywhere, Category="Destruction", meta = (ClampMin = 0))
+	int32 MaxActiveBodies = 400;
+
+	/** Fraction of the budget above which new breaks only fracture down to the coarse cluster level */
+	UPROPERTY(config, EditAnywhere, Category="Destruction", meta = (ClampMin = 0, ClampMax = 1))
+	float CoarseFractureBudgetFraction = 0.75f;
+
+	/** Deepest cluster level new breaks can release while over the coarse fracture fraction */
+	UPROPERTY(config, EditAnywhere, Category="Destruction", meta = (ClampMin = 1))
+	int32 CoarseMaxClusterLevel = 1;
+
+	/** Debris is put to sleep after simulating for this long */
+	UPROPERTY(config, EditAnywhere, Category="Destruction", meta = (ClampMin = 0, Units = "s"))
+	float SleepAge = 5.0f;
+
+	/** Debris further than this from every player is put to sleep */
+	UPROPERTY(config, EditAnywhere, Category="Destruction", meta = (ClampMin = 0, Units = "cm"))
+	float SleepDistance = 4000.0f;
+
+	/** Debris is removed after this long */
+	UPROPERTY(config, EditAnywhere, Category="Destruction", meta = (ClampMin = 0, Units = "s"))
+	float RemoveAge = 30.0f;
+
+	/** Debris further than this from every player is removed */
+	UPROPERTY(config, EditAnywhere, Category="Destruction", meta = (ClampMin = 0, Units = "cm"))
+	float RemoveDistance = 10000.0f;
+
+	/** Structures with a bounding radius below this count as small debris */
+	UPROPERTY(config, EditAnywhere, Category="Destruction", meta = (ClampMin = 0, Units = "cm"))
+	float SmallDebrisRadius = 100.0f;
+
+	/** Small debris is removed after this long */
+	UPROPERTY(config, EditAnywhere, Category="Destruction", meta = (ClampMin = 0, Units = "s"))
+	float SmallDebrisLifetime = 2.0f;
+
+	/** A tracked break */
+	struct FBreak
+	{
+		TWeakObjectPtr<ABreakableStructure> Structure;
+		TArray<TWeakObjectPtr<UGeometryCollectionComponent>> Components;
+		FBox Bounds = FBox(ForceInit);
+		FVector Location = FVector::ZeroVector;
+		double StartTime = 0.0;
+		int32 NumBodies = 0;
+		bool bSmall = false;
+		bool bAsleep = false;
+	};
+
+	/** Tracked breaks */
+	TArray<FBreak> Breaks;
+
+	/** Estimated number of debris bodies currently simulating */
+	int32 NumActiveBodies = 0;
+
+	/** Original per level damage thresholds of geometry collections we coarsened */
+	TMap<TObjectKey<UGeometryCollectionComponent>, TArray<float>> OriginalDamageThresholds;
+
+	/** Field that puts debris to sleep */
+	UPROPERTY(Transient)
+	TObjectPtr<UUniformInteger> SleepField;
+
+	/** Field that removes debris from the simulation */
+	UPROPERTY(Transient)
+	TObjectPtr<UUniformScalar> RemoveField;
+
+	/** Limits the fields to simulating debris, so the intact parts of a structure are left alone */
+	UPROPERTY(Transient)
+	TObjectPtr<UFieldSystemMetaDataFilter> DynamicFilter;
+
+	/** Limits the fields to sleeping debris */
+	UPROPERTY(Transient)
+	TObjectPtr<UFieldSystemMetaDataFilter> SleepingFilter;
+
+	/** Tick functions around the physics phase of the frame */
+	FBreakableDestructionTickFunction PhysicsStartTickFunction;
+	FBreakableDestructionTickFunction PhysicsEndTickFunction;
+
+	/** Cycles at the start of this frame's physics phase */
+	uint64 PhysicsStartCycles = 0;
+
+	/** Handle for the breakable structure destruction delegate */
+	FDelegateHandle DestructionHandle;
+
+public:
+
+	/** Subsystem initialization */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Subsystem cleanup */
+	virtual void Deinitialize() override;
+
+	/** Registers the physics phase tick functions */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Only game worlds need a budget */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Sleeps and removes debris by age and distance */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for the tickable */
+	virtual TStatId GetStatId() const override;
+
+	/** Called by the tick functions at the start and end of the physics phase */
+	void MarkPhysicsPhase(bool bStart);
+
+	/** Called once per break when its debris stops moving, either because it was put to sleep or removed. Passes the bounds of the structure before it broke */
+	FBreakableDebrisSettledDelegate OnDebrisSettled;
+
+protected:
+
+	/** Starts tracking a break and picks its fracture detail before it happens */
+	void OnStructureDestruction(ABreakableStructure* Structure);
+
+	/** Limits or restores the cluster levels a geometry collection can break down to */
+	void SetMaxClusterLevel(UGeometryCollectionComponent* GeometryCollection, int32 MaxClusterLevel);
+
+	/** Puts the simulating debris of a break to sleep */
+	void SleepBreak(FBreak& Break);
+
+	/** Removes the debris of a break from the simulation */
+	void RemoveBreak(FBreak& Break);
+
+	/** Puts the oldest simulating breaks to sleep until the active body estimate is within budget */
+	void EnforceBudget();
+
+	/** Returns the estimated number of pieces a geometry collection releases when broken down to a cluster level */
+	static int32 CountReleasedPieces(const UGeometryCollectionComponent* GeometryCollection, int32 MaxClusterLevel);
+};
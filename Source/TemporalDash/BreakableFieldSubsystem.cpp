@@ -0,0 +1,193 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "BreakableFieldSubsystem.h"
+#include "TemporalDash.h"
+#include "Field/FieldSystemActor.h"
+#include "Field/FieldSystemComponent.h"
+#include "Field/FieldSystemObjects.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Field Batching"), STAT_BreakableFieldBatching, STATGROUP_BreakableDestruction);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Field Impacts Queued"), STAT_BreakableFieldImpactsQueued, STATGROUP_BreakableDestruction);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Field Impacts Applied"), STAT_BreakableFieldImpactsApplied, STATGROUP_BreakableDestruction);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Field Commands"), STAT_BreakableFieldCommands, STATGROUP_BreakableDestruction);
+
+void UBreakableFieldSubsystem::Deinitialize()
+{
+	if (IsValid(FieldActor))
+	{
+		FieldActor->Destroy();
+	}
+
+	FieldActor = nullptr;
+	Impacts.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UBreakableFieldSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UBreakableFieldSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBreakableFieldSubsystem, STATGROUP_Tickables);
+}
+
+void UBreakableFieldSubsystem::QueueImpact(const FVector& Location, float Strain, float Radius, float Speed)
+{
+	INC_DWORD_STAT(STAT_BreakableFieldImpactsQueued);
+
+	// find the closest impact we could merge into
+	FImpact* Closest = nullptr;
+	double ClosestDistanceSquared = TNumericLimits<double>::Max();
+
+	for (FImpact& Impact : Impacts)
+	{
+		const double DistanceSquared = FVector::DistSquared(Impact.Location, Location);
+
+		if (DistanceSquared < ClosestDistanceSquared)
+		{
+			ClosestDistanceSquared = DistanceSquared;
+			Closest = &Impact;
+		}
+	}
+
+	if (!Closest || (ClosestDistanceSquared > FMath::Square(MergeDistance) && Impacts.Num() < MaxImpactsPerFrame))
+	{
+		Impacts.Add({ Location, Strain, Radius, Speed });
+		return;
+	}
+
+	// move the merged impact towards the stronger hit and grow it to cover both
+	const float Alpha = Strain / FMath::Max(Closest->Strain + Strain, UE_SMALL_NUMBER);
+	const FVector MergedLocation = FMath::Lerp(Closest->Location, Location, Alpha);
+
+	Closest->Radius = FMath::Max(Closest->Radius + FVector::Dist(Closest->Location, MergedLocation), Radius + FVector::Dist(Location, MergedLocation));
+	Closest->Location = MergedLocation;
+	Closest->Strain = FMath::Max(Closest->Strain, Strain);
+	Closest->Speed = FMath::Max(Closest->Speed, Speed);
+}
+
+void UBreakableFieldSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (Impacts.IsEmpty())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_BreakableFieldBatching);
+
+	AFieldSystemActor* Actor = GetFieldActor();
+
+	if (!Actor)
+	{
+		Impacts.Reset();
+		return;
+	}
+
+	NumFalloffsUsed = 0;
+	NumRadialVectorsUsed = 0;
+	NumOperatorsUsed = 0;
+	NumSumVectorsUsed = 0;
+
+	// add up every impact into one strain field and one velocity field
+	UFieldNodeBase* StrainField = nullptr;
+	UFieldNodeVector* VelocityField = nullptr;
+
+	for (const FImpact& Impact : Impacts)
+	{
+		URadialFalloff* ImpactStrain = AcquireFalloff(Impact, Impact.Strain);
+		USumVector* ImpactVelocity = AcquireSumVector(AcquireFalloff(Impact, Impact.Speed), nullptr, AcquireRadialVector(Impact));
+
+		StrainField = StrainField ? static_cast<UFieldNodeBase*>(AcquireOperator(StrainField, ImpactStrain)) : ImpactStrain;
+		VelocityField = VelocityField ? static_cast<UFieldNodeVector*>(AcquireSumVector(nullptr, VelocityField, ImpactVelocity)) : ImpactVelocity;
+	}
+
+	// one command each for every solver in the world
+	UFieldSystemComponent* FieldComponent = Actor->GetFieldSystemComponent();
+	FieldComponent->ApplyPhysicsField(true, EFieldPhysicsType::Field_ExternalClusterStrain, nullptr, StrainField);
+	FieldComponent->ApplyPhysicsField(true, EFieldPhysicsType::Field_LinearVelocity, DynamicFilter, VelocityField);
+
+	INC_DWORD_STAT_BY(STAT_BreakableFieldImpactsApplied, Impacts.Num());
+	INC_DWORD_STAT_BY(STAT_BreakableFieldCommands, 2);
+
+	Impacts.Reset();
+}
+
+AFieldSystemActor* UBreakableFieldSubsystem::GetFieldActor()
+{
+	if (IsValid(FieldActor))
+	{
+		return FieldActor;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParams.ObjectFlags |= RF_Transient;
+
+	FieldActor = GetWorld()->SpawnActor<AFieldSystemActor>(FVector::ZeroVector, FRotator::ZeroRotator, SpawnParams);
+
+	// the velocity field should only push the pieces that broke off
+	DynamicFilter = NewObject<UFieldSystemMetaDataFilter>(this);
+	DynamicFilter->SetMetaDataFilterType(EFieldFilterType::Field_Filter_Dynamic, EFieldObjectType::Field_Object_Destruction, EFieldPositionType::Field_Position_CenterOfMass);
+
+	return FieldActor;
+}
+
+URadialFalloff* UBreakableFieldSubsystem::AcquireFalloff(const FImpact& Impact, float Magnitude)
+{
+	if (NumFalloffsUsed == FalloffPool.Num())
+	{
+		FalloffPool.Add(NewObject<URadialFalloff>(this));
+	}
+
+	URadialFalloff* Falloff = FalloffPool[NumFalloffsUsed++];
+	Falloff->SetRadialFalloff(Magnitude, 0.0f, 1.0f, 0.0f, Impact.Radius, Impact.Location, EFieldFalloffType::Field_Falloff_Linear);
+
+	return Falloff;
+}
+
+URadialVector* UBreakableFieldSubsystem::AcquireRadialVector(const FImpact& Impact)
+{
+	if (NumRadialVectorsUsed == RadialVectorPool.Num())
+	{
+		RadialVectorPool.Add(NewObject<URadialVector>(this));
+	}
+
+	URadialVector* RadialVector = RadialVectorPool[NumRadialVectorsUsed++];
+	RadialVector->SetRadialVector(1.0f, Impact.Location);
+
+	return RadialVector;
+}
+
+UOperatorField* UBreakableFieldSubsystem::AcquireOperator(const UFieldNodeBase* Left, const UFieldNodeBase* Right)
+{
+	if (NumOperatorsUsed == OperatorPool.Num())
+	{
+		OperatorPool.Add(NewObject<UOperatorField>(this));
+	}
+
+	UOperatorField* Operator = OperatorPool[NumOperatorsUsed++];
+	Operator->SetOperatorField(1.0f, Left, Right, EFieldOperationType::Field_Add);
+
+	return Operator;
+}
+
+USumVector* UBreakableFieldSubsystem::AcquireSumVector(const URadialFalloff* Scale, const UFieldNodeVector* Left, const UFieldNodeVector* Right)
+{
+	if (NumSumVectorsUsed == SumVectorPool.Num())
+	{
+		SumVectorPool.Add(NewObject<USumVector>(this));
+	}
+
+	// with a single vector, the scale is all that's applied. With two, they're added up
+	USumVector* SumVector = SumVectorPool[NumSumVectorsUsed++];
+	SumVector->SetSumVector(1.0f, Scale, Right, Left, EFieldOperationType::Field_Add);
+
+	return SumVector;
+}
@@ -0,0 +1,117 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "BreakableFieldSubsystem.generated.h"
+
+class AFieldSystemActor;
+class URadialFalloff;
+class URadialVector;
+class UOperatorField;
+class USumVector;
+class UFieldNodeBase;
+class UFieldNodeVector;
+class UFieldSystemMetaDataFilter;
+
+/**
+ *  Applies the fields that break breakable structures natively, batched per frame
+ *  Impacts queued during a frame are merged when they're close, and all of them are sent to the Chaos solver
+ *  as a single strain command and a single velocity command at the end of the frame
+ *  The field actor and field nodes are pooled and reused every frame instead of being spawned per explosion
+ */
+UCLASS(config=Game)
+class TEMPORALDASH_API UBreakableFieldSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Impacts closer than this are merged into one */
+	UPROPERTY(config, EditAnywhere, Category="Fields", meta = (ClampMin = 0, Units = "cm"))
+	float MergeDistance = 150.0f;
+
+	/** Max number of merged impacts per frame. Any more are folded into the closest one */
+	UPROPERTY(config, EditAnywhere, Category="Fields", meta = (ClampMin = 1))
+	int32 MaxImpactsPerFrame = 16;
+
+	/** An impact waiting for the end of the frame */
+	struct FImpact
+	{
+		FVector Location = FVector::ZeroVector;
+		float Strain = 0.0f;
+		float Radius = 0.0f;
+		float Speed = 0.0f;
+	};
+
+	/** Impacts queued this frame, already merged */
+	TArray<FImpact> Impacts;
+
+	/** Pooled actor the fields are applied through */
+	UPROPERTY(Transient)
+	TObjectPtr<AFieldSystemActor> FieldActor;
+
+	/** Pooled field nodes. They're copied into the solver command when it's applied, so they can be reused every frame */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<URadialFalloff>> FalloffPool;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<URadialVector>> RadialVectorPool;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UOperatorField>> OperatorPool;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<USumVector>> SumVectorPool;
+
+	/** Limits the velocity field to the pieces that broke off */
+	UPROPERTY(Transient)
+	TObjectPtr<UFieldSystemMetaDataFilter> DynamicFilter;
+
+	/** Pool entries used this frame */
+	int32 NumFalloffsUsed = 0;
+	int32 NumRadialVectorsUsed = 0;
+	int32 NumOperatorsUsed = 0;
+	int32 NumSumVectorsUsed = 0;
+
+public:
+
+	/** Subsystem cleanup */
+	virtual void Deinitialize() override;
+
+	/** Only game worlds break structures */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Applies the impacts queued this frame */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for the tickable */
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 *  Queues an impact to be applied at the end of the frame
+	 *  @param Location center of the impact
+	 *  @param Strain strain applied to the clusters in range, compared against their damage thresholds
+	 *  @param Radius range of the impact
+	 *  @param Speed speed the broken pieces are pushed away from the center with
+	 */
+	void QueueImpact(const FVector& Location, float Strain, float Radius, float Speed);
+
+protected:
+
+	/** Returns the field actor, spawning it the first time */
+	AFieldSystemActor* GetFieldActor();
+
+	/** Returns a pooled falloff node set up for an impact */
+	URadialFalloff* AcquireFalloff(const FImpact& Impact, float Magnitude);
+
+	/** Returns a pooled radial vector node set up for an impact */
+	URadialVector* AcquireRadialVector(const FImpact& Impact);
+
+	/** Returns a pooled operator node adding up two scalar fields */
+	UOperatorField* AcquireOperator(const UFieldNodeBase* Left, const UFieldNodeBase* Right);
+
+	/** Returns a pooled node that scales a vector field, or adds two of them up */
+	USumVector* AcquireSumVector(const URadialFalloff* Scale, const UFieldNodeVector* Left, const UFieldNodeVector* Right);
+};
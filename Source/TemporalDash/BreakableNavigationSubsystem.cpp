@@ -0,0 +1,277 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "BreakableNavigationSubsystem.h"
+#include "TemporalDash.h"
+#include "BreakableStructure.h"
+#include "BreakableDestructionSubsystem.h"
+#include "AIController.h"
+#include "Navigation/PathFollowingComponent.h"
+#include "NavigationSystem.h"
+#include "NavMesh/RecastNavMesh.h"
+#include "Engine/World.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Nav Tiles Pending"), STAT_BreakableNavTilesPending, STATGROUP_BreakableDestruction);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Nav Tiles Marked Dirty"), STAT_BreakableNavTilesDirtied, STATGROUP_BreakableDestruction);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Nav Re-paths"), STAT_BreakableNavRepaths, STATGROUP_BreakableDestruction);
+
+void UBreakableNavigationSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// settled debris comes from the destruction budget, so make sure it's around
+	Collection.InitializeDependency<UBreakableDestructionSubsystem>();
+
+	DestructionHandle = ABreakableStructure::OnAnyStructureDestruction.AddUObject(this, &UBreakableNavigationSubsystem::OnStructureDestruction);
+}
+
+void UBreakableNavigationSubsystem::Deinitialize()
+{
+	ABreakableStructure::OnAnyStructureDestruction.Remove(DestructionHandle);
+
+	if (UBreakableDestructionSubsystem* Destruction = GetWorld()->GetSubsystem<UBreakableDestructionSubsystem>())
+	{
+		Destruction->OnDebrisSettled.Remove(SettledHandle);
+	}
+
+	if (UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld()))
+	{
+		NavSys->OnNavigationGenerationFinishedDelegate.RemoveDynamic(this, &UBreakableNavigationSubsystem::OnNavigationGenerationFinished);
+	}
+
+	PendingSettles.Reset();
+	PendingTiles.Reset();
+	PendingTileSet.Reset();
+	RebuildingAreas.Reset();
+
+	Super::Deinitialize();
+}
+
+void UBreakableNavigationSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (UBreakableDestructionSubsystem* Destruction = InWorld.GetSubsystem<UBreakableDestructionSubsystem>())
+	{
+		SettledHandle = Destruction->OnDebrisSettled.AddUObject(this, &UBreakableNavigationSubsystem::OnDebrisSettled);
+	}
+
+	// the navigation system is created after the subsystems are initialized, so bind to it here
+	if (UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(&InWorld))
+	{
+		NavSys->OnNavigationGenerationFinishedDelegate.AddUniqueDynamic(this, &UBreakableNavigationSubsystem::OnNavigationGenerationFinished);
+	}
+}
+
+bool UBreakableNavigationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UBreakableNavigationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBreakableNavigationSubsystem, STATGROUP_Tickables);
+}
+
+void UBreakableNavigationSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	// cached fractures settle on a timer
+	for (int32 i = PendingSettles.Num() - 1; i >= 0; --i)
+	{
+		if (!PendingSettles[i].Structure.IsValid())
+		{
+			PendingSettles.RemoveAtSwap(i, EAllowShrinking::No);
+
+		} else if (Now >= PendingSettles[i].SettleTime) {
+
+			ABreakableStructure* Structure = PendingSettles[i].Structure.Get();
+			PendingSettles.RemoveAtSwap(i, EAllowShrinking::No);
+
+			FVector Origin, Extent;
+			Structure->GetActorBounds(true, Origin, Extent);
+
+			OnDebrisSettled(Structure, FBox(Origin - Extent, Origin + Extent));
+		}
+	}
+
+	SET_DWORD_STAT(STAT_BreakableNavTilesPending, PendingTiles.Num());
+
+	if (PendingTiles.IsEmpty() && RebuildingAreas.IsEmpty())
+	{
+		return;
+	}
+
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	const ARecastNavMesh* NavMesh = GetNavMesh();
+
+	if (!NavSys || !NavMesh)
+	{
+		PendingTiles.Reset();
+		PendingTileSet.Reset();
+		RebuildingAreas.Reset();
+		return;
+	}
+
+	// let the last batch finish building before sending more
+	if (NavSys->IsNavigationBuildInProgress())
+	{
+		LastRebuildActivityTime = Now;
+		return;
+	}
+
+	// everything was sent but no build started for a while, so the tiles didn't need one. There's nothing to re-path around
+	if (PendingTiles.IsEmpty())
+	{
+		if (Now - LastRebuildActivityTime > RebuildStartTimeout)
+		{
+			RebuildingAreas.Reset();
+		}
+
+		return;
+	}
+
+	const int32 NumTiles = FMath::Min(MaxTilesPerFrame, PendingTiles.Num());
+	const float TileSize = NavMesh->GetTileSizeUU();
+	const FBox NavBounds = NavMesh->GetBounds();
+
+	for (int32 i = 0; i < NumTiles; ++i)
+	{
+		const FIntPoint& Tile = PendingTiles[i];
+
+		// cover the full height of the navmesh, the debris may have fallen onto a lower floor
+		const FBox TileBox(FVector(Tile.X * TileSize, Tile.Y * TileSize, NavBounds.Min.Z), FVector((Tile.X + 1) * TileSize, (Tile.Y + 1) * TileSize, NavBounds.Max.Z));
+		NavSys->AddDirtyArea(TileBox.ExpandBy(FVector(-1.0, -1.0, 0.0)), ENavigationDirtyFlag::All);
+
+		PendingTileSet.Remove(Tile);
+	}
+
+	PendingTiles.RemoveAt(0, NumTiles, EAllowShrinking::No);
+	LastRebuildActivityTime = Now;
+
+	INC_DWORD_STAT_BY(STAT_BreakableNavTilesDirtied, NumTiles);
+}
+
+void UBreakableNavigationSubsystem::MarkAreaDirty(const FBox& Area)
+{
+	const ARecastNavMesh* NavMesh = GetNavMesh();
+
+	if (!Area.IsValid || !NavMesh)
+	{
+		return;
+	}
+
+	const float TileSize = NavMesh->GetTileSizeUU();
+
+	// queue every tile the area touches, once
+	const int32 MinX = FMath::FloorToInt(Area.Min.X / TileSize);
+	const int32 MinY = FMath::FloorToInt(Area.Min.Y / TileSize);
+	const int32 MaxX = FMath::FloorToInt(Area.Max.X / TileSize);
+	const int32 MaxY = FMath::FloorToInt(Area.Max.Y / TileSize);
+
+	for (int32 X = MinX; X <= MaxX; ++X)
+	{
+		for (int32 Y = MinY; Y <= MaxY; ++Y)
+		{
+			bool bAlreadyPending = false;
+			PendingTileSet.Add(FIntPoint(X, Y), &bAlreadyPending);
+
+			if (!bAlreadyPending)
+			{
+				PendingTiles.Add(FIntPoint(X, Y));
+			}
+		}
+	}
+
+	RebuildingAreas.Add(Area);
+}
+
+void UBreakableNavigationSubsystem::OnStructureDestruction(ABreakableStructure* Structure)
+{
+	if (IsValid(Structure) && Structure->GetWorld() == GetWorld() && Structure->IsCachingDestruction())
+	{
+		PendingSettles.Add({ Structure, GetWorld()->GetTimeSeconds() + CachedSettleTime });
+	}
+}
+
+void UBreakableNavigationSubsystem::OnDebrisSettled(ABreakableStructure* Structure, const FBox& Bounds)
+{
+	if (Bounds.IsValid)
+	{
+		MarkAreaDirty(Bounds.ExpandBy(FVector(DebrisSpread, DebrisSpread, 0.0f)));
+	}
+}
+
+void UBreakableNavigationSubsystem::OnNavigationGenerationFinished(ANavigationData* NavData)
+{
+	// wait until every queued tile has been rebuilt
+	if (!PendingTiles.IsEmpty() || RebuildingAreas.IsEmpty())
+	{
+		return;
+	}
+
+	// tell the NPCs heading through the rebuilt areas to find a new path, instead of having them check theirs every frame
+	for (FConstControllerIterator It = GetWorld()->GetControllerIterator(); It; ++It)
+	{
+		AAIController* Controller = Cast<AAIController>(It->Get());
+		UPathFollowingComponent* PathFollowing = Controller ? Controller->GetPathFollowingComponent() : nullptr;
+
+		if (!PathFollowing || PathFollowing->GetStatus() == EPathFollowingStatus::Idle)
+		{
+			continue;
+		}
+
+		const FNavPathSharedPtr Path = PathFollowing->GetPath();
+
+		if (!Path.IsValid())
+		{
+			continue;
+		}
+
+		// only the part of the path that's still ahead matters
+		const TArray<FNavPathPoint>& Points = Path->GetPathPoints();
+		bool bAffected = false;
+
+		for (int32 Index = FMath::Max(0, int32(PathFollowing->GetCurrentPathIndex())); Index + 1 < Points.Num() && !bAffected; ++Index)
+		{
+			const FVector Start = Points[Index].Location;
+			const FVector End = Points[Index + 1].Location;
+
+			for (const FBox& Area : RebuildingAreas)
+			{
+				if (FMath::LineBoxIntersection(Area, Start, End, End - Start))
+				{
+					bAffected = true;
+					break;
+				}
+			}
+		}
+
+		if (!bAffected)
+		{
+			continue;
+		}
+
+		// the navmesh may have already invalidated it through the changed tiles
+		if (Path->IsUpToDate())
+		{
+			Path->Invalidate();
+		}
+
+		INC_DWORD_STAT(STAT_BreakableNavRepaths);
+
+		OnRepath.Broadcast(Controller);
+	}
+
+	RebuildingAreas.Reset();
+}
+
+ARecastNavMesh* UBreakableNavigationSubsystem::GetNavMesh() const
+{
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+
+	return NavSys ? Cast<ARecastNavMesh>(NavSys->GetDefaultNavDataInstance(FNavigationSystem::DontCreate)) : nullptr;
+}
@@ -0,0 +1,113 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "BreakableNavigationSubsystem.generated.h"
+
+class ABreakableStructure;
+class AAIController;
+class ANavigationData;
+class ARecastNavMesh;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FBreakableNavigationRepathDelegate, AAIController*);
+
+/**
+ *  Keeps the navmesh up to date with breakable structure debris
+ *  Once a break's debris settles, the navmesh tiles it covers are marked dirty a few at a time,
+ *  waiting for each batch to finish building before sending the next, so a big collapse doesn't rebuild everything in one frame
+ *  When the rebuild is done, AI controllers whose path crosses the affected area get their path invalidated, which makes them re-path
+ *  Requires the navmesh to use dynamic runtime generation
+ */
+UCLASS(config=Game)
+class TEMPORALDASH_API UBreakableNavigationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Max number of navmesh tiles marked dirty per frame */
+	UPROPERTY(config, EditAnywhere, Category="Navigation", meta = (ClampMin = 1))
+	int32 MaxTilesPerFrame = 2;
+
+	/** How far debris is assumed to spread past the structure's bounds */
+	UPROPERTY(config, EditAnywhere, Category="Navigation", meta = (ClampMin = 0, Units = "cm"))
+	float DebrisSpread = 300.0f;
+
+	/** Structures playing back a cached fracture aren't tracked by the destruction budget, so they're considered settled after this long */
+	UPROPERTY(config, EditAnywhere, Category="Navigation", meta = (ClampMin = 0, Units = "s"))
+	float CachedSettleTime = 5.0f;
+
+	/** How long to wait for the last batch to start a build before giving up on the rebuilding areas. Dirty tiles outside the navmesh never start one.
+	 *  Must be well above the navigation system's dirty area update interval, or areas could be dropped before their build starts */
+	UPROPERTY(config, EditAnywhere, Category="Navigation", meta = (ClampMin = 0.1, Units = "s"))
+	float RebuildStartTimeout = 1.0f;
+
+	/** A cached break waiting to settle */
+	struct FPendingSettle
+	{
+		TWeakObjectPtr<ABreakableStructure> Structure;
+		double SettleTime = 0.0;
+	};
+
+	/** Cached breaks waiting to settle */
+	TArray<FPendingSettle> PendingSettles;
+
+	/** Navmesh tiles waiting to be marked dirty, in the order they were queued */
+	TArray<FIntPoint> PendingTiles;
+
+	/** Same as PendingTiles, for quick lookups */
+	TSet<FIntPoint> PendingTileSet;
+
+	/** Areas being rebuilt. Paths through them are invalidated once the rebuild is done */
+	TArray<FBox> RebuildingAreas;
+
+	/** World time a batch was last sent or a build was last seen running */
+	double LastRebuildActivityTime = 0.0;
+
+	/** Handles for the destruction delegates */
+	FDelegateHandle DestructionHandle;
+	FDelegateHandle SettledHandle;
+
+public:
+
+	/** Subsystem initialization */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Subsystem cleanup */
+	virtual void Deinitialize() override;
+
+	/** Listens for settled debris and finished navmesh builds */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Only game worlds rebuild the navmesh at runtime */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Marks the next batch of tiles dirty */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for the tickable */
+	virtual TStatId GetStatId() const override;
+
+	/** Queues the navmesh tiles covering an area for a rebuild */
+	void MarkAreaDirty(const FBox& Area);
+
+	/** Called for every AI controller that was told to re-path because of a rebuild */
+	FBreakableNavigationRepathDelegate OnRepath;
+
+protected:
+
+	/** Waits for cached fractures to settle */
+	void OnStructureDestruction(ABreakableStructure* Structure);
+
+	/** Queues the area covered by settled debris */
+	void OnDebrisSettled(ABreakableStructure* Structure, const FBox& Bounds);
+
+	/** Invalidates the paths through the rebuilt areas once every queued tile is done */
+	UFUNCTION()
+	void OnNavigationGenerationFinished(ANavigationData* NavData);
+
+	/** Returns the navmesh the debris is rebuilt into */
+	ARecastNavMesh* GetNavMesh() const;
+};
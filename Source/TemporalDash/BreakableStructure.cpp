@@ -1,6 +1,180 @@
 
 #include "BreakableStructure.h"
+#include "TemporalDash.h"
+#include "BreakableFieldSubsystem.h"
+#include "Chaos/CacheManagerActor.h"
+#include "Chaos/CacheCollection.h"
+#include "GameFramework/Pawn.h"
+#include "TimerManager.h"
 
 ABreakableStructure::ABreakableStructure() {
 
 }
+
+FBreakableStructureDestructionDelegate ABreakableStructure::OnAnyStructureDestruction;
+
+void ABreakableStructure::Destruct(const FVector& HitLocation, const FVector& HitDirection, float Strength) {
+    // the cache is already breaking the structure
+    if (IsCachingDestruction()) {
+        return;
+    }
+
+    // start the cache first so listeners can tell the solver won't run this fracture. Only the first break is cached, later hits land on broken pieces
+    const bool bUseCache = CacheMode != EBreakableCacheMode::Simulate && !bCacheUsed;
+    const FBreakableCacheVariant* Variant = bUseCache ? FindCacheVariant(HitLocation, HitDirection) : nullptr;
+    const bool bCached = Variant && StartCache(*Variant);
+
+    // let native systems know before the geometry breaks
+    OnAnyStructureDestruction.Broadcast(this);
+
+    // a played back fracture doesn't need the Blueprint fields. Recording still does, that's what gets recorded
+    if (bCached && CacheMode == EBreakableCacheMode::Playback) {
+        return;
+    }
+
+    // native fields are merged with the rest of this frame's hits
+    if (bUseNativeFields) {
+        if (UBreakableFieldSubsystem* Fields = GetWorld()->GetSubsystem<UBreakableFieldSubsystem>()) {
+            Fields->QueueImpact(HitLocation, FieldStrain * Strength, FieldRadius * Strength, FieldSpeed * Strength);
+            return;
+        }
+    }
+
+    OnDestruction(HitLocation);
+}
+
+bool ABreakableStructure::IsCachingDestruction() const {
+    return CacheManager && CacheManager->CacheMode != ECacheMode::None;
+}
+
+const FBreakableCacheVariant* ABreakableStructure::FindCacheVariant(const FVector& HitLocation, const FVector& HitDirection) const {
+    // compare in actor space, that's where the variants are authored
+    const FTransform& ActorTransform = GetActorTransform();
+    const FVector LocalLocation = ActorTransform.InverseTransformPosition(HitLocation);
+    const FVector LocalDirection = ActorTransform.InverseTransformVectorNoScale(HitDirection).GetSafeNormal();
+
+    const FBreakableCacheVariant* BestVariant = nullptr;
+    float BestScore = TNumericLimits<float>::Max();
+
+    for (const FBreakableCacheVariant& Variant : CacheVariants) {
+        if (!Variant.Cache) {
+            continue;
+        }
+
+        // direction mismatch goes from 0 to 2, so scale the distance to match
+        const float DirectionScore = 1.0f - (LocalDirection | Variant.HitDirection.GetSafeNormal());
+        const float LocationScore = 2.0f * FVector::Dist(LocalLocation, Variant.HitLocation) / VariantLocationScale;
+
+        if (DirectionScore + LocationScore < BestScore) {
+            BestScore = DirectionScore + LocationScore;
+            BestVariant = &Variant;
+        }
+    }
+
+    return BestVariant;
+}
+
+bool ABreakableStructure::StartCache(const FBreakableCacheVariant& Variant) {
+    UGeometryCollectionComponent* GeometryCollection = FindComponentByClass<UGeometryCollectionComponent>();
+
+    if (!GeometryCollection) {
+        return false;
+    }
+
+    // recordings are saved from the editor, so packaged builds just simulate
+    const bool bRecord = CacheMode == EBreakableCacheMode::Record;
+
+    if (bRecord && !GetWorld()->IsPlayInEditor()) {
+        return false;
+    }
+
+    // the player can only play back, which keeps recording out of shipped levels
+    UClass* ManagerClass = bRecord ? AChaosCacheManager::StaticClass() : AChaosCachePlayer::StaticClass();
+    AChaosCacheManager* Manager = GetWorld()->SpawnActorDeferred<AChaosCacheManager>(ManagerClass, GetActorTransform(), this);
+
+    if (!Manager) {
+        return false;
+    }
+
+    // start right away, the cache is named after the component so recording and playback line up
+    Manager->CacheCollection = Variant.Cache;
+    Manager->StartMode = EStartMode::Timed;
+    Manager->StartTime = 0.0f;
+    Manager->FindOrAddObservedComponent(GeometryCollection, GeometryCollection->GetFName(), bRecord);
+    Manager->SetAllMode(bRecord ? ECacheMode::Record : ECacheMode::Play);
+    Manager->FinishSpawning(GetActorTransform());
+
+    if (IsValid(CacheManager)) {
+        CacheManager->Destroy();
+    }
+
+    CacheManager = Manager;
+    bCacheUsed = true;
+
+    if (bRecord) {
+        GetWorldTimerManager().SetTimer(CacheTimer, this, &ABreakableStructure::OnRecordingFinished, RecordDuration, false);
+    } else {
+        // played back pieces are kinematic, so we find out about players bumping into them through hits
+        GeometryCollection->SetNotifyRigidBodyCollision(true);
+        GeometryCollection->OnComponentHit.AddUniqueDynamic(this, &ABreakableStructure::OnCachedPiecesHit);
+
+        // once the recording runs out, the pieces go back to the solver
+        const float PlaybackDuration = Variant.Cache->GetMaxDuration();
+        GetWorldTimerManager().SetTimer(CacheTimer, this, &ABreakableStructure::ReleaseCachedPieces, PlaybackDuration > 0.0f ? PlaybackDuration : RecordDuration, false);
+    }
+
+    return true;
+}
+
+void ABreakableStructure::OnRecordingFinished() {
+    if (!CacheManager) {
+        return;
+    }
+
+    UE_LOG(LogTemporalDash, Display, TEXT("Recorded the fracture of %s into %s. Save the cache collection to keep it"), *GetName(), *GetNameSafe(CacheManager->CacheCollection));
+
+    // ending play on the manager flushes the recording into the collection
+    CacheManager->Destroy();
+    CacheManager = nullptr;
+}
+
+void ABreakableStructure::OnCachedPiecesHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit) {
+    const APawn* Pawn = Cast<APawn>(OtherActor);
+
+    if (!Pawn || !Pawn->IsPlayerControlled() || !IsCachingDestruction()) {
+        return;
+    }
+
+    ReleaseCachedPieces();
+}
+
+void ABreakableStructure::ReleaseCachedPieces() {
+    GetWorldTimerManager().ClearTimer(CacheTimer);
+
+    // stop driving the pieces and let the solver take them from where the cache left them
+    if (IsCachingDestruction()) {
+        CacheManager->SetAllMode(ECacheMode::None);
+    }
+
+    if (IsValid(CacheManager)) {
+        CacheManager->Destroy();
+    }
+
+    CacheManager = nullptr;
+
+    if (UGeometryCollectionComponent* GeometryCollection = FindComponentByClass<UGeometryCollectionComponent>()) {
+        GeometryCollection->OnComponentHit.RemoveDynamic(this, &ABreakableStructure::OnCachedPiecesHit);
+    }
+}
+
+void ABreakableStructure::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+    GetWorldTimerManager().ClearTimer(CacheTimer);
+
+    if (IsValid(CacheManager)) {
+        CacheManager->Destroy();
+    }
+
+    CacheManager = nullptr;
+
+    Super::EndPlay(EndPlayReason);
+}
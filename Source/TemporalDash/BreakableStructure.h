@@ -10,6 +10,41 @@
 #include "Field/FieldSystemTypes.h"
 #include "BreakableStructure.generated.h"
 
+class ABreakableStructure;
+class AChaosCacheManager;
+class UChaosCacheCollection;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FBreakableStructureDestructionDelegate, ABreakableStructure*);
+
+// How a structure breaks
+UENUM(BlueprintType)
+enum class EBreakableCacheMode : uint8 {
+    // Runs the fracture in the solver every time
+    Simulate,
+    // Runs the fracture in the solver and records it into the closest cache variant. Play in editor, then save the cache collections
+    Record,
+    // Plays back the closest recorded variant and only hands the pieces to the solver once a player touches them
+    Playback
+};
+
+// A pre-recorded fracture for hits from around one direction and location
+USTRUCT(BlueprintType)
+struct FBreakableCacheVariant {
+    GENERATED_BODY()
+
+    // Hit direction this variant stands for, in actor space
+    UPROPERTY(EditAnywhere, Category = "Chaos|Cache")
+    FVector HitDirection = FVector::ForwardVector;
+
+    // Hit location this variant stands for, in actor space
+    UPROPERTY(EditAnywhere, Category = "Chaos|Cache")
+    FVector HitLocation = FVector::ZeroVector;
+
+    // Recorded fracture
+    UPROPERTY(EditAnywhere, Category = "Chaos|Cache")
+    TObjectPtr<UChaosCacheCollection> Cache;
+};
+
 UCLASS()
 class TEMPORALDASH_API ABreakableStructure : public AActor
 {
@@ -21,4 +56,76 @@ public:
     // Call this from your Weapon/Projectile class
     UFUNCTION(BlueprintImplementableEvent, Category = "Chaos")
     void OnDestruction(const FVector& HitLocation);
+
+    // Notifies native listeners and breaks the structure at the hit location, either through the fields, the Blueprint destruction or a recorded variant
+    void Destruct(const FVector& HitLocation, const FVector& HitDirection = FVector::ZeroVector, float Strength = 1.0f);
+
+    // True while the fracture is being recorded or played back from a cache, so the solver isn't running it
+    bool IsCachingDestruction() const;
+
+    // Called when any breakable structure in any world gets destructed. Listeners should filter by world
+    static FBreakableStructureDestructionDelegate OnAnyStructureDestruction;
+
+protected:
+    // Applies the breaking fields natively, batched with the other hits this frame, instead of calling OnDestruction
+    // Leave this off for Blueprints that still spawn their own fields
+    UPROPERTY(EditAnywhere, Category = "Chaos|Fields")
+    bool bUseNativeFields = false;
+
+    // Strain at the center of a full strength hit. Clusters break where it's over their damage threshold
+    UPROPERTY(EditAnywhere, Category = "Chaos|Fields", meta = (ClampMin = 0, EditCondition = "bUseNativeFields"))
+    float FieldStrain = 500000.0f;
+
+    // Range of a full strength hit
+    UPROPERTY(EditAnywhere, Category = "Chaos|Fields", meta = (ClampMin = 0, Units = "cm", EditCondition = "bUseNativeFields"))
+    float FieldRadius = 200.0f;
+
+    // Speed the broken pieces are pushed away with by a full strength hit
+    UPROPERTY(EditAnywhere, Category = "Chaos|Fields", meta = (ClampMin = 0, Units = "cm/s", EditCondition = "bUseNativeFields"))
+    float FieldSpeed = 500.0f;
+
+    // Set pieces can play back a recorded fracture instead of simulating it
+    UPROPERTY(EditAnywhere, Category = "Chaos|Cache")
+    EBreakableCacheMode CacheMode = EBreakableCacheMode::Simulate;
+
+    // Recorded fractures. The one closest to the hit is used
+    UPROPERTY(EditAnywhere, Category = "Chaos|Cache")
+    TArray<FBreakableCacheVariant> CacheVariants;
+
+    // Hit location distance that counts as much as opposite hit directions when picking a variant
+    UPROPERTY(EditAnywhere, Category = "Chaos|Cache", meta = (ClampMin = 1, Units = "cm"))
+    float VariantLocationScale = 200.0f;
+
+    // How long the fracture is recorded for
+    UPROPERTY(EditAnywhere, Category = "Chaos|Cache", meta = (ClampMin = 0.1, Units = "s"))
+    float RecordDuration = 5.0f;
+
+    // Records or plays back the fracture
+    UPROPERTY(Transient)
+    TObjectPtr<AChaosCacheManager> CacheManager;
+
+    // Set once a fracture was recorded or played back. The pieces are already broken, so later hits are simulated
+    bool bCacheUsed = false;
+
+    // Ends the recording or the playback
+    FTimerHandle CacheTimer;
+
+    // Returns the variant closest to a hit, if any
+    const FBreakableCacheVariant* FindCacheVariant(const FVector& HitLocation, const FVector& HitDirection) const;
+
+    // Spawns a cache manager that records or plays back a variant on our geometry collection
+    bool StartCache(const FBreakableCacheVariant& Variant);
+
+    // Stops recording so the cache collection can be saved
+    void OnRecordingFinished();
+
+    // Hands the played back pieces to the solver once a player touches them
+    UFUNCTION()
+    void OnCachedPiecesHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
+
+    // Stops the playback and hands the pieces to the solver, so later hits simulate on the broken pieces
+    void ReleaseCachedPieces();
+
+    // Cleans up the cache manager
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 };
@@ -15,13 +15,16 @@ public class TemporalDash : ModuleRules
 			"InputCore",
 			"EnhancedInput",
 			"AIModule",
+			"NavigationSystem",
 			"StateTreeModule",
 			"GameplayStateTreeModule",
 			"UMG",
 			"Slate",
 			"GeometryCollectionEngine",
 			"FieldSystemEngine",
-			"ChaosSolverEngine"
+			"ChaosSolverEngine",
+			"ChaosCaching",
+			"AnimationBudgetAllocator"
 		});
 
 		PrivateDependencyModuleNames.AddRange(new string[] { });
@@ -29,6 +32,7 @@ public class TemporalDash : ModuleRules
 		PublicIncludePaths.AddRange(new string[] {
 			"TemporalDash",
 			"TemporalDash/Variant_Horror",
+			"TemporalDash/Variant_Horror/AI",
 			"TemporalDash/Variant_Horror/UI",
 			"TemporalDash/Variant_Shooter",
 			"TemporalDash/Variant_Shooter/AI",
@@ -3,6 +3,19 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
 
 /** Main log category used across the project */
-DECLARE_LOG_CATEGORY_EXTERN(LogTemporalDash, Log, All);
\ No newline at end of file
+DECLARE_LOG_CATEGORY_EXTERN(LogTemporalDash, Log, All);
+
+/** Stat group for character traversal and streaming. Use "stat TemporalDash" to display */
+DECLARE_STATS_GROUP(TEXT("TemporalDash"), STATGROUP_TemporalDash, STATCAT_Advanced);
+
+/** Stat group for shooter NPC AI. Use "stat ShooterAI" to display */
+DECLARE_STATS_GROUP(TEXT("ShooterAI"), STATGROUP_ShooterAI, STATCAT_Advanced);
+
+/** Stat group for the horror monster AI. Use "stat HorrorAI" to display */
+DECLARE_STATS_GROUP(TEXT("HorrorAI"), STATGROUP_HorrorAI, STATCAT_Advanced);
+
+/** Stat group for breakable structure debris. Use "stat BreakableDestruction" to display */
+DECLARE_STATS_GROUP(TEXT("BreakableDestruction"), STATGROUP_BreakableDestruction, STATCAT_Advanced);
@@ -0,0 +1,220 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "TemporalDashAbilityResourceComponent.h"
+#include "Engine/World.h"
+
+UTemporalDashAbilityResourceComponent::UTemporalDashAbilityResourceComponent()
+{
+	// charges are checked on use, so this never needs to tick
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UTemporalDashAbilityResourceComponent::RegisterAbility(FName Name, int32 MaxCharges, float Cooldown)
+{
+	MaxCharges = FMath::Max(MaxCharges, 1);
+	Cooldown = FMath::Max(Cooldown, 0.0f);
+
+	// look for an existing registration
+	const int32 AbilityIndex = Abilities.IndexOfByPredicate([Name](const FTemporalDashAbilitySlot& Ability) { return Ability.Name == Name; });
+
+	if (AbilityIndex == INDEX_NONE)
+	{
+		// add the ability and its charges at the end of the arrays, all ready to use
+		FTemporalDashAbilitySlot& Ability = Abilities.AddDefaulted_GetRef();
+		Ability.Name = Name;
+		Ability.FirstCharge = ChargeReadyTimes.Num();
+		Ability.NumCharges = MaxCharges;
+		Ability.Cooldown = Cooldown;
+
+		ChargeReadyTimes.AddZeroed(MaxCharges);
+		return;
+	}
+
+	FTemporalDashAbilitySlot& Ability = Abilities[AbilityIndex];
+	Ability.Cooldown = Cooldown;
+
+	// resize the charge range in place and shift every ability stored after it
+	const int32 ChargeDelta = MaxCharges - Ability.NumCharges;
+
+	if (ChargeDelta > 0)
+	{
+		ChargeReadyTimes.InsertZeroed(Ability.FirstCharge + Ability.NumCharges, ChargeDelta);
+
+	} else if (ChargeDelta < 0) {
+
+		ChargeReadyTimes.RemoveAt(Ability.FirstCharge + MaxCharges, -ChargeDelta);
+	}
+
+	Ability.NumCharges = MaxCharges;
+
+	for (int32 i = AbilityIndex + 1; i < Abilities.Num(); ++i)
+	{
+		Abilities[i].FirstCharge += ChargeDelta;
+	}
+}
+
+bool UTemporalDashAbilityResourceComponent::TryConsume(FName Name)
+{
+	const FTemporalDashAbilitySlot* Ability = FindAbility(Name);
+
+	// unregistered abilities aren't limited
+	if (!Ability)
+	{
+		return true;
+	}
+
+	const double Now = GetNow();
+
+	// find a ready charge, and the last charge in the recharge queue
+	int32 ReadyCharge = INDEX_NONE;
+	double LastReadyTime = Now;
+
+	for (int32 i = Ability->FirstCharge; i < Ability->FirstCharge + Ability->NumCharges; ++i)
+	{
+		const double ReadyTime = ChargeReadyTimes[i];
+
+		if (ReadyTime <= Now)
+		{
+			ReadyCharge = i;
+
+		} else {
+
+			LastReadyTime = FMath::Max(LastReadyTime, ReadyTime);
+		}
+	}
+
+	if (ReadyCharge == INDEX_NONE)
+	{
+		return false;
+	}
+
+	// the spent charge starts recharging once the charges ahead of it are done
+	ChargeReadyTimes[ReadyCharge] = LastReadyTime + Ability->Cooldown;
+
+	return true;
+}
+
+bool UTemporalDashAbilityResourceComponent::HasCharge(FName Name) const
+{
+	const FTemporalDashAbilitySlot* Ability = FindAbility(Name);
+
+	if (!Ability)
+	{
+		return true;
+	}
+
+	const double Now = GetNow();
+
+	for (int32 i = Ability->FirstCharge; i < Ability->FirstCharge + Ability->NumCharges; ++i)
+	{
+		if (ChargeReadyTimes[i] <= Now)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int32 UTemporalDashAbilityResourceComponent::GetAvailableCharges(FName Name) const
+{
+	const FTemporalDashAbilitySlot* Ability = FindAbility(Name);
+
+	if (!Ability)
+	{
+		return 0;
+	}
+
+	const double Now = GetNow();
+	int32 Available = 0;
+
+	for (int32 i = Ability->FirstCharge; i < Ability->FirstCharge + Ability->NumCharges; ++i)
+	{
+		if (ChargeReadyTimes[i] <= Now)
+		{
+			++Available;
+		}
+	}
+
+	return Available;
+}
+
+int32 UTemporalDashAbilityResourceComponent::GetMaxCharges(FName Name) const
+{
+	const FTemporalDashAbilitySlot* Ability = FindAbility(Name);
+
+	return Ability ? Ability->NumCharges : 0;
+}
+
+float UTemporalDashAbilityResourceComponent::GetRemainingCooldown(FName Name) const
+{
+	const FTemporalDashAbilitySlot* Ability = FindAbility(Name);
+
+	if (!Ability)
+	{
+		return 0.0f;
+	}
+
+	const double Now = GetNow();
+	const double NextReadyTime = GetNextChargeReadyTime(*Ability, Now);
+
+	return NextReadyTime > Now ? static_cast<float>(NextReadyTime - Now) : 0.0f;
+}
+
+float UTemporalDashAbilityResourceComponent::GetCooldownProgress(FName Name) const
+{
+	const FTemporalDashAbilitySlot* Ability = FindAbility(Name);
+
+	if (!Ability || Ability->Cooldown <= 0.0f)
+	{
+		return 1.0f;
+	}
+
+	const double Now = GetNow();
+	const double NextReadyTime = GetNextChargeReadyTime(*Ability, Now);
+
+	if (NextReadyTime <= Now)
+	{
+		return 1.0f;
+	}
+
+	return FMath::Clamp(1.0f - static_cast<float>(NextReadyTime - Now) / Ability->Cooldown, 0.0f, 1.0f);
+}
+
+void UTemporalDashAbilityResourceComponent::ResetAllCharges()
+{
+	for (double& ReadyTime : ChargeReadyTimes)
+	{
+		ReadyTime = 0.0;
+	}
+}
+
+const FTemporalDashAbilitySlot* UTemporalDashAbilityResourceComponent::FindAbility(FName Name) const
+{
+	// there's only a handful of abilities, so a linear search beats hashing
+	return Abilities.FindByPredicate([Name](const FTemporalDashAbilitySlot& Ability) { return Ability.Name == Name; });
+}
+
+double UTemporalDashAbilityResourceComponent::GetNow() const
+{
+	const UWorld* World = GetWorld();
+	return World ? World->GetTimeSeconds() : 0.0;
+}
+
+double UTemporalDashAbilityResourceComponent::GetNextChargeReadyTime(const FTemporalDashAbilitySlot& Ability, double Now) const
+{
+	double NextReadyTime = 0.0;
+
+	for (int32 i = Ability.FirstCharge; i < Ability.FirstCharge + Ability.NumCharges; ++i)
+	{
+		const double ReadyTime = ChargeReadyTimes[i];
+
+		if (ReadyTime > Now && (NextReadyTime <= 0.0 || ReadyTime < NextReadyTime))
+		{
+			NextReadyTime = ReadyTime;
+		}
+	}
+
+	return NextReadyTime;
+}
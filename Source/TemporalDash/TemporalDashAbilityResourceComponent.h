@@ -0,0 +1,100 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "TemporalDashAbilityResourceComponent.generated.h"
+
+/**
+ *  Charge and cooldown bookkeeping for a single registered ability
+ *  The charges themselves live in the owning component's timestamp array
+ */
+struct FTemporalDashAbilitySlot
+{
+	/** Name the ability was registered with */
+	FName Name;
+
+	/** Index of this ability's first charge in the timestamp array */
+	int32 FirstCharge = 0;
+
+	/** Number of charges owned by this ability */
+	int32 NumCharges = 1;
+
+	/** Time it takes a single charge to recharge */
+	float Cooldown = 0.0f;
+};
+
+/**
+ *  Tracks charges and cooldowns for the owner's abilities (dash, hook, skills...)
+ *  Each charge is stored as the world time it becomes ready again, all packed in a single array
+ *  Charges are only checked when an ability is used or queried, so cooldowns don't need any timers or ticking
+ *  Charges recharge one after the other, so spending several charges queues up their cooldowns
+ */
+UCLASS(ClassGroup=(TemporalDash), meta=(BlueprintSpawnableComponent))
+class TEMPORALDASH_API UTemporalDashAbilityResourceComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Registered abilities */
+	TArray<FTemporalDashAbilitySlot, TInlineAllocator<4>> Abilities;
+
+	/** World time each charge becomes ready, grouped per ability */
+	TArray<double, TInlineAllocator<8>> ChargeReadyTimes;
+
+public:
+
+	/** Constructor */
+	UTemporalDashAbilityResourceComponent();
+
+	/**
+	 *  Registers an ability, or updates its charges and cooldown if it's already registered
+	 *  Re-registering keeps any cooldowns already in progress, so abilities can't be reset by re-adding them
+	 *  @param Name name used to refer to the ability
+	 *  @param MaxCharges number of times the ability can be used back to back
+	 *  @param Cooldown time it takes to recharge a single charge
+	 */
+	UFUNCTION(BlueprintCallable, Category="Abilities")
+	void RegisterAbility(FName Name, int32 MaxCharges, float Cooldown);
+
+	/** Spends a charge of the ability. Returns false if it has no charges ready */
+	UFUNCTION(BlueprintCallable, Category="Abilities")
+	bool TryConsume(FName Name);
+
+	/** Returns true if the ability has at least one charge ready. Unregistered abilities are always ready */
+	UFUNCTION(BlueprintPure, Category="Abilities")
+	bool HasCharge(FName Name) const;
+
+	/** Returns the number of charges ready to be used */
+	UFUNCTION(BlueprintPure, Category="Abilities")
+	int32 GetAvailableCharges(FName Name) const;
+
+	/** Returns the max number of charges for the ability */
+	UFUNCTION(BlueprintPure, Category="Abilities")
+	int32 GetMaxCharges(FName Name) const;
+
+	/** Returns the time until the next charge is ready, or zero if all charges are ready */
+	UFUNCTION(BlueprintPure, Category="Abilities")
+	float GetRemainingCooldown(FName Name) const;
+
+	/** Returns the recharge progress (0-1) of the next charge, or one if all charges are ready */
+	UFUNCTION(BlueprintPure, Category="Abilities")
+	float GetCooldownProgress(FName Name) const;
+
+	/** Makes all charges of all abilities ready right away */
+	UFUNCTION(BlueprintCallable, Category="Abilities")
+	void ResetAllCharges();
+
+protected:
+
+	/** Finds a registered ability. Returns nullptr if not found */
+	const FTemporalDashAbilitySlot* FindAbility(FName Name) const;
+
+	/** Returns the current world time used for the charge timestamps */
+	double GetNow() const;
+
+	/** Returns the ready time of the charge that will recharge next, or zero if all charges are ready */
+	double GetNextChargeReadyTime(const FTemporalDashAbilitySlot& Ability, double Now) const;
+};
@@ -8,12 +8,22 @@
 #include "EnhancedInputComponent.h"
 #include "InputActionValue.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "TemporalDashStreamingSourceComponent.h"
+#include "TemporalDashAbilityResourceComponent.h"
+#include "TemporalDashTraversalLink.h"
 #include "TemporalDash.h"
 
-ATemporalDashCharacter::ATemporalDashCharacter()
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Idle Characters (Ticks Avoided)"), STAT_TemporalDashIdleCharacters, STATGROUP_TemporalDash);
+
+const FName ATemporalDashCharacter::DashAbilityName = FName("Dash");
+const FName ATemporalDashCharacter::HookAbilityName = FName("Hook");
+
+ATemporalDashCharacter::ATemporalDashCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
 {
-	// Enable Tick for dash linear decay
+	// Tick drives the dash and hook updates. It's only enabled while one of them is active, so idle characters and NPCs don't tick
 	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
 
 	// Set size for collision capsule
 	GetCapsuleComponent()->InitCapsuleSize(55.f, 96.0f);
@@ -36,6 +46,12 @@ ATemporalDashCharacter::ATemporalDashCharacter()
 	FirstPersonCameraComponent->FirstPersonFieldOfView = 70.0f;
 	FirstPersonCameraComponent->FirstPersonScale = 0.6f;
 
+	// Create the predictive streaming source
+	StreamingSource = CreateDefaultSubobject<UTemporalDashStreamingSourceComponent>(TEXT("Streaming Source"));
+
+	// Create the ability charges and cooldowns tracker
+	AbilityResources = CreateDefaultSubobject<UTemporalDashAbilityResourceComponent>(TEXT("Ability Resources"));
+
 	// configure the character comps
 	GetMesh()->SetOwnerNoSee(true);
 	GetMesh()->FirstPersonPrimitiveType = EFirstPersonPrimitiveType::WorldSpaceRepresentation;
@@ -75,6 +91,95 @@ void ATemporalDashCharacter::SetupPlayerInputComponent(UInputComponent* PlayerIn
 }
 
 
+void ATemporalDashCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// don't leave a link waiting on us
+	FinishPendingTraversal();
+
+	// stop counting this character as idle
+	if (bTickIdle)
+	{
+		bTickIdle = false;
+		DEC_DWORD_STAT(STAT_TemporalDashIdleCharacters);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ATemporalDashCharacter::SetPendingTraversal(ATemporalDashTraversalLink* Link, const FVector& Destination)
+{
+	// release any link we were still waiting on
+	FinishPendingTraversal();
+
+	PendingTraversalLink = Link;
+	PendingTraversalDestination = Destination;
+}
+
+void ATemporalDashCharacter::FinishPendingTraversal()
+{
+	if (ATemporalDashTraversalLink* Link = PendingTraversalLink.Get())
+	{
+		PendingTraversalLink = nullptr;
+		Link->FinishTraversal(this);
+	}
+}
+
+void ATemporalDashCharacter::ResetTraversalState()
+{
+	// drop the buffer first, ending a dash or hook would run what's in it
+	BufferedInputs.Reset();
+
+	// restores friction and gravity
+	if (bIsDashing)
+	{
+		EndDash();
+	}
+
+	if (bIsHooked)
+	{
+		EndHook();
+	}
+
+	FinishPendingTraversal();
+
+	JumpCount = 0;
+
+	UpdateTickEnabled();
+}
+
+void ATemporalDashCharacter::UpdateTickEnabled()
+{
+	const bool bNeedsTick = bHasBlueprintTick || bIsDashing || bIsHooked || !BufferedInputs.IsEmpty();
+
+	if (IsActorTickEnabled() != bNeedsTick)
+	{
+		SetActorTickEnabled(bNeedsTick);
+	}
+
+	// update the idle character count
+	if (bTickIdle == bNeedsTick)
+	{
+		bTickIdle = !bNeedsTick;
+
+		if (bTickIdle)
+		{
+			INC_DWORD_STAT(STAT_TemporalDashIdleCharacters);
+
+		} else {
+
+			DEC_DWORD_STAT(STAT_TemporalDashIdleCharacters);
+		}
+	}
+}
+
+void ATemporalDashCharacter::NotifyControllerChanged()
+{
+	Super::NotifyControllerChanged();
+
+	// only players stream ahead, so avoid ticking the stall checks on NPCs
+	StreamingSource->SetComponentTickEnabled(IsPlayerControlled());
+}
+
 void ATemporalDashCharacter::MoveInput(const FInputActionValue& Value)
 {
 	// get the Vector2D move axis
@@ -120,6 +225,32 @@ void ATemporalDashCharacter::DoMove(float Right, float Forward)
 
 void ATemporalDashCharacter::DoJumpStart()
 {
+	const double PressRealTime = FPlatformTime::Seconds();
+
+	// jump right away if we can, otherwise hold on to the press until we land
+	if (TryJump())
+	{
+		RecordInputLatency(PressRealTime);
+
+	} else {
+
+		BufferInput(ETemporalDashBufferedAction::Jump, PressRealTime);
+	}
+}
+
+bool ATemporalDashCharacter::IsJumpAllowed() const
+{
+	// we can always jump from the ground, or mid-air if we still have jumps left
+	return GetCharacterMovement()->IsMovingOnGround() || JumpCount < MaxJumpCount;
+}
+
+bool ATemporalDashCharacter::TryJump()
+{
+	if (!IsJumpAllowed())
+	{
+		return false;
+	}
+
 	// If we're on the ground, perform the normal jump and count it
 	if (GetCharacterMovement()->IsMovingOnGround())
 	{
@@ -128,19 +259,17 @@ void ATemporalDashCharacter::DoJumpStart()
 	}
 	else
 	{
-		// If we still have jumps left, perform an in-air jump by applying an upward launch
-		if (JumpCount < MaxJumpCount)
-		{
-			// Optionally zero any existing Z velocity to make jumps consistent
-			FVector CurrentVel = GetCharacterMovement()->Velocity;
-			CurrentVel.Z = 0.f;
-			GetCharacterMovement()->Velocity = CurrentVel;
-
-			// Launch upward for the second jump
-			LaunchCharacter(FVector(0.f, 0.f, SecondJumpStrength), false, true);
-			JumpCount++;
-		}
+		// Optionally zero any existing Z velocity to make jumps consistent
+		FVector CurrentVel = GetCharacterMovement()->Velocity;
+		CurrentVel.Z = 0.f;
+		GetCharacterMovement()->Velocity = CurrentVel;
+
+		// Launch upward for the extra jump
+		LaunchCharacter(FVector(0.f, 0.f, SecondJumpStrength), false, true);
+		JumpCount++;
 	}
+
+	return true;
 }
 
 void ATemporalDashCharacter::DoJumpEnd()
@@ -155,4 +284,7 @@ void ATemporalDashCharacter::Landed(const FHitResult& Hit)
 
 	// Reset jump counter when touching the ground again
 	JumpCount = 0;
+
+	// run any jump that was pressed just before landing
+	ProcessBufferedInputs();
 }
@@ -11,10 +11,37 @@ class UInputComponent;
 class USkeletalMeshComponent;
 class UCameraComponent;
 class UInputAction;
+class UTemporalDashStreamingSourceComponent;
+class UTemporalDashAbilityResourceComponent;
+class ATemporalDashTraversalLink;
 struct FInputActionValue;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogTemplateCharacter, Log, All);
 
+/** Actions that can be held in the input buffer until they become legal */
+enum class ETemporalDashBufferedAction : uint8
+{
+	Jump,
+	Dash,
+	Hook
+};
+
+/** A timestamped action press waiting to be executed */
+struct FTemporalDashBufferedInput
+{
+	/** Buffered action */
+	ETemporalDashBufferedAction Action = ETemporalDashBufferedAction::Jump;
+
+	/** World time the input was pressed at */
+	double Timestamp = 0.0;
+
+	/** Platform time the input was pressed at, for latency tracking. World time only advances once per frame */
+	double PressRealTime = 0.0;
+
+	/** Direction captured at press time, used by the dash */
+	FVector Direction = FVector::ZeroVector;
+};
+
 /**
  *  A basic first person character
  */
@@ -31,6 +58,14 @@ class ATemporalDashCharacter : public ACharacter
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
 	UCameraComponent* FirstPersonCameraComponent;
 
+	/** Streams World Partition cells ahead of fast dash and hook traversal */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
+	UTemporalDashStreamingSourceComponent* StreamingSource;
+
+	/** Charges and cooldowns for dash, hook and skills */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
+	UTemporalDashAbilityResourceComponent* AbilityResources;
+
 protected:
 
 	/** Jump Input Action */
@@ -58,7 +93,14 @@ protected:
 	UInputAction* Hook;
 
 public:
-	ATemporalDashCharacter();
+
+	/** Ability resource name used by the dash */
+	static const FName DashAbilityName;
+
+	/** Ability resource name used by the hook */
+	static const FName HookAbilityName;
+
+	ATemporalDashCharacter(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
 
 protected:
 
@@ -84,6 +126,12 @@ protected:
 	UFUNCTION(BlueprintCallable, Category="Input")
 	virtual void DoJumpEnd();
 
+	/** Returns true if a ground or mid-air jump can be performed right now */
+	bool IsJumpAllowed() const;
+
+	/** Performs a ground or mid-air jump if allowed. Returns false if the jump couldn't be performed */
+	bool TryJump();
+
 	// --- Dash support ---
 	/** Distance the dash should cover (used together with Duration to compute speed) */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dash", meta=(AllowPrivateAccess="true", ClampMin = "0.0"))
@@ -93,30 +141,51 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dash", meta=(AllowPrivateAccess="true", ClampMin = "0.01"))
 	float DashDuration = 0.2f;
 
-	/** Cooldown between dashes (seconds) */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dash", meta=(AllowPrivateAccess="true", ClampMin = "0.0"))
+	/** Time it takes to recharge a single dash charge (seconds) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, BlueprintSetter = SetDashCooldown, Category = "Dash", meta=(AllowPrivateAccess="true", ClampMin = "0.0"))
 	float DashCooldown = 1.0f;
 
+	/** Number of dashes that can be chained before waiting for the cooldown */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, BlueprintSetter = SetDashCharges, Category = "Dash", meta=(AllowPrivateAccess="true", ClampMin = "1", ClampMax = "5"))
+	int32 DashCharges = 1;
+
 	/** Whether the character is currently dashing */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Dash", meta=(AllowPrivateAccess="true"))
 	bool bIsDashing = false;
 
-	// Timer handle for dash cooldown
-	FTimerHandle DashCooldownHandle;
-
 	// Runtime dash state for smooth velocity interpolation
 	FVector DashDirection;
 	float DashTimeRemaining = 0.f;
 	float DashInitialSpeed = 0.f;
 	FVector DashTargetVelocity;
 
+	// Extra velocity making up the distance a back-dated dash skipped, and how much longer it's applied for
+	FVector DashCatchUpVelocity = FVector::ZeroVector;
+	float DashCatchUpTimeRemaining = 0.f;
+
+	// Catch-up velocity added last frame, kept out of the dash interpolation
+	FVector DashAppliedCatchUp = FVector::ZeroVector;
+
 	// Input handler for the dash (bind to ETriggerEvent::Started)
 	void DoDashStart(const FInputActionValue& ActionValue);
 
+	/** Returns true if a new dash can be started right now */
+	bool IsDashAllowed() const;
+
+	/** Starts a dash pressed at the given world time if allowed. Returns false if the dash couldn't be performed */
+	bool TryDash(const FVector& Direction, double PressTimestamp);
+
 	// Internal helpers
-	void PerformDash(const FVector& Direction);
+	/** Starts a dash. Backdate is made up over the first frames of the dash, covering the distance it would have already travelled */
+	void PerformDash(const FVector& Direction, float Backdate = 0.f);
+
+	/** Returns the dash speed scale (0-1) at the given dash progress (0-1) */
+	static float GetDashSpeedScale(float Alpha);
+
+	/** Returns the fraction of DashDistance covered by the dash profile up to the given dash progress (0-1) */
+	static float GetDashDistanceScale(float Alpha);
+
 	void EndDash();
-	void ResetDashCooldown();
 
 
 	// --- Hook Support ---
@@ -140,6 +209,10 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hook", meta=(AllowPrivateAccess="true", ClampMin = "0.0"))
 	float HookMaxVelocity = 4000.0f;
 
+	/** Time after a successful hook before the next one can be fired (seconds) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, BlueprintSetter = SetHookCooldown, Category = "Hook", meta=(AllowPrivateAccess="true", ClampMin = "0.0"))
+	float HookCooldown = 0.0f;
+
 	/** Whether the character is currently hooked */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Hook", meta=(AllowPrivateAccess="true"))
 	bool bIsHooked = false;
@@ -157,22 +230,100 @@ protected:
 	void DoHookStart(const FInputActionValue& ActionValue);
 	void DoHookEnd(const FInputActionValue& ActionValue);
 
+	/** Returns true if a new hook can be attempted right now */
+	bool IsHookAllowed() const;
+
+	/** Attempts to hook if allowed. Returns false if the hook couldn't be attempted */
+	bool TryHook();
+
 	// Internal helpers
 	bool FindHookPoint(FVector& OutHitLocation);
 	void PerformHook();
 	void UpdateHookMovement(float DeltaTime);
 	void EndHook();
 
+	// --- Input Buffer ---
+	/** How long a press that isn't legal yet is held before being dropped. Zero disables buffering */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Input Buffer", meta=(AllowPrivateAccess="true", ClampMin = "0.0", ClampMax = "1.0", Units = "s"))
+	float InputBufferWindow = 0.15f;
+
+	/** Max time a buffered dash is back-dated by when it finally runs */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Input Buffer", meta=(AllowPrivateAccess="true", ClampMin = "0.0", ClampMax = "0.5", Units = "s"))
+	float MaxDashBackdate = 0.1f;
+
+	/** Time over which a back-dated dash makes up the distance it skipped. Spreading it over a few frames avoids a visible pop */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Input Buffer", meta=(AllowPrivateAccess="true", ClampMin = "0.01", ClampMax = "0.2", Units = "s"))
+	float DashCatchUpTime = 0.05f;
+
+	/** Number of input-to-action latency samples kept for percentile reporting */
+	static constexpr int32 NumInputLatencySamples = 256;
+
+	/** Pending presses, at most one per action */
+	TArray<FTemporalDashBufferedInput, TInlineAllocator<3>> BufferedInputs;
+
+	/** Ring buffer of input-to-action latencies, in seconds */
+	TArray<float> InputLatencySamples;
+
+	/** Next slot to write in the latency ring buffer */
+	int32 InputLatencySampleIndex = 0;
+
+	/** Stores a press that couldn't be executed yet. Replaces any older press of the same action */
+	void BufferInput(ETemporalDashBufferedAction Action, double PressRealTime, const FVector& Direction = FVector::ZeroVector);
+
+	/** Drops a buffered press, e.g. when the button is released before it could run */
+	void ClearBufferedInput(ETemporalDashBufferedAction Action);
+
+	/** Runs any buffered presses that have become legal and drops expired ones */
+	void ProcessBufferedInputs();
+
+	/** Records the delay between a press and its action running. Takes the platform time of the press */
+	void RecordInputLatency(double PressRealTime);
+
+public:
+
+	/** Calculates input-to-action latency percentiles, in milliseconds. Returns false if there are no samples yet */
+	bool GetInputLatencyPercentiles(float& OutP50, float& OutP95, float& OutP99) const;
+
 protected:
 
 	/** Called when the game starts or when spawned */
 	virtual void BeginPlay() override;
 
-	/** Called every frame */
+	/** Gameplay cleanup */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Called every frame while dashing, hooked or holding buffered inputs */
 	virtual void Tick(float DeltaTime) override;
 
+	/** If true, a Blueprint subclass implements Event Tick, so we can't stop ticking while idle */
+	bool bHasBlueprintTick = false;
+
+	/** If true, tick is currently disabled because there's no dash, hook or buffered input to update */
+	bool bTickIdle = false;
+
+	/** Enables tick only while there's dash, hook or buffered input work to do */
+	void UpdateTickEnabled();
+
+	/** Registers the dash and hook charges and cooldowns with the ability resources, or updates them if already registered */
+	void RegisterAbilityResources();
+
+#if WITH_EDITOR
+	/** Pushes charge and cooldown edits made while playing to the ability resources */
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif // WITH_EDITOR
+
+	// --- AI Traversal ---
+	/** Navigation link we're waiting to cross, if any */
+	TWeakObjectPtr<ATemporalDashTraversalLink> PendingTraversalLink;
+
+	/** Navmesh point at the end of the pending traversal link */
+	FVector PendingTraversalDestination = FVector::ZeroVector;
+
 	/** Set up input action bindings */
 	virtual void SetupPlayerInputComponent(UInputComponent* InputComponent) override;
+
+	/** Only players drive predictive streaming */
+	virtual void NotifyControllerChanged() override;
 	
 	// --- Double-jump support ---
 	/** Maximum number of jumps allowed before landing (set to 2 for double-jump) */
@@ -199,5 +350,70 @@ public:
 	/** Returns first person camera component **/
 	UCameraComponent* GetFirstPersonCameraComponent() const { return FirstPersonCameraComponent; }
 
+	/** Returns the predictive streaming source component **/
+	UTemporalDashStreamingSourceComponent* GetStreamingSource() const { return StreamingSource; }
+
+	/** Returns the ability charges and cooldowns component **/
+	UTemporalDashAbilityResourceComponent* GetAbilityResources() const { return AbilityResources; }
+
+	/** Returns true while a dash is in progress */
+	bool IsDashing() const { return bIsDashing; }
+
+	/** Returns the velocity the current dash is driving towards */
+	const FVector& GetDashTargetVelocity() const { return DashTargetVelocity; }
+
+	/** Returns true while attached to a hook point */
+	bool IsHooked() const { return bIsHooked; }
+
+	/** Returns the current hook attachment point */
+	const FVector& GetHookPoint() const { return HookPoint; }
+
+	/** Returns the max velocity reachable while being pulled by the hook */
+	float GetHookMaxVelocity() const { return HookMaxVelocity; }
+
+	/** Returns the configured dash distance */
+	float GetDashDistance() const { return DashDistance; }
+
+	/** Returns the horizontal distance actually covered by a full dash, following the dash speed profile */
+	float GetDashReach() const { return DashDistance * GetDashDistanceScale(1.f); }
+
+	/** Returns the max range to detect hook points */
+	float GetHookMaxRange() const { return HookMaxRange; }
+
+	/** Sets the number of dash charges. Cooldowns already in progress are kept */
+	UFUNCTION(BlueprintCallable, Category="Dash")
+	void SetDashCharges(int32 NewDashCharges);
+
+	/** Sets the time it takes to recharge a single dash charge */
+	UFUNCTION(BlueprintCallable, Category="Dash")
+	void SetDashCooldown(float NewDashCooldown);
+
+	/** Sets the time after a successful hook before the next one can be fired */
+	UFUNCTION(BlueprintCallable, Category="Hook")
+	void SetHookCooldown(float NewHookCooldown);
+
+public:
+
+	/** Dashes in the given direction if allowed, without buffering. Used by AI traversal */
+	bool DashInDirection(const FVector& Direction);
+
+	/** Hooks towards a world point if allowed, without tracing for a hook target. Used by AI traversal */
+	bool HookToPoint(const FVector& Point);
+
+	/** Called by a traversal link when path following reaches it. Path following stays paused until the traversal finishes */
+	void SetPendingTraversal(ATemporalDashTraversalLink* Link, const FVector& Destination);
+
+	/** Resumes path following after crossing the pending traversal link */
+	void FinishPendingTraversal();
+
+	/** Returns the traversal link we're waiting to cross, if any */
+	ATemporalDashTraversalLink* GetPendingTraversalLink() const { return PendingTraversalLink.Get(); }
+
+	/** Returns the navmesh point at the end of the pending traversal link */
+	const FVector& GetPendingTraversalDestination() const { return PendingTraversalDestination; }
+
+	/** Drops buffered presses, ends any dash or hook, releases the pending traversal link and resets the jump count. Used when a character dies or is pooled */
+	void ResetTraversalState();
+
 };
 
@@ -1,17 +1,26 @@
 ﻿// Additional dash implementation for ATemporalDashCharacter
-// Implements DoDashStart, PerformDash, EndDash, ResetDashCooldown
+// Implements DoDashStart, DashInDirection, TryDash, PerformDash, EndDash
 
 #include "TemporalDashCharacter.h"
 #include "TemporalDash.h"
+#include "TemporalDashAbilityResourceComponent.h"
 #include "InputActionValue.h"
 #include "GameFramework/CharacterMovementComponent.h"
-#include "TimerManager.h"
 #include "EnhancedInputComponent.h"
 
 void ATemporalDashCharacter::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// register the dash and hook charges
+	RegisterAbilityResources();
+
+	// Blueprint subclasses that use Event Tick need to keep ticking
+	bHasBlueprintTick = GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(AActor, ReceiveTick));
+
+	// start off idle unless there's something to update
+	UpdateTickEnabled();
+
 	// Try to bind actions if InputComponent is available and is an EnhancedInputComponent
 	if (UInputComponent* IC = InputComponent)
 	{
@@ -34,20 +43,56 @@ void ATemporalDashCharacter::BeginPlay()
 	}
 }
 
-void ATemporalDashCharacter::DoDashStart(const FInputActionValue& ActionValue)
+void ATemporalDashCharacter::RegisterAbilityResources()
 {
-	// Guards
-	if (bIsDashing)
+	// re-registering updates the charges and cooldowns in place
+	AbilityResources->RegisterAbility(DashAbilityName, DashCharges, DashCooldown);
+	AbilityResources->RegisterAbility(HookAbilityName, 1, HookCooldown);
+}
+
+void ATemporalDashCharacter::SetDashCharges(int32 NewDashCharges)
+{
+	DashCharges = FMath::Clamp(NewDashCharges, 1, 5);
+	RegisterAbilityResources();
+}
+
+void ATemporalDashCharacter::SetDashCooldown(float NewDashCooldown)
+{
+	DashCooldown = FMath::Max(NewDashCooldown, 0.0f);
+	RegisterAbilityResources();
+}
+
+void ATemporalDashCharacter::SetHookCooldown(float NewHookCooldown)
+{
+	HookCooldown = FMath::Max(NewHookCooldown, 0.0f);
+	RegisterAbilityResources();
+}
+
+#if WITH_EDITOR
+void ATemporalDashCharacter::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// defaults are registered on BeginPlay, so only edits made while playing need pushing
+	if (!HasActorBegunPlay())
 	{
 		return;
 	}
-	
-	if (!GetCharacterMovement())
+
+	const FName PropertyName = PropertyChangedEvent.GetMemberPropertyName();
+
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(ATemporalDashCharacter, DashCharges)
+		|| PropertyName == GET_MEMBER_NAME_CHECKED(ATemporalDashCharacter, DashCooldown)
+		|| PropertyName == GET_MEMBER_NAME_CHECKED(ATemporalDashCharacter, HookCooldown))
 	{
-		return;
+		RegisterAbilityResources();
 	}
-	
-	if (GetWorldTimerManager().IsTimerActive(DashCooldownHandle))
+}
+#endif // WITH_EDITOR
+
+void ATemporalDashCharacter::DoDashStart(const FInputActionValue& ActionValue)
+{
+	if (!GetCharacterMovement())
 	{
 		return;
 	}
@@ -67,10 +112,62 @@ void ATemporalDashCharacter::DoDashStart(const FInputActionValue& ActionValue)
 		InputDir = GetActorForwardVector();
 	}
 
-	PerformDash(InputDir);
+	// dash right away if we can, otherwise hold on to the press until the dash is available
+	const double PressRealTime = FPlatformTime::Seconds();
+
+	if (TryDash(InputDir, GetWorld()->GetTimeSeconds()))
+	{
+		RecordInputLatency(PressRealTime);
+
+	} else {
+
+		BufferInput(ETemporalDashBufferedAction::Dash, PressRealTime, InputDir);
+	}
+}
+
+bool ATemporalDashCharacter::DashInDirection(const FVector& Direction)
+{
+	return TryDash(Direction, GetWorld()->GetTimeSeconds());
+}
+
+bool ATemporalDashCharacter::IsDashAllowed() const
+{
+	// Guards
+	if (bIsDashing)
+	{
+		return false;
+	}
+
+	if (!GetCharacterMovement())
+	{
+		return false;
+	}
+
+	return AbilityResources->HasCharge(DashAbilityName);
 }
 
-void ATemporalDashCharacter::PerformDash(const FVector& Direction)
+bool ATemporalDashCharacter::TryDash(const FVector& Direction, double PressTimestamp)
+{
+	if (!IsDashAllowed())
+	{
+		return false;
+	}
+
+	// spend a dash charge
+	if (!AbilityResources->TryConsume(DashAbilityName))
+	{
+		return false;
+	}
+
+	// back-date buffered presses so they cover the distance they would have if they ran when pressed
+	const float Backdate = FMath::Min(static_cast<float>(GetWorld()->GetTimeSeconds() - PressTimestamp), MaxDashBackdate);
+
+	PerformDash(Direction, Backdate);
+
+	return true;
+}
+
+void ATemporalDashCharacter::PerformDash(const FVector& Direction, float Backdate)
 {
 	FVector Dir = Direction.GetSafeNormal();
 	if (Dir.IsNearlyZero()) 
@@ -78,6 +175,9 @@ void ATemporalDashCharacter::PerformDash(const FVector& Direction)
 		Dir = GetActorForwardVector();
 	}
 
+	// Never make up more than half the dash
+	Backdate = FMath::Clamp(Backdate, 0.f, DashDuration * 0.5f);
+
 	// Store dash parameters for Tick to apply
 	DashDirection = FVector(Dir.X, Dir.Y, 0.f).GetSafeNormal(); // Horizontal only
 	DashTimeRemaining = DashDuration;
@@ -88,6 +188,20 @@ void ATemporalDashCharacter::PerformDash(const FVector& Direction)
 	DashInitialSpeed = TargetSpeed; // Keep for reference
 	
 	bIsDashing = true;
+	UpdateTickEnabled();
+
+	// Make up the part of the dash we skipped over the next few frames. It goes through the movement component, so it follows floors and steps
+	DashCatchUpVelocity = FVector::ZeroVector;
+	DashCatchUpTimeRemaining = 0.f;
+	DashAppliedCatchUp = FVector::ZeroVector;
+
+	if (Backdate > 0.f)
+	{
+		const float SkippedDistance = DashDistance * GetDashDistanceScale(Backdate / DashDuration);
+
+		DashCatchUpTimeRemaining = FMath::Min(DashCatchUpTime, DashDuration);
+		DashCatchUpVelocity = DashDirection * (SkippedDistance / DashCatchUpTimeRemaining);
+	}
 
 	// Store original movement settings to restore later
 	if (UCharacterMovementComponent* Movement = GetCharacterMovement())
@@ -100,9 +214,43 @@ void ATemporalDashCharacter::PerformDash(const FVector& Direction)
 		// Disable gravity during dash for consistent horizontal movement
 		Movement->GravityScale = 0.f;
 	}
+}
 
-	// Start cooldown immediately
-	GetWorldTimerManager().SetTimer(DashCooldownHandle, this, &ATemporalDashCharacter::ResetDashCooldown, DashCooldown, false);
+float ATemporalDashCharacter::GetDashSpeedScale(float Alpha)
+{
+	// Phase 1: Accelerate to target velocity (first 20% of dash duration)
+	// Phase 2: Maintain target velocity (middle 60%)
+	// Phase 3: Decelerate to zero (last 20%)
+	if (Alpha < 0.2f)
+	{
+		// Accelerate: 0→100% over first 20%
+		return Alpha / 0.2f;
+	}
+	else if (Alpha < 0.8f)
+	{
+		// Maintain: 100% speed
+		return 1.f;
+	}
+
+	// Decelerate: 100%→0% over last 20%
+	return FMath::Max((1.f - Alpha) / 0.2f, 0.f);
+}
+
+float ATemporalDashCharacter::GetDashDistanceScale(float Alpha)
+{
+	// Integral of GetDashSpeedScale over [0, Alpha]
+	Alpha = FMath::Clamp(Alpha, 0.f, 1.f);
+
+	if (Alpha < 0.2f)
+	{
+		return FMath::Square(Alpha) / 0.4f;
+	}
+	else if (Alpha < 0.8f)
+	{
+		return 0.1f + (Alpha - 0.2f);
+	}
+
+	return 0.8f - FMath::Square(1.f - Alpha) / 0.4f;
 }
 
 void ATemporalDashCharacter::EndDash()
@@ -110,6 +258,16 @@ void ATemporalDashCharacter::EndDash()
 	bIsDashing = false;
 	DashTimeRemaining = 0.f;
 
+	// drop any catch-up that's left, along with what we added last frame
+	if (UCharacterMovementComponent* Movement = GetCharacterMovement())
+	{
+		Movement->Velocity -= DashAppliedCatchUp;
+	}
+
+	DashCatchUpVelocity = FVector::ZeroVector;
+	DashCatchUpTimeRemaining = 0.f;
+	DashAppliedCatchUp = FVector::ZeroVector;
+
 	// Restore original movement settings
 	if (UCharacterMovementComponent* Movement = GetCharacterMovement())
 	{
@@ -118,48 +276,29 @@ void ATemporalDashCharacter::EndDash()
 		Movement->BrakingFrictionFactor = 2.f; // UE default
 		Movement->GravityScale = 1.f; // Restore gravity
 	}
-}
 
-void ATemporalDashCharacter::ResetDashCooldown()
-{
-	// intentionally empty
+	// run anything that was pressed during the dash
+	ProcessBufferedInputs();
 }
 
 void ATemporalDashCharacter::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+	// Run buffered presses that became legal since last frame
+	ProcessBufferedInputs();
+
 	// Update Dash
 	if (bIsDashing && DashTimeRemaining > 0.f)
 	{
 		if (UCharacterMovementComponent* Movement = GetCharacterMovement())
 		{
-			FVector CurrentVelocity = Movement->Velocity;
+			// leave out last frame's catch-up, so it doesn't carry into the interpolation
+			FVector CurrentVelocity = Movement->Velocity - DashAppliedCatchUp;
 			
 			// Calculate progress: 0→1 over dash duration
 			float Alpha = 1.f - (DashTimeRemaining / DashDuration);
-			FVector TargetVel;
-			
-			// Phase 1: Accelerate to target velocity (first 20% of dash duration)
-			// Phase 2: Maintain target velocity (middle 60%)
-			// Phase 3: Decelerate to zero (last 20%)
-			if (Alpha < 0.2f)
-			{
-				// Accelerate: 0→100% over first 20%
-				float AccelAlpha = Alpha / 0.2f;
-				TargetVel = DashTargetVelocity * AccelAlpha;
-			}
-			else if (Alpha < 0.8f)
-			{
-				// Maintain: 100% speed
-				TargetVel = DashTargetVelocity;
-			}
-			else
-			{
-				// Decelerate: 100%→0% over last 20%
-				float DecelAlpha = (1.f - Alpha) / 0.2f;
-				TargetVel = DashTargetVelocity * DecelAlpha;
-			}
+			FVector TargetVel = DashTargetVelocity * GetDashSpeedScale(Alpha);
 			
 			// Smoothly interpolate horizontal velocity toward target (like hook does)
 			FVector NewVelocity = FMath::VInterpTo(
@@ -171,7 +310,17 @@ void ATemporalDashCharacter::Tick(float DeltaTime)
 			
 			// Preserve vertical velocity (gravity/jumping)
 			NewVelocity.Z = CurrentVelocity.Z;
-			Movement->Velocity = NewVelocity;
+
+			// add the back-dated distance on top, only for the part of the frame that's still catching up
+			DashAppliedCatchUp = FVector::ZeroVector;
+
+			if (DashCatchUpTimeRemaining > 0.f && DeltaTime > 0.f)
+			{
+				DashAppliedCatchUp = DashCatchUpVelocity * (FMath::Min(DeltaTime, DashCatchUpTimeRemaining) / DeltaTime);
+				DashCatchUpTimeRemaining -= DeltaTime;
+			}
+
+			Movement->Velocity = NewVelocity + DashAppliedCatchUp;
 		}
 
 		// Decrease remaining time
@@ -1,8 +1,9 @@
 // Additional hook implementation for ATemporalDashCharacter
-// Implements DoHookStart, DoHookEnd, FindHookPoint, PerformHook, UpdateHookMovement, EndHook
+// Implements DoHookStart, DoHookEnd, TryHook, HookToPoint, FindHookPoint, PerformHook, UpdateHookMovement, EndHook
 
 #include "TemporalDashCharacter.h"
 #include "TemporalDash.h"
+#include "TemporalDashAbilityResourceComponent.h"
 #include "HookableActor.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Camera/CameraComponent.h"
@@ -12,28 +13,71 @@
 
 void ATemporalDashCharacter::DoHookStart(const FInputActionValue& ActionValue)
 {
+	const double PressRealTime = FPlatformTime::Seconds();
+
+	// hook right away if we can
+	if (TryHook())
+	{
+		RecordInputLatency(PressRealTime);
+
+	} else if (!bIsHooked) {
+
+		// out of charges, hold on to the press while the button is down in case one comes back.
+		// Pressing while already hooked isn't buffered, since the release that would let it run also drops it
+		BufferInput(ETemporalDashBufferedAction::Hook, PressRealTime);
+	}
+}
+
+void ATemporalDashCharacter::DoHookEnd(const FInputActionValue& ActionValue)
+{
+	// the button was let go, so a press that is still waiting should not run anymore
+	ClearBufferedInput(ETemporalDashBufferedAction::Hook);
 
 	if (bIsHooked)
 	{
-		return;
+		EndHook();
+	}
+}
+
+bool ATemporalDashCharacter::IsHookAllowed() const
+{
+	return !bIsHooked && AbilityResources->HasCharge(HookAbilityName);
+}
+
+bool ATemporalDashCharacter::TryHook()
+{
+	if (!IsHookAllowed())
+	{
+		return false;
 	}
 
+	// a miss still counts as an attempt
 	FVector HitLocation;
 	if (FindHookPoint(HitLocation))
 	{
+		// only successful hooks go on cooldown
+		AbilityResources->TryConsume(HookAbilityName);
+
 		HookPoint = HitLocation;
 		PerformHook();
 	}
+
+	return true;
 }
 
-void ATemporalDashCharacter::DoHookEnd(const FInputActionValue& ActionValue)
+bool ATemporalDashCharacter::HookToPoint(const FVector& Point)
 {
-	// DEBUG: Check if function is being called
-
-	if (bIsHooked)
+	if (!IsHookAllowed())
 	{
-		EndHook();
+		return false;
 	}
+
+	AbilityResources->TryConsume(HookAbilityName);
+
+	HookPoint = Point;
+	PerformHook();
+
+	return true;
 }
 
 bool ATemporalDashCharacter::FindHookPoint(FVector& OutHitLocation)
@@ -100,6 +144,7 @@ bool ATemporalDashCharacter::FindHookPoint(FVector& OutHitLocation)
 void ATemporalDashCharacter::PerformHook()
 {
 	bIsHooked = true;
+	UpdateTickEnabled();
 
 	// Record initial rope length (for rope constraint)
 	HookMaxRopeLength = FVector::Dist(GetActorLocation(), HookPoint);
@@ -238,4 +283,7 @@ void ATemporalDashCharacter::EndHook()
 		// Return to walking mode (will auto-switch to falling if in air)
 		MoveComp->SetMovementMode(MOVE_Walking);
 	}
+
+	// run the jumps and dashes that were pressed while hooked
+	ProcessBufferedInputs();
 }
\ No newline at end of file
@@ -0,0 +1,169 @@
+// Additional input buffer implementation for ATemporalDashCharacter
+// Implements BufferInput, ClearBufferedInput, ProcessBufferedInputs, RecordInputLatency, GetInputLatencyPercentiles
+
+#include "TemporalDashCharacter.h"
+#include "TemporalDash.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Buffered Inputs Executed"), STAT_TemporalDashBufferedInputsExecuted, STATGROUP_TemporalDash);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Buffered Inputs Expired"), STAT_TemporalDashBufferedInputsExpired, STATGROUP_TemporalDash);
+
+void ATemporalDashCharacter::BufferInput(ETemporalDashBufferedAction Action, double PressRealTime, const FVector& Direction)
+{
+	// buffering disabled, drop the press like before
+	if (InputBufferWindow <= 0.f)
+	{
+		return;
+	}
+
+	// keep only the latest press of each action
+	ClearBufferedInput(Action);
+
+	FTemporalDashBufferedInput& Input = BufferedInputs.AddDefaulted_GetRef();
+	Input.Action = Action;
+	Input.Timestamp = GetWorld()->GetTimeSeconds();
+	Input.PressRealTime = PressRealTime;
+	Input.Direction = Direction;
+
+	// tick until the press runs or expires
+	UpdateTickEnabled();
+}
+
+void ATemporalDashCharacter::ClearBufferedInput(ETemporalDashBufferedAction Action)
+{
+	// stop ticking if that was the last pending press
+	if (BufferedInputs.RemoveAll([Action](const FTemporalDashBufferedInput& Input) { return Input.Action == Action; }) > 0)
+	{
+		UpdateTickEnabled();
+	}
+}
+
+void ATemporalDashCharacter::ProcessBufferedInputs()
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	// process in press order so older presses get a chance to run first
+	for (int32 i = 0; i < BufferedInputs.Num(); )
+	{
+		// copy, since running the action may modify the buffer
+		const FTemporalDashBufferedInput Input = BufferedInputs[i];
+
+		// drop presses that waited for too long
+		if (Now - Input.Timestamp > InputBufferWindow)
+		{
+			BufferedInputs.RemoveAt(i);
+			INC_DWORD_STAT(STAT_TemporalDashBufferedInputsExpired);
+			continue;
+		}
+
+		bool bExecuted = false;
+
+		switch (Input.Action)
+		{
+		case ETemporalDashBufferedAction::Jump:
+			bExecuted = TryJump();
+			break;
+
+		case ETemporalDashBufferedAction::Dash:
+			bExecuted = TryDash(Input.Direction, Input.Timestamp);
+			break;
+
+		case ETemporalDashBufferedAction::Hook:
+			bExecuted = TryHook();
+			break;
+		}
+
+		if (bExecuted)
+		{
+			RecordInputLatency(Input.PressRealTime);
+			INC_DWORD_STAT(STAT_TemporalDashBufferedInputsExecuted);
+
+			// the action may have already cleared the buffer
+			const int32 ExecutedIndex = BufferedInputs.IndexOfByPredicate([&Input](const FTemporalDashBufferedInput& Other)
+			{
+				return Other.Action == Input.Action && Other.Timestamp == Input.Timestamp;
+			});
+
+			if (ExecutedIndex != INDEX_NONE)
+			{
+				BufferedInputs.RemoveAt(ExecutedIndex);
+			}
+
+		} else {
+
+			++i;
+		}
+	}
+
+	// stop ticking if there's nothing left to do
+	UpdateTickEnabled();
+}
+
+void ATemporalDashCharacter::RecordInputLatency(double PressRealTime)
+{
+	// platform time, so immediate presses measure the handler and buffered ones aren't rounded to whole frames
+	const float Latency = static_cast<float>(FPlatformTime::Seconds() - PressRealTime);
+
+	// fill the ring buffer, then start overwriting the oldest samples
+	if (InputLatencySamples.Num() < NumInputLatencySamples)
+	{
+		InputLatencySamples.Add(Latency);
+
+	} else {
+
+		InputLatencySamples[InputLatencySampleIndex] = Latency;
+	}
+
+	InputLatencySampleIndex = (InputLatencySampleIndex + 1) % NumInputLatencySamples;
+}
+
+bool ATemporalDashCharacter::GetInputLatencyPercentiles(float& OutP50, float& OutP95, float& OutP99) const
+{
+	if (InputLatencySamples.IsEmpty())
+	{
+		return false;
+	}
+
+	TArray<float, TInlineAllocator<NumInputLatencySamples>> Sorted(InputLatencySamples);
+	Sorted.Sort();
+
+	const auto Percentile = [&Sorted](float Fraction)
+	{
+		const int32 Index = FMath::Clamp(FMath::CeilToInt(Fraction * Sorted.Num()) - 1, 0, Sorted.Num() - 1);
+		return Sorted[Index] * 1000.f;
+	};
+
+	OutP50 = Percentile(0.50f);
+	OutP95 = Percentile(0.95f);
+	OutP99 = Percentile(0.99f);
+
+	return true;
+}
+
+static void DumpInputLatency(UWorld* World)
+{
+	for (TActorIterator<ATemporalDashCharacter> It(World); It; ++It)
+	{
+		if (!It->IsPlayerControlled())
+		{
+			continue;
+		}
+
+		float P50, P95, P99;
+		if (It->GetInputLatencyPercentiles(P50, P95, P99))
+		{
+			UE_LOG(LogTemporalDash, Display, TEXT("'%s' input-to-action latency: p50 %.1f ms, p95 %.1f ms, p99 %.1f ms"), *It->GetName(), P50, P95, P99);
+
+		} else {
+
+			UE_LOG(LogTemporalDash, Display, TEXT("'%s' has no input latency samples yet"), *It->GetName());
+		}
+	}
+}
+
+static FAutoConsoleCommandWithWorld CmdDumpInputLatency(
+	TEXT("TemporalDash.DumpInputLatency"),
+	TEXT("Logs input-to-action latency percentiles for player controlled characters"),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&DumpInputLatency));
@@ -0,0 +1,29 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+
+/**
+ *  Loads an asset baked for the world's map by one of the map commandlets, and saved next to it
+ *  @param World world to load the asset for. PIE worlds load the asset of the map they were duplicated from
+ *  @param GetPackageName returns the asset package name for a map package name
+ *  @return the asset, or nullptr if it hasn't been baked for this map
+ */
+template<typename T>
+T* LoadMapSideCarAsset(const UWorld& World, FString (*GetPackageName)(const FString&))
+{
+	const FString PackageName = GetPackageName(UWorld::RemovePIEPrefix(World.GetOutermost()->GetName()));
+
+	if (!FPackageName::DoesPackageExist(PackageName))
+	{
+		return nullptr;
+	}
+
+	const FString ObjectPath = PackageName + TEXT(".") + FPackageName::GetShortName(PackageName);
+
+	return LoadObject<T>(nullptr, *ObjectPath);
+}
@@ -0,0 +1,184 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "TemporalDashStreamingSourceComponent.h"
+#include "TemporalDashCharacter.h"
+#include "TemporalDash.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "WorldPartition/WorldPartitionSubsystem.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Predicted Streaming Sources"), STAT_TemporalDashPredictedSources, STATGROUP_TemporalDash);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Streaming Stalls"), STAT_TemporalDashStreamingStalls, STATGROUP_TemporalDash);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Streaming Stalled Time (s)"), STAT_TemporalDashStreamingStalledTime, STATGROUP_TemporalDash);
+
+UTemporalDashStreamingSourceComponent::UTemporalDashStreamingSourceComponent()
+{
+	// only ticks for stall checks, and only while player controlled. The owner enables the tick on possession
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
+void UTemporalDashStreamingSourceComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	OwnerCharacter = Cast<ATemporalDashCharacter>(GetOwner());
+
+	// set the stall check interval
+	SetComponentTickInterval(StallCheckInterval);
+
+	// the World Partition subsystem only exists on partitioned worlds
+	if (UWorldPartitionSubsystem* WorldPartitionSubsystem = GetWorld()->GetSubsystem<UWorldPartitionSubsystem>())
+	{
+		WorldPartitionSubsystem->RegisterStreamingSourceProvider(this);
+	}
+}
+
+void UTemporalDashStreamingSourceComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UWorldPartitionSubsystem* WorldPartitionSubsystem = GetWorld()->GetSubsystem<UWorldPartitionSubsystem>())
+	{
+		WorldPartitionSubsystem->UnregisterStreamingSourceProvider(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UTemporalDashStreamingSourceComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	const UWorldPartitionSubsystem* WorldPartitionSubsystem = GetWorld()->GetSubsystem<UWorldPartitionSubsystem>();
+
+	if (!WorldPartitionSubsystem || !OwnerCharacter.IsValid())
+	{
+		return;
+	}
+
+	// query the cells right around the character
+	FWorldPartitionStreamingQuerySource QuerySource(OwnerCharacter->GetActorLocation());
+	QuerySource.bUseGridLoadingRange = false;
+	QuerySource.Radius = StallCheckRadius;
+
+	const bool bWasStalled = bStalled;
+	bStalled = !WorldPartitionSubsystem->IsStreamingCompleted(EWorldPartitionRuntimeCellState::Activated, { QuerySource }, false);
+
+	if (bStalled)
+	{
+		INC_FLOAT_STAT_BY(STAT_TemporalDashStreamingStalledTime, DeltaTime);
+
+		// count each stall once, when it begins
+		if (!bWasStalled)
+		{
+			++NumStalls;
+			INC_DWORD_STAT(STAT_TemporalDashStreamingStalls);
+
+			UE_LOG(LogTemporalDash, Verbose, TEXT("'%s' streaming stalled at %s (stall #%d)"), *GetNameSafe(GetOwner()), *OwnerCharacter->GetActorLocation().ToCompactString(), NumStalls);
+		}
+	}
+}
+
+bool UTemporalDashStreamingSourceComponent::GetStreamingSources(TArray<FWorldPartitionStreamingSource>& OutStreamingSources) const
+{
+	// only stream ahead for players. NPCs don't drive streaming
+	if (!OwnerCharacter.IsValid() || !OwnerCharacter->IsPlayerControlled())
+	{
+		return false;
+	}
+
+	FVector PathStart, PathEnd;
+	float PathSpeed = 0.0f;
+
+	// a hook can start from a standstill, so there may be no speed to predict with
+	if (!PredictPath(PathStart, PathEnd, PathSpeed) || PathSpeed <= UE_KINDA_SMALL_NUMBER)
+	{
+		return false;
+	}
+
+	const FVector PathDelta = PathEnd - PathStart;
+	const FRotator PathRotation = PathDelta.Rotation();
+
+	// time it takes us to get to the end of the path, capped to the prediction horizon
+	const float PathTime = FMath::Min(PathDelta.Size() / PathSpeed, PredictionHorizon);
+	const float PathAlphaScale = PathTime * PathSpeed / FMath::Max(PathDelta.Size(), UE_KINDA_SMALL_NUMBER);
+
+	for (int32 i = 1; i <= NumPathSamples; ++i)
+	{
+		const float SampleAlpha = static_cast<float>(i) / NumPathSamples;
+		const float ArrivalTime = PathTime * SampleAlpha;
+
+		FWorldPartitionStreamingSource& Source = OutStreamingSources.AddDefaulted_GetRef();
+		Source.Name = FName(TEXT("TemporalDashPredicted"), i);
+		Source.Location = PathStart + PathDelta * (SampleAlpha * PathAlphaScale);
+		Source.Rotation = PathRotation;
+		Source.TargetState = EStreamingSourceTargetState::Activated;
+		Source.bBlockOnSlowLoading = false;
+		Source.DebugColor = DebugColor;
+		Source.Velocity = PathSpeed;
+
+		// earlier arrivals get higher priority. Lower values are higher priority, scale from Highest to Normal
+		const float PriorityAlpha = ArrivalTime / PredictionHorizon;
+		Source.Priority = static_cast<EStreamingSourcePriority>(FMath::RoundToInt(FMath::Lerp(
+			static_cast<float>(EStreamingSourcePriority::Highest),
+			static_cast<float>(EStreamingSourcePriority::Normal),
+			PriorityAlpha)));
+
+		// override the loading range if requested
+		if (SampleRadius > 0.0f)
+		{
+			FStreamingSourceShape& Shape = Source.Shapes.AddDefaulted_GetRef();
+			Shape.bUseGridLoadingRange = false;
+			Shape.Radius = SampleRadius;
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_TemporalDashPredictedSources, NumPathSamples);
+
+	return true;
+}
+
+bool UTemporalDashStreamingSourceComponent::PredictPath(FVector& OutStart, FVector& OutEnd, float& OutSpeed) const
+{
+	const ATemporalDashCharacter* Character = OwnerCharacter.Get();
+	const UCharacterMovementComponent* Movement = Character->GetCharacterMovement();
+
+	OutStart = Character->GetActorLocation();
+
+	const float CurrentSpeed = Movement ? Movement->Velocity.Size() : 0.0f;
+
+	// hooked: we're being pulled straight towards the hook point
+	if (Character->IsHooked())
+	{
+		OutEnd = Character->GetHookPoint();
+
+		// the pull accelerates us up to the max hook velocity, so assume we'll get there
+		OutSpeed = FMath::Max(CurrentSpeed, Character->GetHookMaxVelocity());
+		return true;
+	}
+
+	// dashing: the remaining dash displacement is known
+	if (Character->IsDashing())
+	{
+		const FVector DashVelocity = Character->GetDashTargetVelocity();
+
+		OutSpeed = DashVelocity.Size();
+
+		if (OutSpeed > UE_KINDA_SMALL_NUMBER)
+		{
+			// extrapolate past the end of the dash for the rest of the horizon, since dashes get chained
+			OutEnd = OutStart + DashVelocity * PredictionHorizon;
+			return true;
+		}
+	}
+
+	// free movement: extrapolate our velocity if we're fast enough
+	if (CurrentSpeed >= MinPredictionSpeed)
+	{
+		OutSpeed = CurrentSpeed;
+		OutEnd = OutStart + Movement->Velocity * PredictionHorizon;
+		return true;
+	}
+
+	return false;
+}
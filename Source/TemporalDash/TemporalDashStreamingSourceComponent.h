@@ -0,0 +1,104 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "WorldPartition/WorldPartitionStreamingSource.h"
+#include "TemporalDashStreamingSourceComponent.generated.h"
+
+class ATemporalDashCharacter;
+
+/**
+ *  World Partition streaming source that runs ahead of fast traversal
+ *  Projects the hook target or dash destination forward in time and requests cells along the predicted path
+ *  Sources are prioritized by predicted arrival time, so the closest cells in time load first
+ *  Only provides sources while the owning character is player controlled
+ */
+UCLASS(ClassGroup=(TemporalDash), meta=(BlueprintSpawnableComponent))
+class TEMPORALDASH_API UTemporalDashStreamingSourceComponent : public UActorComponent, public IWorldPartitionStreamingSourceProvider
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** How far ahead in time to predict the traversal path */
+	UPROPERTY(EditAnywhere, Category="Streaming", meta = (ClampMin = 0.1, ClampMax = 10, Units = "s"))
+	float PredictionHorizon = 1.5f;
+
+	/** Number of streaming sources to place along the predicted path */
+	UPROPERTY(EditAnywhere, Category="Streaming", meta = (ClampMin = 1, ClampMax = 8))
+	int32 NumPathSamples = 4;
+
+	/** Minimum speed before free movement is extrapolated. Slower movement is covered by the player's own streaming source */
+	UPROPERTY(EditAnywhere, Category="Streaming", meta = (ClampMin = 0, ClampMax = 10000, Units = "cm/s"))
+	float MinPredictionSpeed = 1200.0f;
+
+	/** Radius of each predicted streaming shape. Zero uses the runtime grid loading range */
+	UPROPERTY(EditAnywhere, Category="Streaming", meta = (ClampMin = 0, Units = "cm"))
+	float SampleRadius = 0.0f;
+
+	/** Color used to draw the predicted sources in the World Partition streaming debug views */
+	UPROPERTY(EditAnywhere, Category="Streaming")
+	FColor DebugColor = FColor::Cyan;
+
+	/** Radius around the character that must be activated. If it isn't, streaming has stalled behind the player */
+	UPROPERTY(EditAnywhere, Category="Streaming|Stats", meta = (ClampMin = 0, Units = "cm"))
+	float StallCheckRadius = 2000.0f;
+
+	/** Time between streaming stall checks */
+	UPROPERTY(EditAnywhere, Category="Streaming|Stats", meta = (ClampMin = 0, ClampMax = 1, Units = "s"))
+	float StallCheckInterval = 0.1f;
+
+	/** Cast pointer to the owning character */
+	TWeakObjectPtr<ATemporalDashCharacter> OwnerCharacter;
+
+	/** If true, the last stall check found the area around the character still streaming in */
+	bool bStalled = false;
+
+	/** Number of stalls detected since this component began play */
+	int32 NumStalls = 0;
+
+public:
+
+	/** Constructor */
+	UTemporalDashStreamingSourceComponent();
+
+protected:
+
+	/** Registers with the World Partition subsystem */
+	virtual void BeginPlay() override;
+
+	/** Unregisters from the World Partition subsystem */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Checks for streaming stalls around the owner */
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+public:
+
+	//~Begin IWorldPartitionStreamingSourceProvider interface
+
+	/** Provides one streaming source per predicted path sample */
+	virtual bool GetStreamingSources(TArray<FWorldPartitionStreamingSource>& OutStreamingSources) const override;
+
+	/** Returns the object providing the streaming sources */
+	virtual const UObject* GetStreamingSourceOwner() const override { return this; }
+
+	//~End IWorldPartitionStreamingSourceProvider interface
+
+	/** Returns the number of streaming stalls detected since begin play */
+	UFUNCTION(BlueprintPure, Category="Streaming")
+	int32 GetNumStalls() const { return NumStalls; }
+
+protected:
+
+	/**
+	 *  Predicts the owner's traversal path
+	 *  @param OutStart path start location
+	 *  @param OutEnd predicted location at the end of the path
+	 *  @param OutSpeed expected speed along the path
+	 *  @return true if there's a path worth streaming ahead for
+	 */
+	bool PredictPath(FVector& OutStart, FVector& OutEnd, float& OutSpeed) const;
+};
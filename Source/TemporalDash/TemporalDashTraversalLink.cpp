@@ -0,0 +1,54 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "TemporalDashTraversalLink.h"
+#include "TemporalDashCharacter.h"
+#include "NavLinkCustomComponent.h"
+
+const FName ATemporalDashTraversalLink::GeneratedTag = FName("TemporalDashGeneratedLink");
+
+ATemporalDashTraversalLink::ATemporalDashTraversalLink()
+{
+	// only use the smart link. Point links can't pause path following for the traversal
+	PointLinks.Empty();
+	bSmartLinkIsRelevant = true;
+
+	Tags.Add(GeneratedTag);
+}
+
+void ATemporalDashTraversalLink::SetupLink(ETemporalDashTraversalType InTraversalType, const FVector& Start, const FVector& End, const FVector& InHookPoint)
+{
+	TraversalType = InTraversalType;
+	HookPoint = InHookPoint;
+
+	// place the actor at the link start so the relative link data stays small
+	SetActorLocationAndRotation(Start, FRotator::ZeroRotator);
+
+	GetSmartLinkComp()->SetLinkData(FVector::ZeroVector, End - Start, ENavLinkDirection::LeftToRight);
+	GetSmartLinkComp()->SetEnabled(true);
+}
+
+void ATemporalDashTraversalLink::BeginPlay()
+{
+	Super::BeginPlay();
+
+	OnSmartLinkReached.AddDynamic(this, &ATemporalDashTraversalLink::OnTraversalLinkReached);
+}
+
+void ATemporalDashTraversalLink::OnTraversalLinkReached(AActor* MovingActor, const FVector& DestinationPoint)
+{
+	// hand the traversal over to the character. It'll resume path following when done
+	if (ATemporalDashCharacter* Character = Cast<ATemporalDashCharacter>(MovingActor))
+	{
+		Character->SetPendingTraversal(this, DestinationPoint);
+		return;
+	}
+
+	// we can't traverse, so let the path following deal with it
+	FinishTraversal(MovingActor);
+}
+
+void ATemporalDashTraversalLink::FinishTraversal(AActor* MovingActor)
+{
+	ResumePathFollowing(MovingActor);
+}
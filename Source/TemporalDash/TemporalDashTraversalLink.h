@@ -0,0 +1,72 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Navigation/NavLinkProxy.h"
+#include "TemporalDashTraversalLink.generated.h"
+
+/** Ability used to cross a traversal link */
+UENUM(BlueprintType)
+enum class ETemporalDashTraversalType : uint8
+{
+	Dash,
+	Hook
+};
+
+/**
+ *  Smart navigation link that AI characters cross with a dash or a hook
+ *  Placed offline by the traversal link commandlet, so NPC pathfinding can plan through gaps and onto rooftops
+ *  When an NPC reaches the link, its path following pauses and the traversal is handed to the character,
+ *  which is carried out by the "Perform Traversal" StateTree task
+ */
+UCLASS()
+class TEMPORALDASH_API ATemporalDashTraversalLink : public ANavLinkProxy
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Ability used to cross this link */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Traversal")
+	ETemporalDashTraversalType TraversalType = ETemporalDashTraversalType::Dash;
+
+	/** World space point to hook to. Only used by hook links */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Traversal")
+	FVector HookPoint = FVector::ZeroVector;
+
+public:
+
+	/** Tag applied to generated links, so they can be cleared before regenerating */
+	static const FName GeneratedTag;
+
+	/** Constructor */
+	ATemporalDashTraversalLink();
+
+	/**
+	 *  Sets up the link. The actor is moved to the link start
+	 *  @param InTraversalType ability used to cross the link
+	 *  @param Start world space link start, on the navmesh
+	 *  @param End world space link end, on the navmesh
+	 *  @param InHookPoint world space point to hook to, for hook links
+	 */
+	void SetupLink(ETemporalDashTraversalType InTraversalType, const FVector& Start, const FVector& End, const FVector& InHookPoint = FVector::ZeroVector);
+
+	/** Resumes the moving actor's path following once it's done crossing the link */
+	void FinishTraversal(AActor* MovingActor);
+
+	/** Returns the ability used to cross this link */
+	ETemporalDashTraversalType GetTraversalType() const { return TraversalType; }
+
+	/** Returns the world space hook point */
+	const FVector& GetHookPoint() const { return HookPoint; }
+
+protected:
+
+	/** Gameplay initialization */
+	virtual void BeginPlay() override;
+
+	/** Hands the traversal over to the character that reached the link */
+	UFUNCTION()
+	void OnTraversalLinkReached(AActor* MovingActor, const FVector& DestinationPoint);
+};
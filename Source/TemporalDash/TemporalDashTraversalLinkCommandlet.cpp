@@ -0,0 +1,302 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "TemporalDashTraversalLinkCommandlet.h"
+#include "TemporalDash.h"
+#include "TemporalDashCharacter.h"
+#include "HookableActor.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "NavigationSystem.h"
+#include "NavMesh/RecastNavMesh.h"
+
+UTemporalDashTraversalLinkCommandlet::UTemporalDashTraversalLinkCommandlet()
+{
+	// navigation is rebuilt after clearing the old links instead
+	bBuildNavigation = false;
+}
+
+bool UTemporalDashTraversalLinkCommandlet::ProcessWorld(UWorld* World, const TMap<FString, FString>& ParamVals)
+{
+	// read the traversal settings from the character that will use the links
+	const ATemporalDashCharacter* CharacterDefaults = GetCharacterDefaults(ParamVals);
+
+	CapsuleRadius = CharacterDefaults->GetCapsuleComponent()->GetUnscaledCapsuleRadius();
+	CapsuleHalfHeight = CharacterDefaults->GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight();
+	EyeHeight = CharacterDefaults->BaseEyeHeight;
+
+	const float DashReach = CharacterDefaults->GetDashReach() * DashReachSafety;
+	const float HookRange = CharacterDefaults->GetHookMaxRange() * HookRangeSafety;
+
+	// clear the links from the last run, so they don't affect the detour checks
+	int32 NumRemoved = 0;
+
+	for (TActorIterator<ATemporalDashTraversalLink> It(World); It; ++It)
+	{
+		if (It->ActorHasTag(ATemporalDashTraversalLink::GeneratedTag))
+		{
+			World->DestroyActor(*It);
+			++NumRemoved;
+		}
+	}
+
+	BuildNavigation(World);
+
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World);
+	ARecastNavMesh* NavMesh = NavSys ? Cast<ARecastNavMesh>(NavSys->GetDefaultNavDataInstance(FNavigationSystem::DontCreate)) : nullptr;
+
+	if (!NavMesh)
+	{
+		UE_LOG(LogTemporalDash, Error, TEXT("No navmesh found. Add a Nav Mesh Bounds Volume to the map"));
+		return false;
+	}
+
+	GeneratedLinks.Reset();
+
+	GenerateHookLinks(World, NavSys, NavMesh, HookRange);
+
+	const int32 NumHookLinks = GeneratedLinks.Num();
+
+	GenerateDashLinks(World, NavSys, NavMesh, DashReach);
+
+	// spawn the link actors
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	for (const FGeneratedLink& Link : GeneratedLinks)
+	{
+		ATemporalDashTraversalLink* LinkActor = World->SpawnActor<ATemporalDashTraversalLink>(Link.Start, FRotator::ZeroRotator, SpawnParams);
+		LinkActor->SetupLink(Link.Type, Link.Start, Link.End, Link.HookPoint);
+
+#if WITH_EDITOR
+		LinkActor->SetFolderPath(FName("Navigation/TraversalLinks"));
+#endif
+	}
+
+	// bake the new links into the navmesh
+	BuildNavigation(World);
+
+	UE_LOG(LogTemporalDash, Display, TEXT("Removed %d old links. Generated %d hook links and %d dash links"), NumRemoved, NumHookLinks, GeneratedLinks.Num() - NumHookLinks);
+
+	return SaveWorld(World);
+}
+
+void UTemporalDashTraversalLinkCommandlet::GenerateDashLinks(UWorld* World, UNavigationSystemV1* NavSys, ARecastNavMesh* NavMesh, float DashReach)
+{
+	// search box for the dash landing, from the max drop below the start up to the max step up above it
+	const float LandingHalfHeight = (MaxDashDrop + MaxDashStepUp) * 0.5f;
+	const FVector LandingExtent(EdgeSampleSpacing * 0.5f, EdgeSampleSpacing * 0.5f, LandingHalfHeight);
+
+	TArray<FNavPoly> Polys;
+	TArray<FVector> Verts;
+
+	for (int32 TileIndex = 0; TileIndex < NavMesh->GetNavMeshTilesCount(); ++TileIndex)
+	{
+		Polys.Reset();
+		NavMesh->GetPolysInTile(TileIndex, Polys);
+
+		for (const FNavPoly& Poly : Polys)
+		{
+			Verts.Reset();
+			if (!NavMesh->GetPolyVerts(Poly.Ref, Verts) || Verts.Num() < 3)
+			{
+				continue;
+			}
+
+			// sample along each edge, dashing outwards. Inner edges get rejected by the detour check
+			for (int32 i = 0; i < Verts.Num(); ++i)
+			{
+				const FVector& EdgeStart = Verts[i];
+				const FVector& EdgeEnd = Verts[(i + 1) % Verts.Num()];
+
+				const FVector Edge = EdgeEnd - EdgeStart;
+				const float EdgeLength = Edge.Size2D();
+
+				if (EdgeLength < UE_KINDA_SMALL_NUMBER)
+				{
+					continue;
+				}
+
+				// horizontal edge normal, pointing out of the polygon
+				FVector Normal = FVector(Edge.Y, -Edge.X, 0.0f).GetSafeNormal();
+
+				if (FVector::DotProduct(Normal, (EdgeStart + EdgeEnd) * 0.5f - Poly.Center) < 0.0f)
+				{
+					Normal = -Normal;
+				}
+
+				const int32 NumSamples = FMath::Max(1, FMath::FloorToInt(EdgeLength / EdgeSampleSpacing));
+
+				for (int32 SampleIndex = 0; SampleIndex < NumSamples; ++SampleIndex)
+				{
+					const float SampleAlpha = (SampleIndex + 0.5f) / NumSamples;
+					const FVector Start = FMath::Lerp(EdgeStart, EdgeEnd, SampleAlpha) - Normal * EdgeSampleInset;
+
+					// find a landing spot at dash reach
+					const FVector LandingQuery = Start + Normal * DashReach + FVector(0.0f, 0.0f, MaxDashStepUp - LandingHalfHeight);
+
+					FNavLocation Landing;
+					if (!NavSys->ProjectPointToNavigation(LandingQuery, Landing, LandingExtent, NavMesh))
+					{
+						continue;
+					}
+
+					// dashes don't gain height
+					const float HeightDelta = Landing.Location.Z - Start.Z;
+
+					if (HeightDelta > MaxDashStepUp || HeightDelta < -MaxDashDrop)
+					{
+						continue;
+					}
+
+					// the dash is horizontal, so sweep at the higher of both ends
+					const float SweepZ = FMath::Max(Start.Z, Landing.Location.Z) + CapsuleHalfHeight + MaxDashStepUp;
+
+					if (!IsCapsuleSweepClear(World, FVector(Start.X, Start.Y, SweepZ), FVector(Landing.Location.X, Landing.Location.Y, SweepZ)))
+					{
+						continue;
+					}
+
+					if (IsDuplicateLink(ETemporalDashTraversalType::Dash, Start, Landing.Location))
+					{
+						continue;
+					}
+
+					// only worth a link if walking there is a detour. Pathfinding is the most expensive check, so run it last
+					if (!IsWalkDetour(World, NavSys, Start, Landing.Location))
+					{
+						continue;
+					}
+
+					GeneratedLinks.Add({ ETemporalDashTraversalType::Dash, Start, Landing.Location, FVector::ZeroVector });
+				}
+			}
+		}
+	}
+}
+
+void UTemporalDashTraversalLinkCommandlet::GenerateHookLinks(UWorld* World, UNavigationSystemV1* NavSys, ARecastNavMesh* NavMesh, float HookRange)
+{
+	TArray<FNavPoly> Polys;
+
+	for (TActorIterator<AHookableActor> It(World); It; ++It)
+	{
+		AHookableActor* Hookable = *It;
+
+		if (!Hookable->CanBeHooked())
+		{
+			continue;
+		}
+
+		const FVector HookPoint = Hookable->GetHookPoint();
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(TemporalDashHookLink), false, Hookable);
+
+		// find where we'll land after letting go of the hook
+		FHitResult FloorHit;
+		if (!World->LineTraceSingleByChannel(FloorHit, HookPoint, HookPoint - FVector(0.0f, 0.0f, MaxHookDrop), ECC_Visibility, QueryParams))
+		{
+			continue;
+		}
+
+		FNavLocation Landing;
+		if (!NavSys->ProjectPointToNavigation(FloorHit.ImpactPoint, Landing, FVector(CapsuleRadius * 4.0f, CapsuleRadius * 4.0f, 100.0f), NavMesh))
+		{
+			continue;
+		}
+
+		// gather the navmesh polygons in hook range as candidate starts, closest first
+		Polys.Reset();
+		NavMesh->GetPolysInBox(FBox(HookPoint - FVector(HookRange), HookPoint + FVector(HookRange)), Polys);
+
+		Polys.RemoveAll([&](const FNavPoly& Poly)
+		{
+			const FVector Eye = Poly.Center + FVector(0.0f, 0.0f, CapsuleHalfHeight + EyeHeight);
+			return FVector::Dist(Eye, HookPoint) > HookRange || FVector::Dist2D(Poly.Center, Landing.Location) < MinLinkSpacing;
+		});
+
+		Polys.Sort([&HookPoint](const FNavPoly& A, const FNavPoly& B)
+		{
+			return FVector::DistSquared(A.Center, HookPoint) < FVector::DistSquared(B.Center, HookPoint);
+		});
+
+		int32 NumPlaced = 0;
+
+		for (const FNavPoly& Poly : Polys)
+		{
+			if (NumPlaced >= MaxLinksPerHook)
+			{
+				break;
+			}
+
+			const FVector Start = Poly.Center;
+			const FVector CapsuleCenter = Start + FVector(0.0f, 0.0f, CapsuleHalfHeight);
+			const FVector Eye = CapsuleCenter + FVector(0.0f, 0.0f, EyeHeight);
+
+			// we need to see the hook point to fire at it
+			FHitResult SightHit;
+			if (World->LineTraceSingleByChannel(SightHit, Eye, HookPoint, ECC_Visibility, QueryParams))
+			{
+				continue;
+			}
+
+			// and the pull towards it must be clear
+			const FVector PullDir = (HookPoint - CapsuleCenter).GetSafeNormal();
+
+			if (!IsCapsuleSweepClear(World, CapsuleCenter, HookPoint - PullDir * (CapsuleHalfHeight + CapsuleRadius), Hookable))
+			{
+				continue;
+			}
+
+			if (IsDuplicateLink(ETemporalDashTraversalType::Hook, Start, Landing.Location))
+			{
+				continue;
+			}
+
+			// worth a link if it gets us up high, or if walking there is a detour
+			if (Landing.Location.Z - Start.Z < MinHookHeightGain && !IsWalkDetour(World, NavSys, Start, Landing.Location))
+			{
+				continue;
+			}
+
+			GeneratedLinks.Add({ ETemporalDashTraversalType::Hook, Start, Landing.Location, HookPoint });
+			++NumPlaced;
+		}
+	}
+}
+
+bool UTemporalDashTraversalLinkCommandlet::IsWalkDetour(UWorld* World, UNavigationSystemV1* NavSys, const FVector& Start, const FVector& End) const
+{
+	const ANavigationData* NavData = NavSys->GetDefaultNavDataInstance(FNavigationSystem::DontCreate);
+
+	FPathFindingQuery Query(nullptr, *NavData, Start, End);
+	const FPathFindingResult Result = NavSys->FindPathSync(Query);
+
+	// no full walking path at all
+	if (!Result.IsSuccessful() || Result.IsPartial() || !Result.Path.IsValid())
+	{
+		return true;
+	}
+
+	return Result.Path->GetLength() > DetourRatio * FVector::Dist(Start, End);
+}
+
+bool UTemporalDashTraversalLinkCommandlet::IsDuplicateLink(ETemporalDashTraversalType Type, const FVector& Start, const FVector& End) const
+{
+	const float SpacingSquared = FMath::Square(MinLinkSpacing);
+
+	return GeneratedLinks.ContainsByPredicate([&](const FGeneratedLink& Link)
+	{
+		return Link.Type == Type
+			&& FVector::DistSquared(Link.Start, Start) < SpacingSquared
+			&& FVector::DistSquared(Link.End, End) < SpacingSquared;
+	});
+}
+
+bool UTemporalDashTraversalLinkCommandlet::IsCapsuleSweepClear(UWorld* World, const FVector& From, const FVector& To, const AActor* IgnoredActor) const
+{
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(TemporalDashTraversalSweep), false, IgnoredActor);
+
+	return !World->SweepTestByChannel(From, To, FQuat::Identity, ECC_Pawn, FCollisionShape::MakeCapsule(CapsuleRadius, CapsuleHalfHeight), QueryParams);
+}
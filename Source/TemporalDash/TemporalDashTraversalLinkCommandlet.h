@@ -0,0 +1,104 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TemporalDashWorldCommandlet.h"
+#include "TemporalDashTraversalLink.h"
+#include "TemporalDashTraversalLinkCommandlet.generated.h"
+
+class ARecastNavMesh;
+class UNavigationSystemV1;
+class ATemporalDashCharacter;
+
+/**
+ *  Offline generator for dash and hook navigation links
+ *  Places hook links from walkable ground to the landing spot under each hookable actor,
+ *  and dash links across gaps that are within dash reach but would be a long walk around
+ *  Previously generated links are removed first, and the navigation is rebuilt with the new links before saving the map
+ *  Usage: UnrealEditor-Cmd.exe TemporalDash.uproject -run=TemporalDashTraversalLink -Map=/Game/Path/To/Map [-Character=/Game/Path/To/BP_NPC.BP_NPC_C]
+ */
+UCLASS()
+class TEMPORALDASH_API UTemporalDashTraversalLinkCommandlet : public UTemporalDashWorldCommandlet
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Fraction of the full dash reach used for links, to leave some margin for error */
+	float DashReachSafety = 0.85f;
+
+	/** Max height a dash can end above its start. Dashes don't gain height */
+	float MaxDashStepUp = 45.0f;
+
+	/** Max height a dash can end below its start */
+	float MaxDashDrop = 400.0f;
+
+	/** Spacing between dash samples along navmesh polygon edges */
+	float EdgeSampleSpacing = 150.0f;
+
+	/** Distance dash samples are moved into their polygon, so they start on the navmesh */
+	float EdgeSampleInset = 20.0f;
+
+	/** Fraction of the hook range used for links */
+	float HookRangeSafety = 0.9f;
+
+	/** Min height gain for a hook link to be worth it even if there's a walkable path */
+	float MinHookHeightGain = 250.0f;
+
+	/** Max drop from the hook point down to the landing spot */
+	float MaxHookDrop = 800.0f;
+
+	/** Max number of hook links placed per hookable actor */
+	int32 MaxLinksPerHook = 4;
+
+	/** Walking paths longer than this multiple of the straight distance make a link worth placing */
+	float DetourRatio = 2.5f;
+
+	/** Links with both endpoints this close to an existing link of the same type are skipped */
+	float MinLinkSpacing = 300.0f;
+
+	/** Capsule radius of the traversing character, read from the character defaults */
+	float CapsuleRadius = 34.0f;
+
+	/** Capsule half height of the traversing character, read from the character defaults */
+	float CapsuleHalfHeight = 96.0f;
+
+	/** Eye height above the capsule center, used for hook line of sight */
+	float EyeHeight = 64.0f;
+
+	/** Generated link endpoints */
+	struct FGeneratedLink
+	{
+		ETemporalDashTraversalType Type;
+		FVector Start;
+		FVector End;
+		FVector HookPoint;
+	};
+	TArray<FGeneratedLink> GeneratedLinks;
+
+public:
+
+	/** Constructor */
+	UTemporalDashTraversalLinkCommandlet();
+
+protected:
+
+	/** Generates the links for the loaded map */
+	virtual bool ProcessWorld(UWorld* World, const TMap<FString, FString>& ParamVals) override;
+
+	/** Places dash links across gaps along the navmesh polygon edges */
+	void GenerateDashLinks(UWorld* World, UNavigationSystemV1* NavSys, ARecastNavMesh* NavMesh, float DashReach);
+
+	/** Places hook links towards every hookable actor */
+	void GenerateHookLinks(UWorld* World, UNavigationSystemV1* NavSys, ARecastNavMesh* NavMesh, float HookRange);
+
+	/** Returns true if walking between the two navmesh points is missing or a long detour */
+	bool IsWalkDetour(UWorld* World, UNavigationSystemV1* NavSys, const FVector& Start, const FVector& End) const;
+
+	/** Returns true if a link of the same type already covers these endpoints */
+	bool IsDuplicateLink(ETemporalDashTraversalType Type, const FVector& Start, const FVector& End) const;
+
+	/** Returns true if a character capsule can sweep between the two capsule center locations */
+	bool IsCapsuleSweepClear(UWorld* World, const FVector& From, const FVector& To, const AActor* IgnoredActor = nullptr) const;
+};
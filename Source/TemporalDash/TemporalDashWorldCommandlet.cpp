@@ -0,0 +1,182 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "TemporalDashWorldCommandlet.h"
+#include "TemporalDash.h"
+#include "TemporalDashCharacter.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+#include "NavigationSystem.h"
+
+UTemporalDashWorldCommandlet::UTemporalDashWorldCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UTemporalDashWorldCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+
+	const FString MapName = ParamVals.FindRef(TEXT("Map"));
+
+	if (MapName.IsEmpty())
+	{
+		UE_LOG(LogTemporalDash, Error, TEXT("%s: missing -Map=/Game/Path/To/Map"), *GetClass()->GetName());
+		return 1;
+	}
+
+	// load the map package
+	FString MapPackageName;
+	if (!FPackageName::TryConvertFilenameToLongPackageName(MapName, MapPackageName))
+	{
+		MapPackageName = MapName;
+	}
+
+	UPackage* MapPackage = LoadPackage(nullptr, *MapPackageName, LOAD_None);
+	UWorld* World = MapPackage ? UWorld::FindWorldInPackage(MapPackage) : nullptr;
+
+	if (!World)
+	{
+		UE_LOG(LogTemporalDash, Error, TEXT("%s: couldn't load map '%s'"), *GetClass()->GetName(), *MapPackageName);
+		return 1;
+	}
+
+	// initialize the world so we can run collision and navigation queries on it
+	World->AddToRoot();
+	World->WorldType = EWorldType::Editor;
+
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Editor);
+	WorldContext.SetCurrentWorld(World);
+
+	if (!World->bIsWorldInitialized)
+	{
+		UWorld::InitializationValues InitValues;
+		InitValues.RequiresHitProxies(false)
+			.ShouldSimulatePhysics(false)
+			.EnableTraceCollision(true)
+			.CreateNavigation(true)
+			.CreateAISystem(false)
+			.AllowAudioPlayback(false)
+			.CreatePhysicsScene(true);
+
+		World->InitWorld(InitValues);
+	}
+
+	World->PersistentLevel->UpdateModelComponents();
+	World->UpdateWorldComponents(true, false);
+	World->FlushLevelStreaming(EFlushLevelStreamingType::Full);
+
+	FNavigationSystem::AddNavigationSystemToWorld(*World, FNavigationSystemRunMode::EditorMode);
+
+	if (bBuildNavigation)
+	{
+		BuildNavigation(World);
+	}
+
+	UE_LOG(LogTemporalDash, Display, TEXT("%s: processing '%s'"), *GetClass()->GetName(), *MapPackageName);
+
+	const bool bSuccess = ProcessWorld(World, ParamVals);
+
+	// tear the world down
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+
+	CollectGarbage(RF_NoFlags);
+
+	return bSuccess ? 0 : 1;
+#else
+	UE_LOG(LogTemporalDash, Error, TEXT("%s can only run in editor builds"), *GetClass()->GetName());
+	return 1;
+#endif
+}
+
+void UTemporalDashWorldCommandlet::BuildNavigation(UWorld* World)
+{
+	// Build waits for all navigation data to finish building
+	if (UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World))
+	{
+		NavSys->Build();
+	}
+}
+
+bool UTemporalDashWorldCommandlet::SaveWorld(UWorld* World)
+{
+	return SavePackage(World->GetOutermost(), World, FPackageName::GetMapPackageExtension());
+}
+
+bool UTemporalDashWorldCommandlet::SavePackage(UPackage* Package, UObject* Asset, const FString& Extension)
+{
+#if WITH_EDITOR
+	const FString Filename = FPackageName::LongPackageNameToFilename(Package->GetName(), Extension);
+
+	FSavePackageArgs SaveArgs;
+	SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+	SaveArgs.SaveFlags = SAVE_NoError;
+
+	if (!UPackage::SavePackage(Package, Asset, *Filename, SaveArgs))
+	{
+		UE_LOG(LogTemporalDash, Error, TEXT("Failed to save '%s'"), *Filename);
+		return false;
+	}
+
+	UE_LOG(LogTemporalDash, Display, TEXT("Saved '%s'"), *Filename);
+	return true;
+#else
+	return false;
+#endif
+}
+
+UObject* UTemporalDashWorldCommandlet::FindOrCreateMapAsset(UClass* AssetClass, const UWorld* World, FString (*GetPackageName)(const FString&))
+{
+	const FString PackageName = GetPackageName(World->GetOutermost()->GetName());
+	const FString AssetName = FPackageName::GetShortName(PackageName);
+
+	UPackage* Package = CreatePackage(*PackageName);
+	Package->FullyLoad();
+
+	// reuse the existing asset so references to it stay valid
+	UObject* Asset = StaticFindObject(AssetClass, Package, *AssetName);
+
+	if (!Asset)
+	{
+		Asset = NewObject<UObject>(Package, AssetClass, *AssetName, RF_Public | RF_Standalone);
+	}
+
+	return Asset;
+}
+
+bool UTemporalDashWorldCommandlet::SaveMapAsset(UObject* Asset)
+{
+	Asset->MarkPackageDirty();
+
+	return SavePackage(Asset->GetOutermost(), Asset, FPackageName::GetAssetPackageExtension());
+}
+
+const ATemporalDashCharacter* UTemporalDashWorldCommandlet::GetCharacterDefaults(const TMap<FString, FString>& ParamVals)
+{
+	if (const FString* CharacterClassName = ParamVals.Find(TEXT("Character")))
+	{
+		const UClass* CharacterClass = LoadObject<UClass>(nullptr, **CharacterClassName);
+
+		if (CharacterClass && CharacterClass->IsChildOf<ATemporalDashCharacter>())
+		{
+			return CharacterClass->GetDefaultObject<ATemporalDashCharacter>();
+		}
+
+		UE_LOG(LogTemporalDash, Warning, TEXT("'%s' is not a TemporalDash character class, using the native defaults"), **CharacterClassName);
+	}
+
+	return GetDefault<ATemporalDashCharacter>();
+}
@@ -0,0 +1,74 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "TemporalDashWorldCommandlet.generated.h"
+
+class UWorld;
+class UPackage;
+class ATemporalDashCharacter;
+
+/**
+ *  Base class for offline generators that process a single map
+ *  Loads the map passed with -Map=, initializes its world for collision and navigation queries and hands it to ProcessWorld
+ *  Usage: UnrealEditor-Cmd.exe TemporalDash.uproject -run=<CommandletName> -Map=/Game/Path/To/Map
+ */
+UCLASS(abstract)
+class TEMPORALDASH_API UTemporalDashWorldCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** If true, the navigation data is rebuilt after the world is loaded. Otherwise it's left as saved with the map */
+	bool bBuildNavigation = false;
+
+public:
+
+	/** Constructor */
+	UTemporalDashWorldCommandlet();
+
+	/** Commandlet entry point */
+	virtual int32 Main(const FString& Params) override;
+
+protected:
+
+	/**
+	 *  Runs the generator on the loaded world
+	 *  @param World initialized world for the map
+	 *  @param ParamVals key/value pairs passed on the command line
+	 *  @return true on success
+	 */
+	virtual bool ProcessWorld(UWorld* World, const TMap<FString, FString>& ParamVals) PURE_VIRTUAL(UTemporalDashWorldCommandlet::ProcessWorld, return false;);
+
+	/** Rebuilds all navigation data in the world and waits for it to complete */
+	static void BuildNavigation(UWorld* World);
+
+	/** Saves the world's map package */
+	static bool SaveWorld(UWorld* World);
+
+	/** Saves a package containing the passed asset */
+	static bool SavePackage(UPackage* Package, UObject* Asset, const FString& Extension);
+
+	/**
+	 *  Finds the asset baked for the world's map, or creates it if there isn't one yet
+	 *  @param World world the asset is baked for
+	 *  @param GetPackageName returns the asset package name for a map package name
+	 */
+	template<typename T>
+	static T* FindOrCreateMapAsset(const UWorld* World, FString (*GetPackageName)(const FString&))
+	{
+		return CastChecked<T>(FindOrCreateMapAsset(T::StaticClass(), World, GetPackageName));
+	}
+
+	/** Untyped version of FindOrCreateMapAsset. The asset is named after its package */
+	static UObject* FindOrCreateMapAsset(UClass* AssetClass, const UWorld* World, FString (*GetPackageName)(const FString&));
+
+	/** Saves an asset created with FindOrCreateMapAsset */
+	static bool SaveMapAsset(UObject* Asset);
+
+	/** Returns the defaults of the character class passed with -Character=, or the native character defaults if there's none or it isn't a TemporalDash character */
+	static const ATemporalDashCharacter* GetCharacterDefaults(const TMap<FString, FString>& ParamVals);
+};
@@ -0,0 +1,133 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Horror/AI/HorrorLightExposureCommandlet.h"
+#include "TemporalDash.h"
+#include "HorrorLightExposureGrid.h"
+#include "Components/LightComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Pawn.h"
+#include "NavigationSystem.h"
+#include "NavMesh/RecastNavMesh.h"
+#include "Async/ParallelFor.h"
+
+bool UHorrorLightExposureCommandlet::ProcessWorld(UWorld* World, const TMap<FString, FString>& ParamVals)
+{
+	// read the grid settings
+	if (const FString* Value = ParamVals.Find(TEXT("CellSize")))
+	{
+		CellSize = FMath::Max(25.0f, FCString::Atof(**Value));
+	}
+
+	if (const FString* Value = ParamVals.Find(TEXT("CellHeight")))
+	{
+		CellHeight = FMath::Max(25.0f, FCString::Atof(**Value));
+	}
+
+	// only the space the player can walk through matters, so bake over the navmesh
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World);
+	ARecastNavMesh* NavMesh = NavSys ? Cast<ARecastNavMesh>(NavSys->GetDefaultNavDataInstance(FNavigationSystem::DontCreate)) : nullptr;
+
+	if (!NavMesh)
+	{
+		UE_LOG(LogTemporalDash, Error, TEXT("No navmesh found. Add a Nav Mesh Bounds Volume to the map"));
+		return false;
+	}
+
+	const FBox Bounds = NavMesh->GetBounds();
+
+	if (!Bounds.IsValid)
+	{
+		UE_LOG(LogTemporalDash, Error, TEXT("The navmesh is empty"));
+		return false;
+	}
+
+	// collect the lights that don't move. Movable ones are evaluated at query time
+	TArray<FHorrorExposureLight> Lights;
+
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		TInlineComponentArray<ULightComponent*> LightComponents(*It);
+
+		for (const ULightComponent* LightComponent : LightComponents)
+		{
+			FHorrorExposureLight Light;
+
+			if (LightComponent->Mobility != EComponentMobility::Movable && FHorrorExposureLight::FromComponent(LightComponent, Light))
+			{
+				Lights.Add(Light);
+			}
+		}
+	}
+
+	// find or create the grid asset next to the map
+	UHorrorLightExposureGrid* Grid = FindOrCreateMapAsset<UHorrorLightExposureGrid>(World, &UHorrorLightExposureGrid::GetGridPackageName);
+
+	Grid->Origin = Bounds.Min;
+	Grid->CellSize = CellSize;
+	Grid->CellHeight = CellHeight;
+
+	const FVector Size = Bounds.GetSize();
+	Grid->Dimensions = FIntVector(
+		FMath::Max(1, FMath::CeilToInt(Size.X / CellSize)),
+		FMath::Max(1, FMath::CeilToInt(Size.Y / CellSize)),
+		FMath::Max(1, FMath::CeilToInt(Size.Z / CellHeight)));
+
+	const int64 NumVoxels = int64(Grid->Dimensions.X) * Grid->Dimensions.Y * Grid->Dimensions.Z;
+
+	if (NumVoxels > MaxVoxels)
+	{
+		UE_LOG(LogTemporalDash, Error, TEXT("%lld voxels is over the limit of %d. Use a larger -CellSize or -CellHeight"), NumVoxels, MaxVoxels);
+		return false;
+	}
+
+	UE_LOG(LogTemporalDash, Display, TEXT("Baking light exposure from %d lights into a %dx%dx%d grid"), Lights.Num(), Grid->Dimensions.X, Grid->Dimensions.Y, Grid->Dimensions.Z);
+
+	// pawns placed in the map shouldn't cast shadows into the grid
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(HorrorLightExposureBake), false);
+
+	for (TActorIterator<APawn> It(World); It; ++It)
+	{
+		QueryParams.AddIgnoredActor(*It);
+	}
+
+	// add up the occluded light at every voxel center. Voxels are independent, so spread them over the worker threads
+	TArray<float> Exposure;
+	Exposure.SetNumZeroed(NumVoxels);
+
+	const int32 LayerSize = Grid->Dimensions.X * Grid->Dimensions.Y;
+
+	ParallelFor(NumVoxels, [&](int32 Index)
+	{
+		const FIntVector Voxel(Index % Grid->Dimensions.X, (Index / Grid->Dimensions.X) % Grid->Dimensions.Y, Index / LayerSize);
+		const FVector Sample = Grid->GetVoxelCenter(Voxel);
+
+		float Total = 0.0f;
+		FHitResult Hit;
+
+		for (const FHorrorExposureLight& Light : Lights)
+		{
+			const float Contribution = Light.Evaluate(Sample);
+
+			if (Contribution <= 0.0f)
+			{
+				continue;
+			}
+
+			// is the light blocked? Stop a little short of it so the light's own fixture doesn't count
+			const FVector LightLocation = Light.bDirectional ? Sample - Light.Direction * DirectionalTraceDistance : Light.Location + (Sample - Light.Location).GetSafeNormal() * LightFixtureClearance;
+
+			if (!World->LineTraceSingleByChannel(Hit, Sample, LightLocation, ECC_Visibility, QueryParams))
+			{
+				Total += Contribution;
+			}
+		}
+
+		Exposure[Index] = Total;
+	});
+
+	Grid->SetBakedData(MoveTemp(Exposure));
+
+	return SaveMapAsset(Grid);
+}
@@ -0,0 +1,42 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TemporalDashWorldCommandlet.h"
+#include "HorrorLightExposureCommandlet.generated.h"
+
+/**
+ *  Offline generator for the horror light exposure grid
+ *  Voxelizes the navmesh bounds of the map and adds up the light arriving at each voxel center from every static and stationary light,
+ *  tracing towards each light that reaches the voxel so walls and props cast their shadows into the grid
+ *  Movable lights are left out, since they're evaluated at query time
+ *  Saves the result as a UHorrorLightExposureGrid asset next to the map, which the light exposure subsystem picks up at runtime
+ *  The grid isn't referenced by the map, so its folder needs to be always cooked for packaged builds
+ *  Usage: UnrealEditor-Cmd.exe TemporalDash.uproject -run=HorrorLightExposure -Map=/Game/Path/To/Map [-CellSize=200] [-CellHeight=100]
+ */
+UCLASS()
+class TEMPORALDASH_API UHorrorLightExposureCommandlet : public UTemporalDashWorldCommandlet
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Horizontal voxel size */
+	float CellSize = 200.0f;
+
+	/** Vertical voxel size */
+	float CellHeight = 100.0f;
+
+	/** Max number of voxels */
+	int32 MaxVoxels = 4000000;
+
+	/** Length of the shadow traces towards directional lights */
+	float DirectionalTraceDistance = 100000.0f;
+
+	/** Shadow traces stop this far from point and spot lights, so the light's own fixture doesn't block it */
+	float LightFixtureClearance = 30.0f;
+
+	/** Bakes the grid for the loaded map */
+	virtual bool ProcessWorld(UWorld* World, const TMap<FString, FString>& ParamVals) override;
+};
@@ -0,0 +1,119 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Horror/AI/HorrorLightExposureGrid.h"
+#include "Components/LightComponent.h"
+#include "Components/PointLightComponent.h"
+#include "Components/SpotLightComponent.h"
+#include "Components/DirectionalLightComponent.h"
+
+bool FHorrorExposureLight::FromComponent(const ULightComponent* Light, FHorrorExposureLight& OutLight)
+{
+	if (!Light || !Light->IsVisible() || !Light->bAffectsWorld)
+	{
+		return false;
+	}
+
+	OutLight = FHorrorExposureLight();
+	OutLight.Location = Light->GetComponentLocation();
+	OutLight.Direction = Light->GetDirection();
+	OutLight.Brightness = Light->ComputeLightBrightness();
+
+	if (OutLight.Brightness <= 0.0f)
+	{
+		return false;
+	}
+
+	if (Light->IsA<UDirectionalLightComponent>())
+	{
+		OutLight.bDirectional = true;
+		return true;
+	}
+
+	if (const UPointLightComponent* PointLight = Cast<UPointLightComponent>(Light))
+	{
+		OutLight.Radius = PointLight->AttenuationRadius;
+	}
+
+	if (const USpotLightComponent* SpotLight = Cast<USpotLightComponent>(Light))
+	{
+		const float OuterCone = FMath::Clamp(SpotLight->OuterConeAngle, 1.0f, 89.0f);
+		const float InnerCone = FMath::Clamp(SpotLight->InnerConeAngle, 0.0f, OuterCone - 0.5f);
+
+		OutLight.CosOuterCone = FMath::Cos(FMath::DegreesToRadians(OuterCone));
+		OutLight.CosInnerCone = FMath::Cos(FMath::DegreesToRadians(InnerCone));
+	}
+
+	return OutLight.Radius > 0.0f;
+}
+
+float FHorrorExposureLight::Evaluate(const FVector& SampleLocation) const
+{
+	// directional lights reach everywhere at full strength
+	if (bDirectional)
+	{
+		return Brightness;
+	}
+
+	const FVector ToSample = SampleLocation - Location;
+	const float DistanceSquared = ToSample.SizeSquared();
+	const float RadiusSquared = FMath::Square(Radius);
+
+	if (DistanceSquared >= RadiusSquared)
+	{
+		return 0.0f;
+	}
+
+	// windowed inverse square falloff, with distances in meters
+	const float Window = FMath::Square(1.0f - FMath::Square(DistanceSquared / RadiusSquared));
+	float Falloff = Window / (1.0f + DistanceSquared * 0.0001f);
+
+	// fade out towards the edge of the spot cone
+	if (CosOuterCone > -1.0f && DistanceSquared > UE_KINDA_SMALL_NUMBER)
+	{
+		const float CosAngle = FVector::DotProduct(ToSample * FMath::InvSqrt(DistanceSquared), Direction);
+		Falloff *= FMath::SmoothStep(CosOuterCone, CosInnerCone, CosAngle);
+	}
+
+	return Brightness * Falloff;
+}
+
+FString UHorrorLightExposureGrid::GetGridPackageName(const FString& MapPackageName)
+{
+	return MapPackageName + TEXT("_LightExposure");
+}
+
+int32 UHorrorLightExposureGrid::GetVoxelIndex(const FVector& Location) const
+{
+	const FVector Local = Location - Origin;
+
+	const int32 X = FMath::FloorToInt(Local.X / CellSize);
+	const int32 Y = FMath::FloorToInt(Local.Y / CellSize);
+	const int32 Z = FMath::FloorToInt(Local.Z / CellHeight);
+
+	if (X < 0 || Y < 0 || Z < 0 || X >= Dimensions.X || Y >= Dimensions.Y || Z >= Dimensions.Z)
+	{
+		return INDEX_NONE;
+	}
+
+	return (Z * Dimensions.Y + Y) * Dimensions.X + X;
+}
+
+FVector UHorrorLightExposureGrid::GetVoxelCenter(const FIntVector& Voxel) const
+{
+	return Origin + FVector((Voxel.X + 0.5f) * CellSize, (Voxel.Y + 0.5f) * CellSize, (Voxel.Z + 0.5f) * CellHeight);
+}
+
+float UHorrorLightExposureGrid::GetExposure(const FVector& Location) const
+{
+	const int32 Index = GetVoxelIndex(Location);
+
+	return Exposure.IsValidIndex(Index) ? Exposure[Index] : 0.0f;
+}
+
+void UHorrorLightExposureGrid::SetBakedData(TArray<float>&& InExposure)
+{
+	check(InExposure.Num() == Dimensions.X * Dimensions.Y * Dimensions.Z);
+
+	Exposure = MoveTemp(InExposure);
+}
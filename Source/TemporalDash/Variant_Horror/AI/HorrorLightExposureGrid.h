@@ -0,0 +1,82 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "HorrorLightExposureGrid.generated.h"
+
+class ULightComponent;
+
+/**
+ *  Simplified light model used for exposure, shared by the bake and the runtime queries so their values line up
+ *  Uses the renderer's windowed inverse square falloff with distances in meters, and a smooth spot cone edge
+ */
+struct FHorrorExposureLight
+{
+	FVector Location = FVector::ZeroVector;
+	FVector Direction = FVector::ForwardVector;
+	float Brightness = 0.0f;
+	float Radius = 0.0f;
+	float CosInnerCone = -1.0f;
+	float CosOuterCone = -1.0f;
+	bool bDirectional = false;
+
+	/** Reads a light component's current state. Returns false if it doesn't light anything */
+	static bool FromComponent(const ULightComponent* Light, FHorrorExposureLight& OutLight);
+
+	/** Returns the unoccluded light arriving at a location */
+	float Evaluate(const FVector& SampleLocation) const;
+};
+
+/**
+ *  Baked light exposure from the static and stationary lights in a map
+ *  The level is split into coarse voxels, each storing the occluded light arriving at its center
+ *  Generated per map by the HorrorLightExposure commandlet and saved next to it as <MapName>_LightExposure
+ */
+UCLASS()
+class TEMPORALDASH_API UHorrorLightExposureGrid : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	/** World location of the min corner of the voxel grid */
+	UPROPERTY(VisibleAnywhere, Category="Light Exposure")
+	FVector Origin = FVector::ZeroVector;
+
+	/** Horizontal voxel size */
+	UPROPERTY(VisibleAnywhere, Category="Light Exposure", meta = (Units = "cm"))
+	float CellSize = 200.0f;
+
+	/** Vertical voxel size */
+	UPROPERTY(VisibleAnywhere, Category="Light Exposure", meta = (Units = "cm"))
+	float CellHeight = 100.0f;
+
+	/** Number of voxels along each axis */
+	UPROPERTY(VisibleAnywhere, Category="Light Exposure")
+	FIntVector Dimensions = FIntVector::ZeroValue;
+
+protected:
+
+	/** Baked exposure for every voxel, X first */
+	UPROPERTY()
+	TArray<float> Exposure;
+
+public:
+
+	/** Returns the name of the grid package for the passed map package */
+	static FString GetGridPackageName(const FString& MapPackageName);
+
+	/** Returns the voxel index for a location, or INDEX_NONE if it's outside the grid */
+	int32 GetVoxelIndex(const FVector& Location) const;
+
+	/** Returns the center of a voxel */
+	FVector GetVoxelCenter(const FIntVector& Voxel) const;
+
+	/** Returns the baked exposure at a location. Zero outside the grid */
+	float GetExposure(const FVector& Location) const;
+
+	/** Replaces the baked data. Holds one value per voxel, X first */
+	void SetBakedData(TArray<float>&& InExposure);
+};
@@ -0,0 +1,86 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Horror/AI/HorrorLightExposureSubsystem.h"
+#include "TemporalDash.h"
+#include "HorrorLightExposureGrid.h"
+#include "Components/LightComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "TemporalDashMapAsset.h"
+
+DECLARE_CYCLE_STAT(TEXT("Light Exposure Queries"), STAT_HorrorLightExposure, STATGROUP_HorrorAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Light Exposure Query Count"), STAT_HorrorLightExposureQueries, STATGROUP_HorrorAI);
+
+void UHorrorLightExposureSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// the grid is saved next to the map by the light exposure commandlet
+	Grid = LoadMapSideCarAsset<UHorrorLightExposureGrid>(InWorld, &UHorrorLightExposureGrid::GetGridPackageName);
+
+	// the baked grid only has the lights that don't move, so pick up the rest
+	for (TActorIterator<AActor> It(&InWorld); It; ++It)
+	{
+		TInlineComponentArray<ULightComponent*> LightComponents(*It);
+
+		for (ULightComponent* LightComponent : LightComponents)
+		{
+			if (LightComponent->Mobility == EComponentMobility::Movable)
+			{
+				RegisterDynamicLight(LightComponent);
+			}
+		}
+	}
+}
+
+bool UHorrorLightExposureSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UHorrorLightExposureSubsystem::RegisterDynamicLight(ULightComponent* Light)
+{
+	if (IsValid(Light))
+	{
+		DynamicLights.AddUnique(Light);
+	}
+}
+
+void UHorrorLightExposureSubsystem::UnregisterDynamicLight(ULightComponent* Light)
+{
+	DynamicLights.RemoveSwap(Light);
+}
+
+float UHorrorLightExposureSubsystem::GetExposure(FVector Location, const AActor* Subject) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_HorrorLightExposure);
+	INC_DWORD_STAT(STAT_HorrorLightExposureQueries);
+
+	// start with the baked static lights
+	float Exposure = AmbientExposure + (Grid ? Grid->GetExposure(Location) : 0.0f);
+
+	// add the movable lights on top
+	for (const TWeakObjectPtr<ULightComponent>& WeakLight : DynamicLights)
+	{
+		const ULightComponent* LightComponent = WeakLight.Get();
+
+		FHorrorExposureLight Light;
+
+		if (!FHorrorExposureLight::FromComponent(LightComponent, Light))
+		{
+			continue;
+		}
+
+		// a carried light points away from its holder, but still makes them easy to spot
+		if (Subject && LightComponent->GetOwner() == Subject)
+		{
+			Exposure += Light.Brightness * CarriedLightScale;
+			continue;
+		}
+
+		Exposure += Light.Evaluate(Location);
+	}
+
+	return Exposure;
+}
@@ -0,0 +1,61 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HorrorLightExposureSubsystem.generated.h"
+
+class UHorrorLightExposureGrid;
+class ULightComponent;
+
+/**
+ *  Answers "how lit is this spot?" queries for the horror stealth AI
+ *  Static and stationary lights come from the map's baked exposure grid, including their shadows
+ *  Movable lights, like the player's flashlight, are added analytically on top without shadows
+ *  Maps without a grid only get the movable lights and the ambient exposure
+ */
+UCLASS(config=Game)
+class TEMPORALDASH_API UHorrorLightExposureSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Exposure everywhere, on top of the lights. Stands in for sky and bounce light */
+	UPROPERTY(config, EditAnywhere, Category="Light Exposure", meta = (ClampMin = 0))
+	float AmbientExposure = 0.0f;
+
+	/** Fraction of a carried light's brightness added to its holder's exposure while it's on. A lit flashlight gives its holder away */
+	UPROPERTY(config, EditAnywhere, Category="Light Exposure", meta = (ClampMin = 0, ClampMax = 1))
+	float CarriedLightScale = 0.25f;
+
+	/** Baked exposure grid for the map, if one was generated */
+	UPROPERTY(Transient)
+	TObjectPtr<UHorrorLightExposureGrid> Grid;
+
+	/** Movable lights evaluated at query time */
+	TArray<TWeakObjectPtr<ULightComponent>> DynamicLights;
+
+public:
+
+	/** Loads the exposure grid for the map and collects its movable lights */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Only game worlds run AI */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Adds a movable light to the query time lights */
+	void RegisterDynamicLight(ULightComponent* Light);
+
+	/** Removes a movable light from the query time lights */
+	void UnregisterDynamicLight(ULightComponent* Light);
+
+	/**
+	 *  Returns how much light reaches a location
+	 *  @param Location location to check
+	 *  @param Subject actor at the location, if any. Lights it carries count towards its exposure
+	 */
+	UFUNCTION(BlueprintCallable, Category="Light Exposure")
+	float GetExposure(FVector Location, const AActor* Subject = nullptr) const;
+};
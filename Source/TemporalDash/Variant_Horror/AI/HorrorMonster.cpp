@@ -0,0 +1,30 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Horror/AI/HorrorMonster.h"
+#include "HorrorMonsterController.h"
+#include "GameFramework/CharacterMovementComponent.h"
+
+AHorrorMonster::AHorrorMonster()
+{
+	// run the monster behavior on both placed and spawned monsters
+	AIControllerClass = AHorrorMonsterController::StaticClass();
+	AutoPossessAI = EAutoPossessAI::PlacedInWorldOrSpawned;
+
+	// turn towards where we're walking
+	bUseControllerRotationYaw = false;
+	GetCharacterMovement()->bOrientRotationToMovement = true;
+	GetCharacterMovement()->RotationRate = FRotator(0.0f, 360.0f, 0.0f);
+	GetCharacterMovement()->MaxWalkSpeed = WanderSpeed;
+}
+
+void AHorrorMonster::SetMoveSpeed(float Speed)
+{
+	GetCharacterMovement()->MaxWalkSpeed = Speed;
+}
+
+void AHorrorMonster::CatchPlayer(APawn* Player)
+{
+	// let Blueprint handle the game over
+	OnPlayerCaught.Broadcast(Player);
+}
@@ -0,0 +1,71 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Character.h"
+#include "HorrorMonster.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FHorrorPlayerCaughtDelegate, APawn*, Player);
+
+/**
+ *  Monster that hunts the player in the horror game
+ *  Listens for the player's noises through the level's sound propagation graph and chases the player on sight
+ *  Its behavior is run by a HorrorMonsterController
+ */
+UCLASS(abstract)
+class TEMPORALDASH_API AHorrorMonster : public ACharacter
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Scale for the distance noises carry to this monster */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Hearing", meta = (ClampMin = 0))
+	float HearingSensitivity = 1.0f;
+
+	/** Max distance the monster can see a fully lit player from */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Sight", meta = (ClampMin = 0, Units = "cm"))
+	float SightRange = 1500.0f;
+
+	/** Max distance the monster can see the player from in complete darkness */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Sight", meta = (ClampMin = 0, Units = "cm"))
+	float DarkSightRange = 300.0f;
+
+	/** Light exposure at which the player counts as fully lit. Sight range scales between the dark and lit ranges below it */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Sight", meta = (ClampMin = 0.01))
+	float LitExposure = 10.0f;
+
+	/** Half angle of the monster's view cone */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Sight", meta = (ClampMin = 0, ClampMax = 180, Units = "Degrees"))
+	float SightHalfAngle = 60.0f;
+
+	/** Walk speed while wandering around */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Movement", meta = (ClampMin = 0, Units = "cm/s"))
+	float WanderSpeed = 150.0f;
+
+	/** Walk speed while going to check a noise */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Movement", meta = (ClampMin = 0, Units = "cm/s"))
+	float InvestigateSpeed = 300.0f;
+
+	/** Walk speed while chasing the player */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Movement", meta = (ClampMin = 0, Units = "cm/s"))
+	float ChaseSpeed = 550.0f;
+
+	/** The player is caught when the monster gets this close */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Chase", meta = (ClampMin = 0, Units = "cm"))
+	float CatchRadius = 120.0f;
+
+	/** Delegate called when the monster catches the player */
+	UPROPERTY(BlueprintAssignable, Category="Chase")
+	FHorrorPlayerCaughtDelegate OnPlayerCaught;
+
+	/** Constructor */
+	AHorrorMonster();
+
+	/** Sets the walk speed */
+	void SetMoveSpeed(float Speed);
+
+	/** Called by the controller when the monster reaches the player */
+	void CatchPlayer(APawn* Player);
+};
@@ -0,0 +1,220 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Horror/AI/HorrorMonsterController.h"
+#include "HorrorMonster.h"
+#include "HorrorNoiseSubsystem.h"
+#include "HorrorLightExposureSubsystem.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "NavigationSystem.h"
+#include "Navigation/PathFollowingComponent.h"
+
+void AHorrorMonsterController::OnPossess(APawn* InPawn)
+{
+	Super::OnPossess(InPawn);
+
+	// only listen for noises made from now on
+	LastHearingTime = GetWorld()->GetTimeSeconds();
+
+	SetState(EHorrorMonsterState::Wandering);
+
+	// start thinking
+	GetWorld()->GetTimerManager().SetTimer(ThinkTimer, this, &AHorrorMonsterController::Think, ThinkInterval, true, FMath::FRand() * ThinkInterval);
+}
+
+void AHorrorMonsterController::OnUnPossess()
+{
+	Super::OnUnPossess();
+
+	// stop thinking
+	GetWorld()->GetTimerManager().ClearTimer(ThinkTimer);
+}
+
+void AHorrorMonsterController::OnMoveCompleted(FAIRequestID RequestID, const FPathFollowingResult& Result)
+{
+	Super::OnMoveCompleted(RequestID, Result);
+
+	// replaced by another move, which will finish on its own
+	if (Result.HasFlag(FPathFollowingResultFlags::NewRequest))
+	{
+		return;
+	}
+
+	// nothing at the noise, so go back to wandering after a look around
+	if (State == EHorrorMonsterState::Investigating)
+	{
+		SetState(EHorrorMonsterState::Wandering);
+	}
+
+	NextWanderTime = GetWorld()->GetTimeSeconds() + WanderWaitTime;
+}
+
+void AHorrorMonsterController::Think()
+{
+	AHorrorMonster* Monster = Cast<AHorrorMonster>(GetPawn());
+
+	if (!Monster)
+	{
+		return;
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	APawn* Player = UGameplayStatics::GetPlayerPawn(this, 0);
+
+	// chase the player as soon as we see them, unless we just caught them
+	if (Player && Now >= NextChaseTime && CanSeePlayer(Monster, Player))
+	{
+		Target = Player;
+		LastSeenLocation = Player->GetActorLocation();
+		LastSeenTime = Now;
+
+		if (State != EHorrorMonsterState::Chasing)
+		{
+			SetState(EHorrorMonsterState::Chasing);
+			MoveToActor(Player, Monster->CatchRadius * 0.5f);
+		}
+	}
+
+	if (State == EHorrorMonsterState::Chasing)
+	{
+		APawn* ChasedPlayer = Target.Get();
+
+		// did we get them?
+		if (ChasedPlayer && FVector::Dist(ChasedPlayer->GetActorLocation(), Monster->GetActorLocation()) <= Monster->CatchRadius)
+		{
+			StopMovement();
+			SetState(EHorrorMonsterState::Wandering);
+			NextWanderTime = Now + WanderWaitTime;
+
+			// the player is likely still right in front of us, so don't catch them again on the next think
+			NextChaseTime = Now + CatchCooldown;
+
+			Monster->CatchPlayer(ChasedPlayer);
+			return;
+		}
+
+		// lost them, so check where we saw them last
+		if (!ChasedPlayer || Now - LastSeenTime > LoseSightTime)
+		{
+			Target = nullptr;
+			Investigate(LastSeenLocation);
+			return;
+		}
+
+		// the chase move ended without catching them, e.g. it failed or got aborted, so pick it back up
+		if (GetMoveStatus() == EPathFollowingStatus::Idle)
+		{
+			MoveToActor(ChasedPlayer, Monster->CatchRadius * 0.5f);
+		}
+
+		return;
+	}
+
+	// listen for anything made since the last check
+	if (const UHorrorNoiseSubsystem* Noise = GetWorld()->GetSubsystem<UHorrorNoiseSubsystem>())
+	{
+		FHorrorNoise HeardNoise;
+
+		if (Noise->HearNoise(Monster->GetPawnViewLocation(), Monster->HearingSensitivity, LastHearingTime, HeardNoise) && HeardNoise.Instigator != Monster)
+		{
+			Investigate(HeardNoise.Location);
+		}
+	}
+
+	LastHearingTime = Now;
+
+	// wander around when there's nothing else to do
+	if (State == EHorrorMonsterState::Wandering && GetMoveStatus() == EPathFollowingStatus::Idle && Now >= NextWanderTime)
+	{
+		Wander();
+	}
+}
+
+bool AHorrorMonsterController::CanSeePlayer(const AHorrorMonster* Monster, const APawn* Player) const
+{
+	const FVector EyeLocation = Monster->GetPawnViewLocation();
+	const FVector ToPlayer = Player->GetActorLocation() - EyeLocation;
+
+	// the better lit the player is, the further away we can see them from
+	float SightRange = Monster->SightRange;
+
+	if (const UHorrorLightExposureSubsystem* LightExposure = GetWorld()->GetSubsystem<UHorrorLightExposureSubsystem>())
+	{
+		const float LitAlpha = FMath::Clamp(LightExposure->GetExposure(Player->GetActorLocation(), Player) / Monster->LitExposure, 0.0f, 1.0f);
+		SightRange = FMath::Lerp(Monster->DarkSightRange, Monster->SightRange, LitAlpha);
+	}
+
+	// in range?
+	if (ToPlayer.SizeSquared() > FMath::Square(SightRange))
+	{
+		return false;
+	}
+
+	// inside the view cone?
+	if (FVector::DotProduct(ToPlayer.GetSafeNormal(), Monster->GetActorForwardVector()) < FMath::Cos(FMath::DegreesToRadians(Monster->SightHalfAngle)))
+	{
+		return false;
+	}
+
+	// anything in the way?
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(HorrorMonsterSight), false, Monster);
+	QueryParams.AddIgnoredActor(Player);
+
+	FHitResult Hit;
+	return !GetWorld()->LineTraceSingleByChannel(Hit, EyeLocation, Player->GetActorLocation(), ECC_Visibility, QueryParams);
+}
+
+void AHorrorMonsterController::SetState(EHorrorMonsterState NewState)
+{
+	State = NewState;
+
+	if (AHorrorMonster* Monster = Cast<AHorrorMonster>(GetPawn()))
+	{
+		switch (State)
+		{
+		case EHorrorMonsterState::Investigating:
+			Monster->SetMoveSpeed(Monster->InvestigateSpeed);
+			break;
+
+		case EHorrorMonsterState::Chasing:
+			Monster->SetMoveSpeed(Monster->ChaseSpeed);
+			break;
+
+		default:
+			Monster->SetMoveSpeed(Monster->WanderSpeed);
+			break;
+		}
+	}
+}
+
+void AHorrorMonsterController::Investigate(const FVector& Location)
+{
+	SetState(EHorrorMonsterState::Investigating);
+
+	// give up if we can't get there
+	if (MoveToLocation(Location) == EPathFollowingRequestResult::Failed)
+	{
+		SetState(EHorrorMonsterState::Wandering);
+		NextWanderTime = GetWorld()->GetTimeSeconds() + WanderWaitTime;
+	}
+}
+
+void AHorrorMonsterController::Wander()
+{
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+
+	FNavLocation Destination;
+
+	if (NavSys && NavSys->GetRandomReachablePointInRadius(GetPawn()->GetActorLocation(), WanderRadius, Destination))
+	{
+		MoveToLocation(Destination.Location);
+
+	} else {
+
+		// try again later
+		NextWanderTime = GetWorld()->GetTimeSeconds() + WanderWaitTime;
+	}
+}
@@ -0,0 +1,107 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIController.h"
+#include "HorrorMonsterController.generated.h"
+
+class AHorrorMonster;
+
+/** What the monster is currently doing */
+UENUM(BlueprintType)
+enum class EHorrorMonsterState : uint8
+{
+	/** Roaming around with nothing to go on */
+	Wandering,
+
+	/** Going to check where a noise came from */
+	Investigating,
+
+	/** Going after the player it can see */
+	Chasing
+};
+
+/**
+ *  AI Controller for the horror monster
+ *  Wanders around until it hears the player, investigates noises and chases the player on sight
+ *  Thinks at a fixed interval instead of every frame
+ */
+UCLASS()
+class TEMPORALDASH_API AHorrorMonsterController : public AAIController
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Time between behavior updates */
+	UPROPERTY(EditAnywhere, Category="Horror", meta = (ClampMin = 0.05, Units = "s"))
+	float ThinkInterval = 0.2f;
+
+	/** Max distance from the monster to pick wander destinations */
+	UPROPERTY(EditAnywhere, Category="Horror", meta = (ClampMin = 0, Units = "cm"))
+	float WanderRadius = 1500.0f;
+
+	/** Time to wait after reaching a destination before wandering again */
+	UPROPERTY(EditAnywhere, Category="Horror", meta = (ClampMin = 0, Units = "s"))
+	float WanderWaitTime = 2.0f;
+
+	/** Time the player can be out of sight before the monster goes to investigate where it saw them last */
+	UPROPERTY(EditAnywhere, Category="Horror", meta = (ClampMin = 0, Units = "s"))
+	float LoseSightTime = 1.5f;
+
+	/** Time after catching the player before the monster can start chasing them again on sight */
+	UPROPERTY(EditAnywhere, Category="Horror", meta = (ClampMin = 0, Units = "s"))
+	float CatchCooldown = 3.0f;
+
+	/** Current behavior */
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category="Horror")
+	EHorrorMonsterState State = EHorrorMonsterState::Wandering;
+
+	/** Player being chased */
+	TWeakObjectPtr<APawn> Target;
+
+	/** Where the player was last seen */
+	FVector LastSeenLocation = FVector::ZeroVector;
+
+	/** World time the player was last seen */
+	double LastSeenTime = 0.0;
+
+	/** World time of the last hearing check. Only noises made after it are considered */
+	double LastHearingTime = 0.0;
+
+	/** World time to start wandering again */
+	double NextWanderTime = 0.0;
+
+	/** World time the player can be chased on sight again after being caught */
+	double NextChaseTime = 0.0;
+
+	/** Behavior update timer */
+	FTimerHandle ThinkTimer;
+
+protected:
+
+	/** Pawn initialization */
+	virtual void OnPossess(APawn* InPawn) override;
+
+	/** Pawn cleanup */
+	virtual void OnUnPossess() override;
+
+	/** Wait a bit before moving on after reaching a destination */
+	virtual void OnMoveCompleted(FAIRequestID RequestID, const FPathFollowingResult& Result) override;
+
+	/** Updates the behavior */
+	void Think();
+
+	/** Returns true if the monster can see the player */
+	bool CanSeePlayer(const AHorrorMonster* Monster, const APawn* Player) const;
+
+	/** Switches behavior and sets the matching walk speed */
+	void SetState(EHorrorMonsterState NewState);
+
+	/** Goes to check a location */
+	void Investigate(const FVector& Location);
+
+	/** Walks to a random reachable location nearby */
+	void Wander();
+};
@@ -0,0 +1,106 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Horror/AI/HorrorNoiseSubsystem.h"
+#include "TemporalDash.h"
+#include "HorrorSoundGraph.h"
+#include "Engine/World.h"
+#include "TemporalDashMapAsset.h"
+
+DECLARE_CYCLE_STAT(TEXT("Hearing Checks"), STAT_HorrorHearing, STATGROUP_HorrorAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Noises Heard"), STAT_HorrorNoisesHeard, STATGROUP_HorrorAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Active Noises"), STAT_HorrorActiveNoises, STATGROUP_HorrorAI);
+
+void UHorrorNoiseSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// the graph is saved next to the map by the sound graph commandlet
+	Graph = LoadMapSideCarAsset<UHorrorSoundGraph>(InWorld, &UHorrorSoundGraph::GetGraphPackageName);
+
+	Noises.Reset();
+}
+
+bool UHorrorNoiseSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UHorrorNoiseSubsystem::ReportNoise(AActor* Instigator, FVector Location, float Loudness)
+{
+	if (Loudness <= 0.0f)
+	{
+		return;
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	// drop noises nobody can hear anymore. They're in time order, so they're all at the front
+	const int32 NumExpired = Noises.IndexOfByPredicate([Now, this](const FHorrorNoise& Noise) { return Now - Noise.Time <= NoiseLifetime; });
+	Noises.RemoveAt(0, NumExpired == INDEX_NONE ? Noises.Num() : NumExpired, EAllowShrinking::No);
+
+	FHorrorNoise& Noise = Noises.AddDefaulted_GetRef();
+	Noise.Instigator = Instigator;
+	Noise.Location = Location;
+	Noise.Loudness = Loudness;
+	Noise.Time = Now;
+
+	SET_DWORD_STAT(STAT_HorrorActiveNoises, Noises.Num());
+}
+
+bool UHorrorNoiseSubsystem::HearNoise(const FVector& ListenerLocation, float Sensitivity, double SinceTime, FHorrorNoise& OutNoise) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_HorrorHearing);
+
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	float BestMargin = 0.0f;
+	bool bHeard = false;
+
+	for (const FHorrorNoise& Noise : Noises)
+	{
+		if (Noise.Time <= SinceTime || Now - Noise.Time > NoiseLifetime)
+		{
+			continue;
+		}
+
+		// how far does this noise carry for this listener?
+		const float Range = Noise.Loudness * Sensitivity;
+		const float Distance = GetPropagationDistance(Noise.Location, ListenerLocation, Range);
+
+		if (Distance == MAX_flt)
+		{
+			continue;
+		}
+
+		// prefer the noise that's the most over the hearing threshold
+		const float Margin = Range - Distance;
+
+		if (!bHeard || Margin > BestMargin)
+		{
+			OutNoise = Noise;
+			BestMargin = Margin;
+			bHeard = true;
+		}
+	}
+
+	if (bHeard)
+	{
+		INC_DWORD_STAT(STAT_HorrorNoisesHeard);
+	}
+
+	return bHeard;
+}
+
+float UHorrorNoiseSubsystem::GetPropagationDistance(const FVector& From, const FVector& To, float MaxDistance) const
+{
+	// follow the rooms and portals if we have a graph
+	if (Graph)
+	{
+		return Graph->GetPropagationDistance(From, To, MaxDistance);
+	}
+
+	const float Distance = FVector::Dist(From, To);
+
+	return Distance <= MaxDistance ? Distance : MAX_flt;
+}
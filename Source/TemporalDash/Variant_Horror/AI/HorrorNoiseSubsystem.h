@@ -0,0 +1,79 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HorrorNoiseSubsystem.generated.h"
+
+class UHorrorSoundGraph;
+
+/** A noise made in the level */
+struct FHorrorNoise
+{
+	/** Actor that made the noise */
+	TWeakObjectPtr<AActor> Instigator;
+
+	/** Where the noise was made */
+	FVector Location = FVector::ZeroVector;
+
+	/** Max distance the noise carries */
+	float Loudness = 0.0f;
+
+	/** World time the noise was made */
+	double Time = 0.0;
+};
+
+/**
+ *  Collects the noises made in the horror level and answers hearing checks for the monsters
+ *  Hearing goes through the map's baked sound propagation graph, so sound bends around corners and through doors
+ *  and is muffled by walls without any traces. Maps without a graph fall back to straight line distances
+ */
+UCLASS(config=Game)
+class TEMPORALDASH_API UHorrorNoiseSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Time a noise can still be heard after it was made */
+	UPROPERTY(config, EditAnywhere, Category="Noise", meta = (ClampMin = 0, Units = "s"))
+	float NoiseLifetime = 1.0f;
+
+	/** Recent noises, oldest first */
+	TArray<FHorrorNoise> Noises;
+
+	/** Baked sound propagation graph for the map, if one was generated */
+	UPROPERTY(Transient)
+	TObjectPtr<UHorrorSoundGraph> Graph;
+
+public:
+
+	/** Loads the sound graph for the map */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Only game worlds run AI */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/**
+	 *  Makes a noise the monsters can hear
+	 *  @param Instigator actor that made the noise
+	 *  @param Location where the noise was made
+	 *  @param Loudness max distance the noise carries
+	 */
+	UFUNCTION(BlueprintCallable, Category="Noise")
+	void ReportNoise(AActor* Instigator, FVector Location, float Loudness);
+
+	/**
+	 *  Finds the most audible noise made since the passed time
+	 *  @param ListenerLocation where the listener's ears are
+	 *  @param Sensitivity scale for the distance noises carry to this listener
+	 *  @param SinceTime only noises made after this world time are considered
+	 *  @param OutNoise the noise that was heard
+	 *  @return true if a noise was heard
+	 */
+	bool HearNoise(const FVector& ListenerLocation, float Sensitivity, double SinceTime, FHorrorNoise& OutNoise) const;
+
+	/** Returns the distance sound travels between two locations, or MAX_flt if it doesn't carry that far */
+	float GetPropagationDistance(const FVector& From, const FVector& To, float MaxDistance) const;
+};
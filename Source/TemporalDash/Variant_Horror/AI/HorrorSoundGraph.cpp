@@ -0,0 +1,106 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Horror/AI/HorrorSoundGraph.h"
+
+FString UHorrorSoundGraph::GetGraphPackageName(const FString& MapPackageName)
+{
+	return MapPackageName + TEXT("_SoundGraph");
+}
+
+int32 UHorrorSoundGraph::FindRoom(const FVector& Location) const
+{
+	for (int32 Room = 0; Room < Rooms.Num(); ++Room)
+	{
+		if (Rooms[Room].IsInsideOrOn(Location))
+		{
+			return Room;
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+float UHorrorSoundGraph::GetPropagationDistance(const FVector& From, const FVector& To, float MaxDistance) const
+{
+	// sound never gets there faster than in a straight line
+	const float StraightDistance = FVector::Dist(From, To);
+
+	if (StraightDistance > MaxDistance)
+	{
+		return MAX_flt;
+	}
+
+	const int32 FromRoom = FindRoom(From);
+	const int32 ToRoom = FindRoom(To);
+
+	// same room, or not covered by the graph
+	if (FromRoom == INDEX_NONE || ToRoom == INDEX_NONE || FromRoom == ToRoom)
+	{
+		return StraightDistance;
+	}
+
+	const int32 NumPortals = Portals.Num();
+	float BestDistance = MAX_flt;
+
+	// try every way out of the source room against every way into the listener's room
+	for (const int32 FromPortal : GetRoomPortals(FromRoom))
+	{
+		const FHorrorSoundGraphPortal& Exit = Portals[FromPortal];
+		const float ExitDistance = FVector::Dist(From, Exit.Location) + Exit.Attenuation;
+
+		if (ExitDistance >= BestDistance || ExitDistance > MaxDistance)
+		{
+			continue;
+		}
+
+		const float* Row = PortalDistances.GetData() + int64(FromPortal) * NumPortals;
+
+		for (const int32 ToPortal : GetRoomPortals(ToRoom))
+		{
+			if (Row[ToPortal] == MAX_flt)
+			{
+				continue;
+			}
+
+			BestDistance = FMath::Min(BestDistance, ExitDistance + Row[ToPortal] + FVector::Dist(Portals[ToPortal].Location, To));
+		}
+	}
+
+	return BestDistance <= MaxDistance ? BestDistance : MAX_flt;
+}
+
+void UHorrorSoundGraph::SetBakedData(TArray<FBox>&& InRooms, TArray<FHorrorSoundGraphPortal>&& InPortals, TArray<float>&& InPortalDistances)
+{
+	check(InPortalDistances.Num() == InPortals.Num() * InPortals.Num());
+
+	Rooms = MoveTemp(InRooms);
+	Portals = MoveTemp(InPortals);
+	PortalDistances = MoveTemp(InPortalDistances);
+
+	// pack the portals of each room so lookups don't have to scan every portal
+	TArray<TArray<int32>> PortalsPerRoom;
+	PortalsPerRoom.SetNum(Rooms.Num());
+
+	for (int32 Portal = 0; Portal < Portals.Num(); ++Portal)
+	{
+		PortalsPerRoom[Portals[Portal].RoomA].Add(Portal);
+		PortalsPerRoom[Portals[Portal].RoomB].Add(Portal);
+	}
+
+	RoomPortalOffsets.Reset(Rooms.Num() + 1);
+	RoomPortals.Reset(Portals.Num() * 2);
+
+	for (const TArray<int32>& RoomPortalList : PortalsPerRoom)
+	{
+		RoomPortalOffsets.Add(RoomPortals.Num());
+		RoomPortals.Append(RoomPortalList);
+	}
+
+	RoomPortalOffsets.Add(RoomPortals.Num());
+}
+
+TConstArrayView<int32> UHorrorSoundGraph::GetRoomPortals(int32 Room) const
+{
+	return TConstArrayView<int32>(RoomPortals.GetData() + RoomPortalOffsets[Room], RoomPortalOffsets[Room + 1] - RoomPortalOffsets[Room]);
+}
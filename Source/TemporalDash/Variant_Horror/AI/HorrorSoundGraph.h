@@ -0,0 +1,94 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "HorrorSoundGraph.generated.h"
+
+/** A baked sound portal between two rooms */
+USTRUCT()
+struct FHorrorSoundGraphPortal
+{
+	GENERATED_BODY()
+
+	/** Center of the portal */
+	UPROPERTY(VisibleAnywhere, Category="Sound Graph")
+	FVector Location = FVector::ZeroVector;
+
+	/** Rooms connected by the portal */
+	UPROPERTY(VisibleAnywhere, Category="Sound Graph")
+	int32 RoomA = INDEX_NONE;
+
+	UPROPERTY(VisibleAnywhere, Category="Sound Graph")
+	int32 RoomB = INDEX_NONE;
+
+	/** Extra distance added by going through the portal */
+	UPROPERTY(VisibleAnywhere, Category="Sound Graph", meta = (Units = "cm"))
+	float Attenuation = 0.0f;
+};
+
+/**
+ *  Baked sound propagation graph
+ *  The level is split into rooms connected by portals. Sound inside a room travels in a straight line,
+ *  and sound between rooms follows the shortest chain of portals, including each portal's attenuation
+ *  The shortest distance between every pair of portals is baked, so a hearing check only needs to try
+ *  the portals of the two rooms involved instead of tracing through the level
+ *  Generated per map by the HorrorSoundGraph commandlet and saved next to it as <MapName>_SoundGraph
+ */
+UCLASS()
+class TEMPORALDASH_API UHorrorSoundGraph : public UDataAsset
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Room bounds. A room's index in this array is its id in the graph */
+	UPROPERTY(VisibleAnywhere, Category="Sound Graph")
+	TArray<FBox> Rooms;
+
+	/** Portals between rooms */
+	UPROPERTY(VisibleAnywhere, Category="Sound Graph")
+	TArray<FHorrorSoundGraphPortal> Portals;
+
+	/** Start of each room's portal list in RoomPortals. Has one extra entry at the end */
+	UPROPERTY()
+	TArray<int32> RoomPortalOffsets;
+
+	/** Portal indices for each room, packed */
+	UPROPERTY()
+	TArray<int32> RoomPortals;
+
+	/**
+	 *  Shortest distance from each portal to each other portal, row major
+	 *  Includes the attenuation of every portal along the way except the first. MAX_flt if unreachable
+	 */
+	UPROPERTY()
+	TArray<float> PortalDistances;
+
+public:
+
+	/** Returns the name of the graph package for the passed map package */
+	static FString GetGraphPackageName(const FString& MapPackageName);
+
+	/** Returns the number of rooms */
+	int32 GetNumRooms() const { return Rooms.Num(); };
+
+	/** Returns the number of portals */
+	int32 GetNumPortals() const { return Portals.Num(); };
+
+	/** Returns the room containing the location, or INDEX_NONE if it's outside every room */
+	int32 FindRoom(const FVector& Location) const;
+
+	/**
+	 *  Returns the distance sound travels between two locations, or MAX_flt if it can't get there within MaxDistance
+	 *  Locations outside every room fall back to the straight line distance
+	 */
+	float GetPropagationDistance(const FVector& From, const FVector& To, float MaxDistance) const;
+
+	/** Replaces the baked data. Distances are for every portal pair, row major */
+	void SetBakedData(TArray<FBox>&& InRooms, TArray<FHorrorSoundGraphPortal>&& InPortals, TArray<float>&& InPortalDistances);
+
+	/** Returns the portals of a room */
+	TConstArrayView<int32> GetRoomPortals(int32 Room) const;
+};
@@ -0,0 +1,146 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Horror/AI/HorrorSoundGraphCommandlet.h"
+#include "TemporalDash.h"
+#include "HorrorSoundGraph.h"
+#include "HorrorSoundRoom.h"
+#include "HorrorSoundPortal.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Async/ParallelFor.h"
+
+bool UHorrorSoundGraphCommandlet::ProcessWorld(UWorld* World, const TMap<FString, FString>& ParamVals)
+{
+	// collect the rooms
+	TArray<FBox> Rooms;
+
+	for (TActorIterator<AHorrorSoundRoom> It(World); It; ++It)
+	{
+		Rooms.Add(It->GetRoomBounds());
+	}
+
+	if (Rooms.IsEmpty())
+	{
+		UE_LOG(LogTemporalDash, Error, TEXT("No sound rooms found. Add Horror Sound Room actors to the map"));
+		return false;
+	}
+
+	// connect each portal to the rooms it overlaps
+	TArray<FHorrorSoundGraphPortal> Portals;
+
+	for (TActorIterator<AHorrorSoundPortal> It(World); It; ++It)
+	{
+		const FBox PortalBounds = It->GetPortalBounds();
+
+		TArray<int32, TInlineAllocator<4>> PortalRooms;
+
+		for (int32 Room = 0; Room < Rooms.Num(); ++Room)
+		{
+			if (Rooms[Room].Intersect(PortalBounds))
+			{
+				PortalRooms.Add(Room);
+			}
+		}
+
+		if (PortalRooms.Num() != 2)
+		{
+			UE_LOG(LogTemporalDash, Warning, TEXT("Sound portal '%s' overlaps %d rooms instead of 2 and will be skipped"), *It->GetActorNameOrLabel(), PortalRooms.Num());
+			continue;
+		}
+
+		FHorrorSoundGraphPortal& Portal = Portals.AddDefaulted_GetRef();
+		Portal.Location = PortalBounds.GetCenter();
+		Portal.RoomA = PortalRooms[0];
+		Portal.RoomB = PortalRooms[1];
+		Portal.Attenuation = It->Attenuation;
+	}
+
+	const int32 NumPortals = Portals.Num();
+
+	if (NumPortals > MaxPortals)
+	{
+		UE_LOG(LogTemporalDash, Error, TEXT("%d sound portals is over the limit of %d. Merge some rooms"), NumPortals, MaxPortals);
+		return false;
+	}
+
+	UE_LOG(LogTemporalDash, Display, TEXT("Baking sound propagation for %d rooms and %d portals"), Rooms.Num(), NumPortals);
+
+	// portals that share a room are connected. Going from one to the other adds the distance between them and the attenuation of the second
+	TArray<TArray<int32>> PortalsPerRoom;
+	PortalsPerRoom.SetNum(Rooms.Num());
+
+	for (int32 Portal = 0; Portal < NumPortals; ++Portal)
+	{
+		PortalsPerRoom[Portals[Portal].RoomA].Add(Portal);
+		PortalsPerRoom[Portals[Portal].RoomB].Add(Portal);
+	}
+
+	// run a shortest path search from every portal. Rows are independent, so spread them over the worker threads
+	TArray<float> PortalDistances;
+	PortalDistances.Init(MAX_flt, NumPortals * NumPortals);
+
+	ParallelFor(NumPortals, [&](int32 Source)
+	{
+		float* Row = PortalDistances.GetData() + int64(Source) * NumPortals;
+		Row[Source] = 0.0f;
+
+		struct FOpenPortal
+		{
+			int32 Portal;
+			float Distance;
+
+			bool operator<(const FOpenPortal& Other) const { return Distance < Other.Distance; }
+		};
+
+		TArray<FOpenPortal> Open;
+		Open.HeapPush({ Source, 0.0f });
+
+		while (!Open.IsEmpty())
+		{
+			FOpenPortal Current;
+			Open.HeapPop(Current, EAllowShrinking::No);
+
+			// skip stale entries
+			if (Current.Distance > Row[Current.Portal])
+			{
+				continue;
+			}
+
+			const FHorrorSoundGraphPortal& CurrentPortal = Portals[Current.Portal];
+
+			for (const int32 Room : { CurrentPortal.RoomA, CurrentPortal.RoomB })
+			{
+				for (const int32 Next : PortalsPerRoom[Room])
+				{
+					const float Distance = Current.Distance + FVector::Dist(CurrentPortal.Location, Portals[Next].Location) + Portals[Next].Attenuation;
+
+					if (Distance < Row[Next])
+					{
+						Row[Next] = Distance;
+						Open.HeapPush({ Next, Distance });
+					}
+				}
+			}
+		}
+	});
+
+	// report disconnected parts of the level, since sound will never cross between them
+	int64 NumUnreachable = 0;
+
+	for (const float Distance : PortalDistances)
+	{
+		NumUnreachable += Distance == MAX_flt ? 1 : 0;
+	}
+
+	if (NumUnreachable > 0)
+	{
+		UE_LOG(LogTemporalDash, Warning, TEXT("%lld of %lld portal pairs are unreachable from each other"), NumUnreachable, int64(NumPortals) * NumPortals);
+	}
+
+	// find or create the graph asset next to the map
+	UHorrorSoundGraph* Graph = FindOrCreateMapAsset<UHorrorSoundGraph>(World, &UHorrorSoundGraph::GetGraphPackageName);
+	Graph->SetBakedData(MoveTemp(Rooms), MoveTemp(Portals), MoveTemp(PortalDistances));
+
+	return SaveMapAsset(Graph);
+}
@@ -0,0 +1,29 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TemporalDashWorldCommandlet.h"
+#include "HorrorSoundGraphCommandlet.generated.h"
+
+/**
+ *  Offline generator for the horror sound propagation graph
+ *  Collects the sound rooms and portals placed in the map, connects each portal to the two rooms it overlaps,
+ *  and bakes the shortest sound distance between every pair of portals
+ *  Saves the result as a UHorrorSoundGraph asset next to the map, which the noise subsystem picks up at runtime
+ *  The graph isn't referenced by the map, so its folder needs to be always cooked for packaged builds
+ *  Usage: UnrealEditor-Cmd.exe TemporalDash.uproject -run=HorrorSoundGraph -Map=/Game/Path/To/Map
+ */
+UCLASS()
+class TEMPORALDASH_API UHorrorSoundGraphCommandlet : public UTemporalDashWorldCommandlet
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Max number of portals. The distance table grows with the square of the portal count */
+	int32 MaxPortals = 2048;
+
+	/** Bakes the graph for the loaded map */
+	virtual bool ProcessWorld(UWorld* World, const TMap<FString, FString>& ParamVals) override;
+};
@@ -0,0 +1,28 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Horror/AI/HorrorSoundPortal.h"
+#include "Components/BoxComponent.h"
+
+AHorrorSoundPortal::AHorrorSoundPortal()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	// the bounds are only markup, so they don't need any collision
+	Bounds = CreateDefaultSubobject<UBoxComponent>(TEXT("Bounds"));
+	SetRootComponent(Bounds);
+
+	Bounds->SetBoxExtent(FVector(50.0f, 100.0f, 120.0f));
+	Bounds->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Bounds->SetCanEverAffectNavigation(false);
+	Bounds->ShapeColor = FColor::Orange;
+
+	// markup only, so leave it out of cooked builds
+	SetActorHiddenInGame(true);
+	bIsEditorOnlyActor = true;
+}
+
+FBox AHorrorSoundPortal::GetPortalBounds() const
+{
+	return Bounds->Bounds.GetBox();
+}
@@ -0,0 +1,36 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "HorrorSoundPortal.generated.h"
+
+class UBoxComponent;
+
+/**
+ *  Marks an opening sound can travel through between two rooms, such as a doorway, a vent or a thin wall
+ *  Connects the two sound rooms its bounds overlap
+ *  Only used by the sound graph commandlet. The baked graph is what the monsters listen through at runtime
+ */
+UCLASS()
+class TEMPORALDASH_API AHorrorSoundPortal : public AActor
+{
+	GENERATED_BODY()
+
+	/** Portal bounds */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
+	UBoxComponent* Bounds;
+
+public:
+
+	/** Extra distance sound travelling through this portal is treated as covering. Use it to muffle doors and walls */
+	UPROPERTY(EditAnywhere, Category="Sound", meta = (ClampMin = 0, Units = "cm"))
+	float Attenuation = 0.0f;
+
+	/** Constructor */
+	AHorrorSoundPortal();
+
+	/** Returns the world space bounds of the portal */
+	FBox GetPortalBounds() const;
+};
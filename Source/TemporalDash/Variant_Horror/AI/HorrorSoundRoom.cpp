@@ -0,0 +1,28 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Horror/AI/HorrorSoundRoom.h"
+#include "Components/BoxComponent.h"
+
+AHorrorSoundRoom::AHorrorSoundRoom()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	// the bounds are only markup, so they don't need any collision
+	Bounds = CreateDefaultSubobject<UBoxComponent>(TEXT("Bounds"));
+	SetRootComponent(Bounds);
+
+	Bounds->SetBoxExtent(FVector(500.0f, 500.0f, 200.0f));
+	Bounds->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Bounds->SetCanEverAffectNavigation(false);
+	Bounds->ShapeColor = FColor::Cyan;
+
+	// markup only, so leave it out of cooked builds
+	SetActorHiddenInGame(true);
+	bIsEditorOnlyActor = true;
+}
+
+FBox AHorrorSoundRoom::GetRoomBounds() const
+{
+	return Bounds->Bounds.GetBox();
+}
@@ -0,0 +1,32 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "HorrorSoundRoom.generated.h"
+
+class UBoxComponent;
+
+/**
+ *  Marks a room for sound propagation
+ *  Sound travels freely inside a room and only reaches other rooms through the portals between them
+ *  Only used by the sound graph commandlet. The baked graph is what the monsters listen through at runtime
+ */
+UCLASS()
+class TEMPORALDASH_API AHorrorSoundRoom : public AActor
+{
+	GENERATED_BODY()
+
+	/** Room bounds */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Components", meta = (AllowPrivateAccess = "true"))
+	UBoxComponent* Bounds;
+
+public:
+
+	/** Constructor */
+	AHorrorSoundRoom();
+
+	/** Returns the world space bounds of the room */
+	FBox GetRoomBounds() const;
+};
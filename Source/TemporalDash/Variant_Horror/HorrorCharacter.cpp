@@ -9,6 +9,8 @@
 #include "Components/SpotLightComponent.h"
 #include "EnhancedInputComponent.h"
 #include "InputAction.h"
+#include "HorrorNoiseSubsystem.h"
+#include "HorrorLightExposureSubsystem.h"
 
 AHorrorCharacter::AHorrorCharacter()
 {
@@ -34,6 +36,16 @@ void AHorrorCharacter::BeginPlay()
 	// Initialize the walk speed
 	GetCharacterMovement()->MaxWalkSpeed = WalkSpeed;
 
+	// let the sprint state drive how loud our footsteps are
+	NoiseLoudness = WalkNoiseLoudness;
+	OnSprintStateChanged.AddDynamic(this, &AHorrorCharacter::OnSprintNoiseChanged);
+
+	// our flashlight counts towards how lit we and our surroundings are
+	if (UHorrorLightExposureSubsystem* LightExposure = GetWorld()->GetSubsystem<UHorrorLightExposureSubsystem>())
+	{
+		LightExposure->RegisterDynamicLight(SpotLight);
+	}
+
 	// start the sprint tick timer
 	GetWorld()->GetTimerManager().SetTimer(SprintTimer, this, &AHorrorCharacter::SprintFixedTick, SprintFixedTickTime, true);
 }
@@ -44,6 +56,12 @@ void AHorrorCharacter::EndPlay(EEndPlayReason::Type EndPlayReason)
 
 	// clear the sprint timer
 	GetWorld()->GetTimerManager().ClearTimer(SprintTimer);
+
+	// remove our flashlight from the light exposure queries
+	if (UHorrorLightExposureSubsystem* LightExposure = GetWorld()->GetSubsystem<UHorrorLightExposureSubsystem>())
+	{
+		LightExposure->UnregisterDynamicLight(SpotLight);
+	}
 }
 
 void AHorrorCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -140,4 +158,35 @@ void AHorrorCharacter::SprintFixedTick()
 	// broadcast the sprint meter updated delegate
 	OnSprintMeterUpdated.Broadcast(SprintMeter / SprintTime);
 
+	// make noise as we move
+	UpdateFootsteps(SprintFixedTickTime);
+}
+
+void AHorrorCharacter::OnSprintNoiseChanged(bool bNewSprinting)
+{
+	NoiseLoudness = bNewSprinting ? SprintNoiseLoudness : WalkNoiseLoudness;
+}
+
+void AHorrorCharacter::UpdateFootsteps(float DeltaTime)
+{
+	// only count steps on the ground
+	if (!GetCharacterMovement()->IsMovingOnGround())
+	{
+		return;
+	}
+
+	FootstepTravel += GetVelocity().Size2D() * DeltaTime;
+
+	if (FootstepTravel < FootstepDistance)
+	{
+		return;
+	}
+
+	FootstepTravel = 0.0f;
+
+	// recovering slows us down to a quiet walk, even with the sprint button held
+	if (UHorrorNoiseSubsystem* Noise = GetWorld()->GetSubsystem<UHorrorNoiseSubsystem>())
+	{
+		Noise->ReportNoise(this, GetActorLocation(), bRecovering ? WalkNoiseLoudness : NoiseLoudness);
+	}
 }
@@ -67,6 +67,24 @@ protected:
 	/** Sprint tick timer */
 	FTimerHandle SprintTimer;
 
+	/** Distance our footsteps carry while walking or recovering */
+	UPROPERTY(EditAnywhere, Category="Noise", meta = (ClampMin = 0, Units = "cm"))
+	float WalkNoiseLoudness = 500.0f;
+
+	/** Distance our footsteps carry while sprinting */
+	UPROPERTY(EditAnywhere, Category="Noise", meta = (ClampMin = 0, Units = "cm"))
+	float SprintNoiseLoudness = 1800.0f;
+
+	/** Distance travelled on the ground between footstep noises */
+	UPROPERTY(EditAnywhere, Category="Noise", meta = (ClampMin = 1, Units = "cm"))
+	float FootstepDistance = 150.0f;
+
+	/** Distance our footsteps currently carry. Driven by the sprint state */
+	float NoiseLoudness = 0.0f;
+
+	/** Distance travelled since the last footstep noise */
+	float FootstepTravel = 0.0f;
+
 public:
 
 	/** Delegate called when the sprint meter should be updated */
@@ -101,4 +119,11 @@ protected:
 
 	/** Called while sprinting at a fixed time interval */
 	void SprintFixedTick();
+
+	/** Updates our noise level when we start and stop sprinting */
+	UFUNCTION()
+	void OnSprintNoiseChanged(bool bNewSprinting);
+
+	/** Makes footstep noises for the monsters to hear as we move */
+	void UpdateFootsteps(float DeltaTime);
 };
@@ -0,0 +1,93 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/AI/EnvQueryGenerator_ShooterCoverPoints.h"
+#include "TemporalDash.h"
+#include "EnvironmentQuery/Contexts/EnvQueryContext_Querier.h"
+#include "EnvironmentQuery/Items/EnvQueryItemType_Point.h"
+#include "ShooterCoverSubsystem.h"
+#include "ShooterCoverPointSet.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Algo/Unique.h"
+
+DECLARE_CYCLE_STAT(TEXT("Cover Point Generator"), STAT_ShooterCoverGenerator, STATGROUP_ShooterAI);
+
+#define LOCTEXT_NAMESPACE "EnvQueryGenerator"
+
+UEnvQueryGenerator_ShooterCoverPoints::UEnvQueryGenerator_ShooterCoverPoints(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	ItemType = UEnvQueryItemType_Point::StaticClass();
+	GenerateAround = UEnvQueryContext_Querier::StaticClass();
+	SearchRadius.DefaultValue = 1500.0f;
+	OnlyFullHeight.DefaultValue = false;
+}
+
+void UEnvQueryGenerator_ShooterCoverPoints::GenerateItems(FEnvQueryInstance& QueryInstance) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShooterCoverGenerator);
+
+	UObject* QueryOwner = QueryInstance.Owner.Get();
+	UWorld* World = GEngine->GetWorldFromContextObject(QueryOwner, EGetWorldErrorMode::LogAndReturnNull);
+
+	if (!World)
+	{
+		return;
+	}
+
+	const UShooterCoverSubsystem* CoverSubsystem = World->GetSubsystem<UShooterCoverSubsystem>();
+	const UShooterCoverPointSet* CoverPoints = CoverSubsystem ? CoverSubsystem->GetCoverPoints() : nullptr;
+
+	if (!CoverPoints)
+	{
+		return;
+	}
+
+	SearchRadius.BindData(QueryOwner, QueryInstance.QueryID);
+	OnlyFullHeight.BindData(QueryOwner, QueryInstance.QueryID);
+
+	const float Radius = SearchRadius.GetValue();
+	const bool bOnlyFullHeight = OnlyFullHeight.GetValue();
+
+	TArray<FVector> ContextLocations;
+	QueryInstance.PrepareContext(GenerateAround, ContextLocations);
+
+	TArray<int32> PointIndices;
+
+	for (const FVector& ContextLocation : ContextLocations)
+	{
+		CoverPoints->GetPointsInRadius(ContextLocation, Radius, PointIndices);
+	}
+
+	// several contexts may overlap the same points
+	if (ContextLocations.Num() > 1)
+	{
+		PointIndices.Sort();
+		PointIndices.SetNum(Algo::Unique(PointIndices));
+	}
+
+	const TArray<FShooterCoverPoint>& Points = CoverPoints->GetPoints();
+
+	for (const int32 PointIndex : PointIndices)
+	{
+		if (bOnlyFullHeight && !Points[PointIndex].bFullHeight)
+		{
+			continue;
+		}
+
+		QueryInstance.AddItemData<UEnvQueryItemType_Point>(Points[PointIndex].Location);
+	}
+}
+
+FText UEnvQueryGenerator_ShooterCoverPoints::GetDescriptionTitle() const
+{
+	return FText::Format(LOCTEXT("ShooterCoverPointsDescriptionTitle", "Cover Points around {0}"), UEnvQueryTypes::DescribeContext(GenerateAround));
+}
+
+FText UEnvQueryGenerator_ShooterCoverPoints::GetDescriptionDetails() const
+{
+	return FText::Format(LOCTEXT("ShooterCoverPointsDescriptionDetails", "radius: {0}"), FText::FromString(SearchRadius.ToString()));
+}
+
+#undef LOCTEXT_NAMESPACE
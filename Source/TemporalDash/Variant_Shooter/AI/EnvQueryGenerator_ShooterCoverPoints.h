@@ -0,0 +1,46 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EnvironmentQuery/EnvQueryGenerator.h"
+#include "DataProviders/AIDataProvider.h"
+#include "EnvQueryGenerator_ShooterCoverPoints.generated.h"
+
+/**
+ *  Custom EnvQuery Generator that returns the baked cover points around a context
+ *  Only looks up the spatial hash cells within the search radius instead of generating and projecting a grid of points
+ */
+UCLASS(meta = (DisplayName = "Shooter Cover Points"))
+class TEMPORALDASH_API UEnvQueryGenerator_ShooterCoverPoints : public UEnvQueryGenerator
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Context to search around */
+	UPROPERTY(EditDefaultsOnly, Category="Generator")
+	TSubclassOf<UEnvQueryContext> GenerateAround;
+
+	/** Max distance from the context to the cover points */
+	UPROPERTY(EditDefaultsOnly, Category="Generator")
+	FAIDataProviderFloatValue SearchRadius;
+
+	/** If true, only full height cover is returned */
+	UPROPERTY(EditDefaultsOnly, Category="Generator")
+	FAIDataProviderBoolValue OnlyFullHeight;
+
+public:
+
+	/** Constructor */
+	UEnvQueryGenerator_ShooterCoverPoints(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	/** Adds the cover points around the context to the query */
+	virtual void GenerateItems(FEnvQueryInstance& QueryInstance) const override;
+
+	/** Returns the title for the generator in the EQS editor */
+	virtual FText GetDescriptionTitle() const override;
+
+	/** Returns the details for the generator in the EQS editor */
+	virtual FText GetDescriptionDetails() const override;
+};
@@ -0,0 +1,88 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/AI/EnvQueryTest_ShooterCoverProtection.h"
+#include "TemporalDash.h"
+#include "EnvironmentQuery/Contexts/EnvQueryContext_Querier.h"
+#include "EnvironmentQuery/Items/EnvQueryItemType_VectorBase.h"
+#include "EnvQueryContext_Target.h"
+#include "ShooterCoverSubsystem.h"
+#include "ShooterCoverPointSet.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Cover Protection Test"), STAT_ShooterCoverProtectionTest, STATGROUP_ShooterAI);
+
+#define LOCTEXT_NAMESPACE "EnvQueryTest"
+
+UEnvQueryTest_ShooterCoverProtection::UEnvQueryTest_ShooterCoverProtection(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	// lookups only, no traces or pathfinding
+	Cost = EEnvTestCost::Low;
+	ValidItemType = UEnvQueryItemType_VectorBase::StaticClass();
+	SetWorkOnFloatValues(true);
+
+	Threat = UEnvQueryContext_Target::StaticClass();
+}
+
+void UEnvQueryTest_ShooterCoverProtection::RunTest(FEnvQueryInstance& QueryInstance) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShooterCoverProtectionTest);
+
+	UObject* QueryOwner = QueryInstance.Owner.Get();
+	UWorld* World = GEngine->GetWorldFromContextObject(QueryOwner, EGetWorldErrorMode::LogAndReturnNull);
+
+	if (!World)
+	{
+		return;
+	}
+
+	FloatValueMin.BindData(QueryOwner, QueryInstance.QueryID);
+	FloatValueMax.BindData(QueryOwner, QueryInstance.QueryID);
+
+	const float MinThresholdValue = FloatValueMin.GetValue();
+	const float MaxThresholdValue = FloatValueMax.GetValue();
+
+	TArray<FVector> ThreatLocations;
+	if (!QueryInstance.PrepareContext(Threat, ThreatLocations))
+	{
+		return;
+	}
+
+	const UShooterCoverSubsystem* CoverSubsystem = World->GetSubsystem<UShooterCoverSubsystem>();
+	const UShooterCoverPointSet* CoverPoints = CoverSubsystem ? CoverSubsystem->GetCoverPoints() : nullptr;
+
+	for (FEnvQueryInstance::ItemIterator It(this, QueryInstance); It; ++It)
+	{
+		const FVector ItemLocation = GetItemLocation(QueryInstance, It.GetIndex());
+
+		// find the cover point for this item in its hash cell
+		const int32 PointIndex = CoverPoints ? CoverPoints->FindPoint(ItemLocation, PointTolerance) : INDEX_NONE;
+
+		for (const FVector& ThreatLocation : ThreatLocations)
+		{
+			float Protection = -1.0f;
+
+			if (PointIndex != INDEX_NONE)
+			{
+				const FVector ThreatDirection = (ThreatLocation - ItemLocation).GetSafeNormal2D();
+				Protection = FVector::DotProduct(CoverPoints->GetPoints()[PointIndex].CoverDirection, ThreatDirection);
+			}
+
+			It.SetScore(TestPurpose, FilterType, Protection, MinThresholdValue, MaxThresholdValue);
+		}
+	}
+}
+
+FText UEnvQueryTest_ShooterCoverProtection::GetDescriptionTitle() const
+{
+	return FText::Format(LOCTEXT("ShooterCoverProtectionDescriptionTitle", "{0}: from {1}"), Super::GetDescriptionTitle(), UEnvQueryTypes::DescribeContext(Threat));
+}
+
+FText UEnvQueryTest_ShooterCoverProtection::GetDescriptionDetails() const
+{
+	return DescribeFloatTestParams();
+}
+
+#undef LOCTEXT_NAMESPACE
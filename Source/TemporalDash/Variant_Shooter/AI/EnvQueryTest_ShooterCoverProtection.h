@@ -0,0 +1,43 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EnvironmentQuery/EnvQueryTest.h"
+#include "EnvQueryTest_ShooterCoverProtection.generated.h"
+
+/**
+ *  Custom EnvQuery Test that scores baked cover points by how well they face away from a threat
+ *  Uses the precomputed cover direction of each point, so no traces are needed
+ *  Scores range from -1 when the threat is behind the cover to 1 when the cover faces the threat directly
+ *  Items that aren't baked cover points score -1
+ */
+UCLASS(meta = (DisplayName = "Shooter Cover Protection"))
+class TEMPORALDASH_API UEnvQueryTest_ShooterCoverProtection : public UEnvQueryTest
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Context to take cover from */
+	UPROPERTY(EditDefaultsOnly, Category="Cover")
+	TSubclassOf<UEnvQueryContext> Threat;
+
+	/** Max distance between an item and a cover point for the item to use it */
+	UPROPERTY(EditDefaultsOnly, Category="Cover", meta = (ClampMin = 0, Units = "cm"))
+	float PointTolerance = 10.0f;
+
+public:
+
+	/** Constructor */
+	UEnvQueryTest_ShooterCoverProtection(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	/** Scores the items against the threat */
+	virtual void RunTest(FEnvQueryInstance& QueryInstance) const override;
+
+	/** Returns the title for the test in the EQS editor */
+	virtual FText GetDescriptionTitle() const override;
+
+	/** Returns the details for the test in the EQS editor */
+	virtual FText GetDescriptionDetails() const override;
+};
@@ -3,12 +3,25 @@
 
 #include "Variant_Shooter/AI/ShooterAIController.h"
 #include "ShooterNPC.h"
+#include "ShooterSignificanceSubsystem.h"
+#include "ShooterSquadSubsystem.h"
+#include "ShooterQueryCacheSubsystem.h"
+#include "ShooterSensingSubsystem.h"
+#include "ShooterNPCPoolSubsystem.h"
+#include "ShooterCrowdSubsystem.h"
+#include "ShooterPathRequestSubsystem.h"
 #include "Components/StateTreeAIComponent.h"
 #include "Perception/AIPerceptionComponent.h"
+#include "Perception/AISense_Sight.h"
 #include "Navigation/PathFollowingComponent.h"
+#include "Navigation/CrowdFollowingComponent.h"
 #include "AI/Navigation/PathFollowingAgentInterface.h"
+#include "TemporalDash.h"
 
-AShooterAIController::AShooterAIController()
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Perception Events Dropped"), STAT_ShooterPerceptionEventsDropped, STATGROUP_ShooterAI);
+
+AShooterAIController::AShooterAIController(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<UCrowdFollowingComponent>(TEXT("PathFollowingComponent")))
 {
 	// create the StateTree component
 	StateTreeAI = CreateDefaultSubobject<UStateTreeAIComponent>(TEXT("StateTreeAI"));
@@ -33,6 +46,72 @@ void AShooterAIController::OnPossess(APawn* InPawn)
 
 		// subscribe to the pawn's OnDeath delegate
 		NPC->OnPawnDeath.AddDynamic(this, &AShooterAIController::OnPawnDeath);
+
+		// register with the AI subsystems
+		JoinSubsystems();
+	}
+}
+
+void AShooterAIController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Super::EndPlay(EndPlayReason);
+
+	LeaveSubsystems();
+}
+
+void AShooterAIController::JoinSubsystems()
+{
+	// join our team's squad to share sightings
+	if (UShooterSquadSubsystem* Squad = GetWorld()->GetSubsystem<UShooterSquadSubsystem>())
+	{
+		Squad->RegisterMember(this, TeamTag);
+	}
+
+	// join the sensing pre-pass and make sure our StateTree reads this frame's results
+	if (UShooterSensingSubsystem* Sensing = GetWorld()->GetSubsystem<UShooterSensingSubsystem>())
+	{
+		Sensing->RegisterController(this);
+		StateTreeAI->PrimaryComponentTick.AddPrerequisite(Sensing, Sensing->GetTickFunction());
+	}
+
+	// avoid the other NPCs while following paths
+	if (UShooterCrowdSubsystem* Crowd = GetWorld()->GetSubsystem<UShooterCrowdSubsystem>())
+	{
+		Crowd->RegisterController(this);
+	}
+}
+
+void AShooterAIController::LeaveSubsystems()
+{
+	// leave the squad
+	if (UShooterSquadSubsystem* Squad = GetWorld()->GetSubsystem<UShooterSquadSubsystem>())
+	{
+		Squad->UnregisterMember(this, TeamTag);
+	}
+
+	// free up any location we claimed
+	if (UShooterQueryCacheSubsystem* QueryCache = GetWorld()->GetSubsystem<UShooterQueryCacheSubsystem>())
+	{
+		QueryCache->ReleaseReservation(this);
+	}
+
+	// leave the sensing pre-pass
+	if (UShooterSensingSubsystem* Sensing = GetWorld()->GetSubsystem<UShooterSensingSubsystem>())
+	{
+		Sensing->UnregisterController(this);
+		StateTreeAI->PrimaryComponentTick.RemovePrerequisite(Sensing, Sensing->GetTickFunction());
+	}
+
+	// leave the crowd
+	if (UShooterCrowdSubsystem* Crowd = GetWorld()->GetSubsystem<UShooterCrowdSubsystem>())
+	{
+		Crowd->UnregisterController(this);
+	}
+
+	// drop any path we were waiting on
+	if (UShooterPathRequestSubsystem* PathRequests = GetWorld()->GetSubsystem<UShooterPathRequestSubsystem>())
+	{
+		PathRequests->CancelRequest(this);
 	}
 }
 
@@ -44,6 +123,15 @@ void AShooterAIController::OnPawnDeath()
 	// stop StateTree logic
 	StateTreeAI->StopLogic(FString(""));
 
+	// dead NPCs don't take part in squad or sensing updates
+	LeaveSubsystems();
+
+	// keep possessing the pawn if it can be pooled, so both get reused together
+	if (GetWorld()->GetSubsystem<UShooterNPCPoolSubsystem>())
+	{
+		return;
+	}
+
 	// unpossess the pawn
 	UnPossess();
 
@@ -61,14 +149,115 @@ void AShooterAIController::ClearCurrentTarget()
 	TargetEnemy = nullptr;
 }
 
+void AShooterAIController::ApplySignificanceSettings(const FShooterSignificanceTierSettings& Settings)
+{
+	SetActorTickInterval(Settings.ControllerTickInterval);
+
+	// the StateTree component accumulates delta time between ticks, so tasks still see the real elapsed time
+	StateTreeAI->SetComponentTickInterval(Settings.StateTreeTickInterval);
+
+	// perception has no per listener update rate, so distant NPCs stop looking altogether.
+	// Hearing and damage are event driven and stay on
+	AIPerception->SetSenseEnabled(UAISense_Sight::StaticClass(), Settings.bSightEnabled);
+}
+
+void AShooterAIController::DeactivateForPool()
+{
+	// stop moving and thinking
+	GetPathFollowingComponent()->AbortMove(*this, FPathFollowingResultFlags::UserAbort);
+	StateTreeAI->StopLogic(FString(""));
+
+	LeaveSubsystems();
+
+	// stop looking while pooled
+	AIPerception->SetSenseEnabled(UAISense_Sight::StaticClass(), false);
+}
+
+void AShooterAIController::ReactivateFromPool()
+{
+	// forget everything from the previous life
+	ClearCurrentTarget();
+	ClearPerceptionEvents();
+	AIPerception->ForgetAll();
+	AIPerception->SetSenseEnabled(UAISense_Sight::StaticClass(), true);
+
+	JoinSubsystems();
+
+	// start the behavior from the top
+	StateTreeAI->StartLogic();
+}
+
+void AShooterAIController::SetBehaviorEnabled(bool bEnabled)
+{
+	if (bEnabled)
+	{
+		StateTreeAI->StartLogic();
+
+	} else {
+
+		StateTreeAI->StopLogic(FString(""));
+	}
+}
+
+void AShooterAIController::ConsumePerceptionEvents(TFunctionRef<void(const FShooterPerceptionEvent&)> Visitor)
+{
+	for (int32 i = NumPerceptionEvents - 1; i >= 0; --i)
+	{
+		Visitor(PerceptionEvents[(PerceptionEventHead + i) % PerceptionEvents.Num()]);
+	}
+
+	ClearPerceptionEvents();
+}
+
+void AShooterAIController::ClearPerceptionEvents()
+{
+	PerceptionEventHead = 0;
+	NumPerceptionEvents = 0;
+}
+
+void AShooterAIController::PushPerceptionEvent(const FShooterPerceptionEvent& Event)
+{
+	// allocate the buffer on first use
+	if (PerceptionEvents.Num() != PerceptionEventCapacity)
+	{
+		PerceptionEvents.SetNum(PerceptionEventCapacity);
+		ClearPerceptionEvents();
+	}
+
+	const int32 Index = (PerceptionEventHead + NumPerceptionEvents) % PerceptionEvents.Num();
+
+	// overwrite the oldest event when full
+	if (NumPerceptionEvents == PerceptionEvents.Num())
+	{
+		PerceptionEventHead = (PerceptionEventHead + 1) % PerceptionEvents.Num();
+		INC_DWORD_STAT(STAT_ShooterPerceptionEventsDropped);
+
+	} else {
+
+		++NumPerceptionEvents;
+	}
+
+	PerceptionEvents[Index] = Event;
+}
+
 void AShooterAIController::OnPerceptionUpdated(AActor* Actor, FAIStimulus Stimulus)
 {
-	// pass the data to the StateTree delegate hook
-	OnShooterPerceptionUpdated.ExecuteIfBound(Actor, Stimulus);
+	// buffer the update for the StateTree to process on its next tick
+	FShooterPerceptionEvent Event;
+	Event.Actor = Actor;
+	Event.StimulusLocation = Stimulus.StimulusLocation;
+	Event.Strength = Stimulus.Strength;
+	Event.Type = Stimulus.Type;
+
+	PushPerceptionEvent(Event);
 }
 
 void AShooterAIController::OnPerceptionForgotten(AActor* Actor)
 {
-	// pass the data to the StateTree delegate hook
-	OnShooterPerceptionForgotten.ExecuteIfBound(Actor);
+	// buffer the forget for the StateTree to process on its next tick
+	FShooterPerceptionEvent Event;
+	Event.Actor = Actor;
+	Event.bForgotten = true;
+
+	PushPerceptionEvent(Event);
 }
@@ -4,14 +4,32 @@
 
 #include "CoreMinimal.h"
 #include "AIController.h"
+#include "Perception/AIPerceptionTypes.h"
 #include "ShooterAIController.generated.h"
 
 class UStateTreeAIComponent;
 class UAIPerceptionComponent;
 struct FAIStimulus;
+struct FShooterSignificanceTierSettings;
 
-DECLARE_DELEGATE_TwoParams(FShooterPerceptionUpdatedDelegate, AActor*, const FAIStimulus&);
-DECLARE_DELEGATE_OneParam(FShooterPerceptionForgottenDelegate, AActor*);
+/** A perception update or forget, buffered until the StateTree processes it */
+struct FShooterPerceptionEvent
+{
+	/** Sensed actor */
+	TWeakObjectPtr<AActor> Actor;
+
+	/** Where the stimulus came from */
+	FVector StimulusLocation = FVector::ZeroVector;
+
+	/** Stimulus strength */
+	float Strength = 0.0f;
+
+	/** Sense that produced the stimulus */
+	FAISenseID Type;
+
+	/** True if the actor was forgotten instead of sensed */
+	bool bForgotten = false;
+};
 
 /**
  *  Simple AI Controller for a first person shooter enemy
@@ -38,30 +56,44 @@ protected:
 	/** Enemy currently being targeted */
 	TObjectPtr<AActor> TargetEnemy;
 
-public:
+	/** Max number of perception events buffered between StateTree ticks. The oldest are dropped when full */
+	UPROPERTY(EditAnywhere, Category="Shooter", meta = (ClampMin = 1))
+	int32 PerceptionEventCapacity = 32;
+
+	/** Ring buffer of perception events waiting for the StateTree */
+	TArray<FShooterPerceptionEvent> PerceptionEvents;
 
-	/** Called when an AI perception has been updated. StateTree task delegate hook */
-	FShooterPerceptionUpdatedDelegate OnShooterPerceptionUpdated;
+	/** Index of the oldest buffered perception event */
+	int32 PerceptionEventHead = 0;
 
-	/** Called when an AI perception has been forgotten. StateTree task delegate hook */
-	FShooterPerceptionForgottenDelegate OnShooterPerceptionForgotten;
+	/** Number of buffered perception events */
+	int32 NumPerceptionEvents = 0;
 
 public:
 
 	/** Constructor */
-	AShooterAIController();
+	AShooterAIController(const FObjectInitializer& ObjectInitializer);
 
 protected:
 
 	/** Pawn initialization */
 	virtual void OnPossess(APawn* InPawn) override;
 
+	/** Gameplay cleanup */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 protected:
 
 	/** Called when the possessed pawn dies */
 	UFUNCTION()
 	void OnPawnDeath();
 
+	/** Registers with the squad, sensing and crowd subsystems */
+	void JoinSubsystems();
+
+	/** Unregisters from the squad, query cache, sensing and crowd subsystems */
+	void LeaveSubsystems();
+
 public:
 
 	/** Sets the targeted enemy */
@@ -73,8 +105,32 @@ public:
 	/** Returns the targeted enemy */
 	AActor* GetCurrentTarget() const { return TargetEnemy; };
 
+	/** Returns the team tag. NPCs with the same tag share sightings as a squad */
+	FName GetTeamTag() const { return TeamTag; };
+
+	/** Applies the update rates for the pawn's significance tier to this controller, its StateTree and its perception */
+	void ApplySignificanceSettings(const FShooterSignificanceTierSettings& Settings);
+
+	/** Stops the StateTree and perception while the pawn waits in the NPC pool. The pawn stays possessed */
+	void DeactivateForPool();
+
+	/** Clears the previous life's state and restarts the StateTree and perception after the pawn is reused */
+	void ReactivateFromPool();
+
+	/** Starts or stops the behavior StateTree, e.g. while a benchmark drives the pawn */
+	void SetBehaviorEnabled(bool bEnabled);
+
+	/** Passes each buffered perception event to the visitor, newest first, and empties the buffer */
+	void ConsumePerceptionEvents(TFunctionRef<void(const FShooterPerceptionEvent&)> Visitor);
+
+	/** Drops all buffered perception events */
+	void ClearPerceptionEvents();
+
 protected:
 
+	/** Adds a perception event to the ring buffer */
+	void PushPerceptionEvent(const FShooterPerceptionEvent& Event);
+
 	/** Called when the AI perception component updates a perception on a given actor */
 	UFUNCTION()
 	void OnPerceptionUpdated(AActor* Actor, FAIStimulus Stimulus);
@@ -0,0 +1,190 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/AI/ShooterCoverPointCommandlet.h"
+#include "TemporalDash.h"
+#include "TemporalDashCharacter.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Pawn.h"
+#include "NavigationSystem.h"
+#include "NavMesh/RecastNavMesh.h"
+
+UShooterCoverPointCommandlet::UShooterCoverPointCommandlet()
+{
+	// make sure the navmesh matches the level geometry, since cover is sampled along it
+	bBuildNavigation = true;
+}
+
+bool UShooterCoverPointCommandlet::ProcessWorld(UWorld* World, const TMap<FString, FString>& ParamVals)
+{
+	// read the cover heights from the character that will use the points
+	const ATemporalDashCharacter* CharacterDefaults = GetCharacterDefaults(ParamVals);
+
+	CapsuleRadius = CharacterDefaults->GetCapsuleComponent()->GetUnscaledCapsuleRadius();
+	EyeHeight = CharacterDefaults->GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight() + CharacterDefaults->BaseEyeHeight;
+
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World);
+	ARecastNavMesh* NavMesh = NavSys ? Cast<ARecastNavMesh>(NavSys->GetDefaultNavDataInstance(FNavigationSystem::DontCreate)) : nullptr;
+
+	if (!NavMesh)
+	{
+		UE_LOG(LogTemporalDash, Error, TEXT("No navmesh found. Add a Nav Mesh Bounds Volume to the map"));
+		return false;
+	}
+
+	// pawns placed in the map aren't cover
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShooterCoverPointBake), false);
+
+	for (TActorIterator<APawn> It(World); It; ++It)
+	{
+		QueryParams.AddIgnoredActor(*It);
+	}
+
+	CoverPoints.Reset();
+	SpacingHash.Reset();
+
+	TArray<FNavPoly> Polys;
+	TArray<FVector> Verts;
+
+	for (int32 TileIndex = 0; TileIndex < NavMesh->GetNavMeshTilesCount(); ++TileIndex)
+	{
+		Polys.Reset();
+		NavMesh->GetPolysInTile(TileIndex, Polys);
+
+		for (const FNavPoly& Poly : Polys)
+		{
+			Verts.Reset();
+			if (!NavMesh->GetPolyVerts(Poly.Ref, Verts) || Verts.Num() < 3)
+			{
+				continue;
+			}
+
+			// sample along each edge, probing outwards. Inner edges usually find nothing within the probe distance
+			for (int32 i = 0; i < Verts.Num(); ++i)
+			{
+				const FVector& EdgeStart = Verts[i];
+				const FVector& EdgeEnd = Verts[(i + 1) % Verts.Num()];
+
+				const FVector Edge = EdgeEnd - EdgeStart;
+				const float EdgeLength = Edge.Size2D();
+
+				if (EdgeLength < UE_KINDA_SMALL_NUMBER)
+				{
+					continue;
+				}
+
+				// horizontal edge normal, pointing out of the polygon
+				FVector Normal = FVector(Edge.Y, -Edge.X, 0.0f).GetSafeNormal();
+
+				if (FVector::DotProduct(Normal, (EdgeStart + EdgeEnd) * 0.5f - Poly.Center) < 0.0f)
+				{
+					Normal = -Normal;
+				}
+
+				const int32 NumSamples = FMath::Max(1, FMath::FloorToInt(EdgeLength / EdgeSampleSpacing));
+
+				for (int32 SampleIndex = 0; SampleIndex < NumSamples; ++SampleIndex)
+				{
+					const float SampleAlpha = (SampleIndex + 0.5f) / NumSamples;
+
+					ProbeCover(World, NavSys, NavMesh, FMath::Lerp(EdgeStart, EdgeEnd, SampleAlpha), Normal, QueryParams);
+				}
+			}
+		}
+	}
+
+	const int32 NumFullCover = CoverPoints.FilterByPredicate([](const FShooterCoverPoint& Point) { return Point.bFullHeight; }).Num();
+
+	UE_LOG(LogTemporalDash, Display, TEXT("Generated %d cover points (%d full height, %d low)"), CoverPoints.Num(), NumFullCover, CoverPoints.Num() - NumFullCover);
+
+	// find or create the cover point asset next to the map
+	UShooterCoverPointSet* CoverSet = FindOrCreateMapAsset<UShooterCoverPointSet>(World, &UShooterCoverPointSet::GetCoverPointsPackageName);
+	CoverSet->SetBakedPoints(MoveTemp(CoverPoints), HashCellSize);
+
+	return SaveMapAsset(CoverSet);
+}
+
+void UShooterCoverPointCommandlet::ProbeCover(UWorld* World, UNavigationSystemV1* NavSys, ARecastNavMesh* NavMesh, const FVector& FloorLocation, const FVector& Direction, const FCollisionQueryParams& QueryParams)
+{
+	// probe from where the capsule would stand, back from the edge
+	const FVector Standing = FloorLocation - Direction * CapsuleRadius;
+	const float ProbeLength = CapsuleRadius + ProbeDistance;
+
+	// low cover has to block at chest height while crouched
+	FHitResult LowHit;
+	const FVector LowStart = Standing + FVector(0.0f, 0.0f, LowCoverHeight);
+
+	if (!World->LineTraceSingleByChannel(LowHit, LowStart, LowStart + Direction * ProbeLength, ECC_Visibility, QueryParams))
+	{
+		return;
+	}
+
+	// ignore slopes and steps
+	if (FMath::Abs(LowHit.ImpactNormal.Z) > MaxCoverNormalZ)
+	{
+		return;
+	}
+
+	// face the obstacle's surface rather than the navmesh edge
+	const FVector CoverDirection = (-LowHit.ImpactNormal).GetSafeNormal2D();
+
+	if (CoverDirection.IsNearlyZero())
+	{
+		return;
+	}
+
+	// snap back to the navmesh right in front of the obstacle
+	FNavLocation CoverLocation;
+	const FVector CoverQuery = FVector(LowHit.ImpactPoint.X, LowHit.ImpactPoint.Y, FloorLocation.Z) - CoverDirection * (CapsuleRadius + 10.0f);
+
+	if (!NavSys->ProjectPointToNavigation(CoverQuery, CoverLocation, FVector(CapsuleRadius, CapsuleRadius, LowCoverHeight), NavMesh))
+	{
+		return;
+	}
+
+	if (IsDuplicatePoint(CoverLocation.Location))
+	{
+		return;
+	}
+
+	// full cover also blocks at eye height
+	FHitResult FullHit;
+	const FVector EyeStart = CoverLocation.Location + FVector(0.0f, 0.0f, EyeHeight);
+	const bool bFullHeight = World->LineTraceSingleByChannel(FullHit, EyeStart, EyeStart + CoverDirection * ProbeLength, ECC_Visibility, QueryParams);
+
+	FShooterCoverPoint& Point = CoverPoints.AddDefaulted_GetRef();
+	Point.Location = CoverLocation.Location;
+	Point.CoverDirection = CoverDirection;
+	Point.bFullHeight = bFullHeight;
+
+	const FIntPoint SpacingCell(FMath::FloorToInt(Point.Location.X / MinCoverSpacing), FMath::FloorToInt(Point.Location.Y / MinCoverSpacing));
+	SpacingHash.Add(SpacingCell, CoverPoints.Num() - 1);
+}
+
+bool UShooterCoverPointCommandlet::IsDuplicatePoint(const FVector& Location) const
+{
+	const FIntPoint Cell(FMath::FloorToInt(Location.X / MinCoverSpacing), FMath::FloorToInt(Location.Y / MinCoverSpacing));
+
+	TArray<int32, TInlineAllocator<8>> PointIndices;
+
+	for (int32 Y = Cell.Y - 1; Y <= Cell.Y + 1; ++Y)
+	{
+		for (int32 X = Cell.X - 1; X <= Cell.X + 1; ++X)
+		{
+			PointIndices.Reset();
+			SpacingHash.MultiFind(FIntPoint(X, Y), PointIndices);
+
+			for (const int32 PointIndex : PointIndices)
+			{
+				if (FVector::DistSquared(CoverPoints[PointIndex].Location, Location) < FMath::Square(MinCoverSpacing))
+				{
+					return true;
+				}
+			}
+		}
+	}
+
+	return false;
+}
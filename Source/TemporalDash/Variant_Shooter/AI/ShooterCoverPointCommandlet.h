@@ -0,0 +1,73 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TemporalDashWorldCommandlet.h"
+#include "ShooterCoverPointSet.h"
+#include "ShooterCoverPointCommandlet.generated.h"
+
+class ARecastNavMesh;
+class UNavigationSystemV1;
+
+/**
+ *  Offline generator for AI cover points
+ *  Samples along the navmesh polygon edges and probes outwards for walls and low obstacles
+ *  Each hit becomes a cover point facing the obstacle, marked as full or low cover depending on whether it blocks at eye height
+ *  Saves the result as a UShooterCoverPointSet asset next to the map, which the cover subsystem picks up at runtime
+ *  The set isn't referenced by the map, so its folder needs to be always cooked for packaged builds
+ *  Usage: UnrealEditor-Cmd.exe TemporalDash.uproject -run=ShooterCoverPoint -Map=/Game/Path/To/Map [-Character=/Game/Path/To/BP_NPC.BP_NPC_C]
+ */
+UCLASS()
+class TEMPORALDASH_API UShooterCoverPointCommandlet : public UTemporalDashWorldCommandlet
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Spacing between samples along navmesh polygon edges */
+	float EdgeSampleSpacing = 100.0f;
+
+	/** Max distance from the capsule edge to the obstacle for it to count as cover */
+	float ProbeDistance = 60.0f;
+
+	/** Height above the floor the obstacle must block for low cover */
+	float LowCoverHeight = 80.0f;
+
+	/** Max vertical component of the obstacle's normal. Rejects slopes and stairs */
+	float MaxCoverNormalZ = 0.3f;
+
+	/** Min distance between cover points */
+	float MinCoverSpacing = 120.0f;
+
+	/** Size of the spatial hash cells in the saved set */
+	float HashCellSize = 1000.0f;
+
+	/** Capsule radius of the NPC, read from the character defaults */
+	float CapsuleRadius = 34.0f;
+
+	/** Eye height above the floor, read from the character defaults. Obstacles blocking here are full cover */
+	float EyeHeight = 160.0f;
+
+	/** Generated points */
+	TArray<FShooterCoverPoint> CoverPoints;
+
+	/** Spatial hash of the generated points with MinCoverSpacing cells, used for the duplicate check */
+	TMultiMap<FIntPoint, int32> SpacingHash;
+
+public:
+
+	/** Constructor */
+	UShooterCoverPointCommandlet();
+
+protected:
+
+	/** Extracts the cover points for the loaded map */
+	virtual bool ProcessWorld(UWorld* World, const TMap<FString, FString>& ParamVals) override;
+
+	/** Probes outwards from a navmesh location for cover. Adds a cover point if one is found */
+	void ProbeCover(UWorld* World, UNavigationSystemV1* NavSys, ARecastNavMesh* NavMesh, const FVector& FloorLocation, const FVector& Direction, const FCollisionQueryParams& QueryParams);
+
+	/** Returns true if there's already a cover point close to the location */
+	bool IsDuplicatePoint(const FVector& Location) const;
+};
@@ -0,0 +1,100 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/AI/ShooterCoverPointSet.h"
+
+FString UShooterCoverPointSet::GetCoverPointsPackageName(const FString& MapPackageName)
+{
+	return MapPackageName + TEXT("_CoverPoints");
+}
+
+FIntPoint UShooterCoverPointSet::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+}
+
+void UShooterCoverPointSet::GetPointsInRadius(const FVector& Center, float Radius, TArray<int32>& OutPointIndices) const
+{
+	const FIntPoint MinCell = GetCell(Center - FVector(Radius));
+	const FIntPoint MaxCell = GetCell(Center + FVector(Radius));
+
+	const float RadiusSquared = FMath::Square(Radius);
+
+	for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+	{
+		for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+		{
+			const FShooterCoverCell* Cell = Cells.Find(FIntPoint(X, Y));
+
+			if (!Cell)
+			{
+				continue;
+			}
+
+			for (int32 PointIndex = Cell->FirstPoint; PointIndex < Cell->FirstPoint + Cell->NumPoints; ++PointIndex)
+			{
+				if (FVector::DistSquared(Points[PointIndex].Location, Center) <= RadiusSquared)
+				{
+					OutPointIndices.Add(PointIndex);
+				}
+			}
+		}
+	}
+}
+
+int32 UShooterCoverPointSet::FindPoint(const FVector& Location, float Tolerance) const
+{
+	// the tolerance is small, so it can only spill into neighbor cells
+	const FIntPoint MinCell = GetCell(Location - FVector(Tolerance));
+	const FIntPoint MaxCell = GetCell(Location + FVector(Tolerance));
+
+	const float ToleranceSquared = FMath::Square(Tolerance);
+
+	for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+	{
+		for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+		{
+			if (const FShooterCoverCell* Cell = Cells.Find(FIntPoint(X, Y)))
+			{
+				for (int32 PointIndex = Cell->FirstPoint; PointIndex < Cell->FirstPoint + Cell->NumPoints; ++PointIndex)
+				{
+					if (FVector::DistSquared(Points[PointIndex].Location, Location) <= ToleranceSquared)
+					{
+						return PointIndex;
+					}
+				}
+			}
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+void UShooterCoverPointSet::SetBakedPoints(TArray<FShooterCoverPoint>&& InPoints, float InCellSize)
+{
+	CellSize = InCellSize;
+	Points = MoveTemp(InPoints);
+
+	// sort the points by cell so each cell is a contiguous range
+	Points.Sort([this](const FShooterCoverPoint& A, const FShooterCoverPoint& B)
+	{
+		const FIntPoint CellA = GetCell(A.Location);
+		const FIntPoint CellB = GetCell(B.Location);
+
+		return CellA.Y != CellB.Y ? CellA.Y < CellB.Y : CellA.X < CellB.X;
+	});
+
+	Cells.Reset();
+
+	for (int32 PointIndex = 0; PointIndex < Points.Num(); ++PointIndex)
+	{
+		FShooterCoverCell& Cell = Cells.FindOrAdd(GetCell(Points[PointIndex].Location));
+
+		if (Cell.NumPoints == 0)
+		{
+			Cell.FirstPoint = PointIndex;
+		}
+
+		++Cell.NumPoints;
+	}
+}
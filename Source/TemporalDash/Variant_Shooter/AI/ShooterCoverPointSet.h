@@ -0,0 +1,86 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ShooterCoverPointSet.generated.h"
+
+/** A baked cover location on the navmesh */
+USTRUCT()
+struct FShooterCoverPoint
+{
+	GENERATED_BODY()
+
+	/** Navmesh location to stand or crouch at */
+	UPROPERTY()
+	FVector Location = FVector::ZeroVector;
+
+	/** Horizontal unit direction towards the cover. Threats in this direction are blocked */
+	UPROPERTY()
+	FVector CoverDirection = FVector::ForwardVector;
+
+	/** If true, the cover blocks at eye height. Otherwise it's only chest high and protects while crouched */
+	UPROPERTY()
+	bool bFullHeight = false;
+};
+
+/** Range of points in a spatial hash cell */
+USTRUCT()
+struct FShooterCoverCell
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 FirstPoint = 0;
+
+	UPROPERTY()
+	int32 NumPoints = 0;
+};
+
+/**
+ *  Baked cover points for a map, spatially hashed on a 2D grid
+ *  Points are stored sorted by cell so each cell maps to a contiguous range
+ *  Generated per map by the ShooterCoverPoint commandlet and saved next to it as <MapName>_CoverPoints
+ */
+UCLASS()
+class TEMPORALDASH_API UShooterCoverPointSet : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Size of the spatial hash cells */
+	UPROPERTY(VisibleAnywhere, Category="Cover", meta = (Units = "cm"))
+	float CellSize = 1000.0f;
+
+protected:
+
+	/** Cover points, sorted by cell */
+	UPROPERTY(VisibleAnywhere, Category="Cover")
+	TArray<FShooterCoverPoint> Points;
+
+	/** Point ranges for each occupied cell */
+	UPROPERTY()
+	TMap<FIntPoint, FShooterCoverCell> Cells;
+
+public:
+
+	/** Returns the name of the cover point package for the passed map package */
+	static FString GetCoverPointsPackageName(const FString& MapPackageName);
+
+	/** Returns all cover points */
+	const TArray<FShooterCoverPoint>& GetPoints() const { return Points; };
+
+	/** Returns the hash cell for a location */
+	FIntPoint GetCell(const FVector& Location) const;
+
+	/** Adds the indices of all points within the radius of the center. Only visits the cells overlapping the radius */
+	void GetPointsInRadius(const FVector& Center, float Radius, TArray<int32>& OutPointIndices) const;
+
+	/** Returns the index of the point at the location, or INDEX_NONE if there's none within the tolerance */
+	int32 FindPoint(const FVector& Location, float Tolerance = 10.0f) const;
+
+	/** Replaces the baked points and rebuilds the spatial hash */
+	void SetBakedPoints(TArray<FShooterCoverPoint>&& InPoints, float InCellSize);
+};
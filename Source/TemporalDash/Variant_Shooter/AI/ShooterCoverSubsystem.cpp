@@ -0,0 +1,26 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/AI/ShooterCoverSubsystem.h"
+#include "TemporalDash.h"
+#include "ShooterCoverPointSet.h"
+#include "Engine/World.h"
+#include "TemporalDashMapAsset.h"
+
+bool UShooterCoverSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterCoverSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// the cover points are saved next to the map by the cover point commandlet
+	CoverPoints = LoadMapSideCarAsset<UShooterCoverPointSet>(InWorld, &UShooterCoverPointSet::GetCoverPointsPackageName);
+
+	if (!CoverPoints)
+	{
+		UE_LOG(LogTemporalDash, Log, TEXT("No baked cover points for '%s'. Run the ShooterCoverPoint commandlet to generate them"), *InWorld.GetMapName());
+	}
+}
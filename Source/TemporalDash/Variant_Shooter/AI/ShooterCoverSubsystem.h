@@ -0,0 +1,35 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterCoverSubsystem.generated.h"
+
+class UShooterCoverPointSet;
+
+/**
+ *  Provides the baked cover points for the current map to AI queries
+ */
+UCLASS()
+class TEMPORALDASH_API UShooterCoverSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Baked cover points for the map, if they were generated */
+	UPROPERTY(Transient)
+	TObjectPtr<UShooterCoverPointSet> CoverPoints;
+
+public:
+
+	/** Only game worlds run AI */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Loads the cover points for the map */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Returns the cover points for the map, or nullptr if none were baked */
+	const UShooterCoverPointSet* GetCoverPoints() const { return CoverPoints; };
+};
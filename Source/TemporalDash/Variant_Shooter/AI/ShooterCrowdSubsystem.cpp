@@ -0,0 +1,358 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/AI/ShooterCrowdSubsystem.h"
+#include "TemporalDash.h"
+#include "ShooterAIController.h"
+#include "ShooterNPC.h"
+#include "ShooterNPCPoolSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "TimerManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Crowd Membership Tick"), STAT_ShooterCrowdTick, STATGROUP_ShooterAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Crowd Agents Simulated"), STAT_ShooterCrowdSimulated, STATGROUP_ShooterAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Crowd Agents Obstacle Only"), STAT_ShooterCrowdObstacles, STATGROUP_ShooterAI);
+
+bool UShooterCrowdSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UShooterCrowdSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterCrowdSubsystem, STATGROUP_Tickables);
+}
+
+void UShooterCrowdSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShooterCrowdTick);
+
+	Super::Tick(DeltaTime);
+
+	// refresh the next slice of agents
+	const int32 NumUpdates = FMath::Min(MaxAgentUpdatesPerFrame, Agents.Num());
+
+	for (int32 i = 0; i < NumUpdates && !Agents.IsEmpty(); ++i)
+	{
+		if (NextAgent >= Agents.Num())
+		{
+			NextAgent = 0;
+		}
+
+		FAgent& Agent = Agents[NextAgent];
+
+		if (!Agent.Controller.IsValid())
+		{
+			Agents.RemoveAtSwap(NextAgent, EAllowShrinking::No);
+			continue;
+		}
+
+		const EAgentMode DesiredMode = GetDesiredMode(Agent.Controller.Get());
+
+		if (DesiredMode != Agent.Mode)
+		{
+			ApplyMode(Agent, DesiredMode);
+		}
+
+		++NextAgent;
+	}
+
+	int32 NumSimulated = 0;
+	int32 NumObstacles = 0;
+
+	for (const FAgent& Agent : Agents)
+	{
+		NumSimulated += Agent.Mode == EAgentMode::HighQuality || Agent.Mode == EAgentMode::ReducedQuality;
+		NumObstacles += Agent.Mode == EAgentMode::ObstacleOnly;
+	}
+
+	SET_DWORD_STAT(STAT_ShooterCrowdSimulated, NumSimulated);
+	SET_DWORD_STAT(STAT_ShooterCrowdObstacles, NumObstacles);
+
+	// retry the benchmark moves that failed last frame. Doing it here instead of from the finished move keeps a move that fails right away from recursing
+	if (Benchmark && !Benchmark->PendingRetries.IsEmpty())
+	{
+		const TArray<int32> Retries = MoveTemp(Benchmark->PendingRetries);
+
+		for (const int32 Index : Retries)
+		{
+			if (AShooterAIController* Controller = Benchmark->Controllers[Index].Get())
+			{
+				MoveBenchmarkNPC(Controller);
+			}
+		}
+	}
+}
+
+void UShooterCrowdSubsystem::RegisterController(AShooterAIController* Controller)
+{
+	if (IsValid(Controller) && !Agents.ContainsByPredicate([Controller](const FAgent& Agent) { return Agent.Controller == Controller; }))
+	{
+		FAgent& Agent = Agents.AddDefaulted_GetRef();
+		Agent.Controller = Controller;
+	}
+}
+
+void UShooterCrowdSubsystem::UnregisterController(AShooterAIController* Controller)
+{
+	Agents.RemoveAllSwap([Controller](const FAgent& Agent) { return Agent.Controller == Controller; }, EAllowShrinking::No);
+}
+
+UShooterCrowdSubsystem::EAgentMode UShooterCrowdSubsystem::GetDesiredMode(const AShooterAIController* Controller) const
+{
+	if (bCrowdDisabled)
+	{
+		return EAgentMode::Disabled;
+	}
+
+	const AShooterNPC* NPC = Cast<AShooterNPC>(Controller->GetPawn());
+
+	if (!NPC)
+	{
+		return EAgentMode::ObstacleOnly;
+	}
+
+	const EShooterSignificanceTier Tier = NPC->GetSignificanceTier();
+
+	if (Tier == EShooterSignificanceTier::High)
+	{
+		return EAgentMode::HighQuality;
+	}
+
+	return Tier <= MaxSimulatedTier ? EAgentMode::ReducedQuality : EAgentMode::ObstacleOnly;
+}
+
+void UShooterCrowdSubsystem::ApplyMode(FAgent& Agent, EAgentMode Mode)
+{
+	UCrowdFollowingComponent* CrowdFollowing = Cast<UCrowdFollowingComponent>(Agent.Controller->GetPathFollowingComponent());
+
+	if (!CrowdFollowing)
+	{
+		return;
+	}
+
+	// the crowd can only add or remove an agent while it's not following a path, so try again later
+	const ECrowdSimulationState NewState = Mode == EAgentMode::Disabled ? ECrowdSimulationState::Disabled
+		: Mode == EAgentMode::ObstacleOnly ? ECrowdSimulationState::ObstacleOnly
+		: ECrowdSimulationState::Enabled;
+
+	if (CrowdFollowing->GetCrowdSimulationState() != NewState)
+	{
+		if (CrowdFollowing->GetStatus() != EPathFollowingStatus::Idle)
+		{
+			return;
+		}
+
+		CrowdFollowing->SetCrowdSimulationState(NewState);
+	}
+
+	// quality can change at any time
+	if (Mode == EAgentMode::HighQuality)
+	{
+		CrowdFollowing->SetCrowdAvoidanceQuality(HighAvoidanceQuality);
+
+	} else if (Mode == EAgentMode::ReducedQuality) {
+
+		CrowdFollowing->SetCrowdAvoidanceQuality(ReducedAvoidanceQuality);
+	}
+
+	Agent.Mode = Mode;
+}
+
+void UShooterCrowdSubsystem::StartBenchmark(TSubclassOf<AShooterNPC> NPCClass, int32 NumNPCs, float PhaseTime)
+{
+	UShooterNPCPoolSubsystem* NPCPool = GetWorld()->GetSubsystem<UShooterNPCPoolSubsystem>();
+	APawn* Player = GetWorld()->GetFirstPlayerController() ? GetWorld()->GetFirstPlayerController()->GetPawn() : nullptr;
+
+	if (Benchmark || !NPCClass || !NPCPool || !Player)
+	{
+		UE_LOG(LogTemporalDash, Warning, TEXT("Usage: ShooterAI.CrowdBenchmark <NPC class path> [NPC count] [seconds per phase]. Needs a game world with a player pawn and no benchmark running"));
+		return;
+	}
+
+	Benchmark = MakeUnique<FBenchmark>();
+	Benchmark->Target = Player;
+	Benchmark->PhaseTime = PhaseTime;
+
+	// spawn the NPCs in a ring around the player, facing it
+	const float RingRadius = 3000.0f;
+
+	for (int32 i = 0; i < NumNPCs; ++i)
+	{
+		const FVector Dir = FRotator(0.0f, 360.0f * i / NumNPCs, 0.0f).Vector();
+		const FTransform SpawnTransform((-Dir).Rotation(), Player->GetActorLocation() + Dir * RingRadius);
+
+		AShooterNPC* NPC = NPCPool->SpawnNPC(NPCClass, SpawnTransform);
+		AShooterAIController* Controller = NPC ? Cast<AShooterAIController>(NPC->GetController()) : nullptr;
+
+		if (!Controller)
+		{
+			continue;
+		}
+
+		// the benchmark drives the movement, so the StateTree stays out of it
+		Controller->SetBehaviorEnabled(false);
+
+		// count failed moves as re-paths
+		const int32 Index = Benchmark->Controllers.Num();
+
+		Controller->GetPathFollowingComponent()->OnRequestFinished.AddWeakLambda(this, [this, Index](FAIRequestID RequestID, const FPathFollowingResult& Result)
+		{
+			if (!Benchmark || Result.HasFlag(FPathFollowingResultFlags::UserAbort) || Result.HasFlag(FPathFollowingResultFlags::NewRequest))
+			{
+				return;
+			}
+
+			if (Result.IsSuccess())
+			{
+				++Benchmark->NumArrived;
+				Benchmark->TotalArrivalTime += GetWorld()->GetTimeSeconds() - Benchmark->PhaseStartTime;
+
+			} else {
+
+				++Benchmark->NumRepaths;
+
+				// retry on the next tick, a limited number of times so an unreachable target doesn't re-path forever
+				if (Benchmark->NumRetries[Index]++ < MaxBenchmarkRetries)
+				{
+					Benchmark->PendingRetries.AddUnique(Index);
+				}
+			}
+		});
+
+		Benchmark->Controllers.Add(Controller);
+		Benchmark->StartTransforms.Add(SpawnTransform);
+		Benchmark->NumRetries.Add(0);
+	}
+
+#if CSV_PROFILER
+	FCsvProfiler::Get()->BeginCapture();
+#endif
+
+	StartBenchmarkPhase(0);
+}
+
+void UShooterCrowdSubsystem::StartBenchmarkPhase(int32 Phase)
+{
+	Benchmark->Phase = Phase;
+	Benchmark->NumRepaths = 0;
+	Benchmark->NumArrived = 0;
+	Benchmark->TotalArrivalTime = 0.0;
+
+	// each phase gets a fresh retry budget
+	for (int32& NumRetries : Benchmark->NumRetries)
+	{
+		NumRetries = 0;
+	}
+
+	Benchmark->PendingRetries.Reset();
+
+	// first phase is plain path following, second phase is crowd avoidance
+	bCrowdDisabled = Phase == 0;
+
+	CSV_EVENT_GLOBAL(TEXT("%s"), Phase == 0 ? TEXT("CrowdOff") : TEXT("CrowdOn"));
+
+	for (int32 i = 0; i < Benchmark->Controllers.Num(); ++i)
+	{
+		AShooterAIController* Controller = Benchmark->Controllers[i].Get();
+
+		if (!Controller || !Controller->GetPawn())
+		{
+			continue;
+		}
+
+		// stop, so the crowd state can change, and go back to the start
+		Controller->StopMovement();
+		Controller->GetPawn()->SetActorTransform(Benchmark->StartTransforms[i], false, nullptr, ETeleportType::ResetPhysics);
+
+		for (FAgent& Agent : Agents)
+		{
+			if (Agent.Controller == Controller)
+			{
+				ApplyMode(Agent, GetDesiredMode(Controller));
+			}
+		}
+	}
+
+	Benchmark->PhaseStartTime = GetWorld()->GetTimeSeconds();
+
+	for (const TWeakObjectPtr<AShooterAIController>& Controller : Benchmark->Controllers)
+	{
+		if (Controller.IsValid())
+		{
+			MoveBenchmarkNPC(Controller.Get());
+		}
+	}
+
+	FTimerHandle PhaseTimer;
+	GetWorld()->GetTimerManager().SetTimer(PhaseTimer, FTimerDelegate::CreateUObject(this, &UShooterCrowdSubsystem::EndBenchmarkPhase), Benchmark->PhaseTime, false);
+}
+
+void UShooterCrowdSubsystem::EndBenchmarkPhase()
+{
+	if (!Benchmark)
+	{
+		return;
+	}
+
+	UE_LOG(LogTemporalDash, Display, TEXT("Crowd benchmark, crowd %s: %d of %d NPCs arrived, %.2fs average arrival time, %d re-paths"),
+		Benchmark->Phase == 0 ? TEXT("off") : TEXT("on"),
+		Benchmark->NumArrived, Benchmark->Controllers.Num(),
+		Benchmark->NumArrived > 0 ? Benchmark->TotalArrivalTime / Benchmark->NumArrived : 0.0,
+		Benchmark->NumRepaths);
+
+	if (Benchmark->Phase == 0)
+	{
+		StartBenchmarkPhase(1);
+		return;
+	}
+
+	CSV_EVENT_GLOBAL(TEXT("CrowdBenchmarkEnd"));
+
+#if CSV_PROFILER
+	FCsvProfiler::Get()->EndCapture();
+#endif
+
+	// hand the NPCs back to their StateTrees
+	for (const TWeakObjectPtr<AShooterAIController>& Controller : Benchmark->Controllers)
+	{
+		if (Controller.IsValid())
+		{
+			Controller->GetPathFollowingComponent()->OnRequestFinished.RemoveAll(this);
+			Controller->SetBehaviorEnabled(true);
+		}
+	}
+
+	Benchmark.Reset();
+	bCrowdDisabled = false;
+
+	UE_LOG(LogTemporalDash, Display, TEXT("Crowd benchmark done. Compare the path following timings between the CrowdOff and CrowdOn events in the CSV capture"));
+}
+
+void UShooterCrowdSubsystem::MoveBenchmarkNPC(AShooterAIController* Controller)
+{
+	if (AActor* Target = Benchmark->Target.Get())
+	{
+		Controller->MoveToActor(Target, 300.0f);
+	}
+}
+
+static void RunCrowdBenchmark(const TArray<FString>& Args, UWorld* World)
+{
+	// usage: ShooterAI.CrowdBenchmark <NPC class path> [NPC count] [seconds per phase]
+	UClass* NPCClass = Args.IsValidIndex(0) ? LoadClass<AShooterNPC>(nullptr, *Args[0]) : nullptr;
+	const int32 NumNPCs = Args.IsValidIndex(1) ? FCString::Atoi(*Args[1]) : 150;
+	const float PhaseTime = Args.IsValidIndex(2) ? FCString::Atof(*Args[2]) : 20.0f;
+
+	if (UShooterCrowdSubsystem* Crowd = World->GetSubsystem<UShooterCrowdSubsystem>())
+	{
+		Crowd->StartBenchmark(NPCClass, NumNPCs, PhaseTime);
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CmdCrowdBenchmark(
+	TEXT("ShooterAI.CrowdBenchmark"),
+	TEXT("Spawns NPCs in a ring around the player and has them converge on it without and then with crowd avoidance. Args: <NPC class path> [NPC count] [seconds per phase]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunCrowdBenchmark));
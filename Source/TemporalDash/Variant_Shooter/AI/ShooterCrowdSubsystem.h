@@ -0,0 +1,134 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Navigation/CrowdFollowingComponent.h"
+#include "ShooterSignificanceSubsystem.h"
+#include "ShooterCrowdSubsystem.generated.h"
+
+class AShooterAIController;
+class AShooterNPC;
+
+/**
+ *  Decides which shooter NPCs take part in crowd avoidance, and at what quality
+ *  All NPCs share the engine's crowd manager as the avoidance solver. Significant NPCs simulate with full avoidance,
+ *  less significant ones with cheaper avoidance, and the rest only act as obstacles for the others
+ *  Membership is refreshed for a limited number of NPCs per frame, since adding and removing crowd agents isn't free
+ */
+UCLASS(config=Game)
+class TEMPORALDASH_API UShooterCrowdSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Lowest significance tier that still simulates avoidance. Less significant NPCs are only obstacles */
+	UPROPERTY(config, EditAnywhere, Category="Crowd")
+	EShooterSignificanceTier MaxSimulatedTier = EShooterSignificanceTier::Medium;
+
+	/** Avoidance quality for High significance NPCs */
+	UPROPERTY(config, EditAnywhere, Category="Crowd")
+	TEnumAsByte<ECrowdAvoidanceQuality::Type> HighAvoidanceQuality = ECrowdAvoidanceQuality::Good;
+
+	/** Avoidance quality for the other simulated tiers */
+	UPROPERTY(config, EditAnywhere, Category="Crowd")
+	TEnumAsByte<ECrowdAvoidanceQuality::Type> ReducedAvoidanceQuality = ECrowdAvoidanceQuality::Low;
+
+	/** Max number of NPCs whose crowd membership is refreshed each frame */
+	UPROPERTY(config, EditAnywhere, Category="Crowd", meta = (ClampMin = 1))
+	int32 MaxAgentUpdatesPerFrame = 16;
+
+	/** How an NPC currently takes part in the crowd */
+	enum class EAgentMode : uint8
+	{
+		Unset,
+		HighQuality,
+		ReducedQuality,
+		ObstacleOnly,
+		Disabled
+	};
+
+	/** A registered NPC controller */
+	struct FAgent
+	{
+		TWeakObjectPtr<AShooterAIController> Controller;
+		EAgentMode Mode = EAgentMode::Unset;
+	};
+
+	/** Registered NPC controllers */
+	TArray<FAgent> Agents;
+
+	/** Next agent to refresh */
+	int32 NextAgent = 0;
+
+	/** If true, crowd simulation is turned off for all agents. Used to benchmark against plain path following */
+	bool bCrowdDisabled = false;
+
+	/** Max number of times a benchmark NPC re-paths after a failed move in each phase */
+	int32 MaxBenchmarkRetries = 10;
+
+	/** Convergence benchmark state */
+	struct FBenchmark
+	{
+		TArray<TWeakObjectPtr<AShooterAIController>> Controllers;
+		TArray<FTransform> StartTransforms;
+		TWeakObjectPtr<AActor> Target;
+		float PhaseTime = 0.0f;
+		int32 Phase = 0;
+		double PhaseStartTime = 0.0;
+		int32 NumRepaths = 0;
+		int32 NumArrived = 0;
+		double TotalArrivalTime = 0.0;
+
+		/** Re-paths used by each NPC in this phase */
+		TArray<int32> NumRetries;
+
+		/** NPCs whose move failed, re-pathed on the next tick */
+		TArray<int32> PendingRetries;
+	};
+
+	/** Current benchmark, if one is running */
+	TUniquePtr<FBenchmark> Benchmark;
+
+public:
+
+	/** Only game worlds run AI */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Refreshes the crowd membership of the next slice of agents, and re-paths failed benchmark moves */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for the tickable */
+	virtual TStatId GetStatId() const override;
+
+	/** Adds an NPC controller to the crowd */
+	void RegisterController(AShooterAIController* Controller);
+
+	/** Removes an NPC controller from the crowd */
+	void UnregisterController(AShooterAIController* Controller);
+
+	/**
+	 *  Spawns NPCs in a ring around the player and has them all converge on it, first with plain path following and then with crowd avoidance
+	 *  Logs re-path counts and arrival times for each phase, and captures a CSV profile split by phase events
+	 */
+	void StartBenchmark(TSubclassOf<AShooterNPC> NPCClass, int32 NumNPCs, float PhaseTime);
+
+protected:
+
+	/** Applies a crowd mode to an agent */
+	void ApplyMode(FAgent& Agent, EAgentMode Mode);
+
+	/** Returns the crowd mode an NPC should use */
+	EAgentMode GetDesiredMode(const AShooterAIController* Controller) const;
+
+	/** Resets the benchmark NPCs and starts a phase */
+	void StartBenchmarkPhase(int32 Phase);
+
+	/** Ends the current benchmark phase and logs the results */
+	void EndBenchmarkPhase();
+
+	/** Starts a benchmark NPC moving towards the target */
+	void MoveBenchmarkNPC(AShooterAIController* Controller);
+};
@@ -2,27 +2,57 @@
 
 
 #include "Variant_Shooter/AI/ShooterNPC.h"
+#include "TemporalDash.h"
 #include "ShooterWeapon.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Camera/CameraComponent.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "Engine/World.h"
 #include "ShooterGameMode.h"
+#include "ShooterAIController.h"
+#include "ShooterSignificanceSubsystem.h"
+#include "ShooterNPCPoolSubsystem.h"
+#include "ShooterRagdollSubsystem.h"
 #include "Components/CapsuleComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "TimerManager.h"
+#include "SkeletalMeshComponentBudgeted.h"
+#include "IAnimationBudgetAllocator.h"
+#include "ShooterNPCMovementComponent.h"
+
+AShooterNPC::AShooterNPC(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer
+		.SetDefaultSubobjectClass<USkeletalMeshComponentBudgeted>(ACharacter::MeshComponentName)
+		.SetDefaultSubobjectClass<UShooterNPCMovementComponent>(ACharacter::CharacterMovementComponentName))
+{
+	// significance tiers drive the animation budget, so don't let the mesh calculate its own
+	if (USkeletalMeshComponentBudgeted* BudgetedMesh = Cast<USkeletalMeshComponentBudgeted>(GetMesh()))
+	{
+		BudgetedMesh->SetAutoCalculateSignificance(false);
+	}
+
+	// AI has no first person view, so the first person mesh never needs to animate
+	GetFirstPersonMesh()->PrimaryComponentTick.bCanEverTick = false;
+	GetFirstPersonMesh()->SetHiddenInGame(true);
+}
 
 void AShooterNPC::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// save the collision and mesh placement so they can be restored after ragdolling
+	MeshCollisionProfile = GetMesh()->GetCollisionProfileName();
+	MeshRelativeTransform = GetMesh()->GetRelativeTransform();
+	CapsuleCollision = GetCapsuleComponent()->GetCollisionEnabled();
+
 	// spawn the weapon
-	FActorSpawnParameters SpawnParams;
-	SpawnParams.Owner = this;
-	SpawnParams.Instigator = this;
-	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnWeapon();
 
-	Weapon = GetWorld()->SpawnActor<AShooterWeapon>(WeaponClass, GetActorTransform(), SpawnParams);
+	// register with the significance subsystem to have our update rates managed
+	if (UShooterSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UShooterSignificanceSubsystem>())
+	{
+		Significance->RegisterNPC(this);
+	}
 }
 
 void AShooterNPC::EndPlay(const EEndPlayReason::Type EndPlayReason)
@@ -31,6 +61,18 @@ void AShooterNPC::EndPlay(const EEndPlayReason::Type EndPlayReason)
 
 	// clear the death timer
 	GetWorld()->GetTimerManager().ClearTimer(DeathTimer);
+
+	// release our ragdoll slot
+	if (UShooterRagdollSubsystem* Ragdolls = GetWorld()->GetSubsystem<UShooterRagdollSubsystem>())
+	{
+		Ragdolls->StopRagdoll(this);
+	}
+
+	// unregister from the significance subsystem
+	if (UShooterSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UShooterSignificanceSubsystem>())
+	{
+		Significance->UnregisterNPC(this);
+	}
 }
 
 float AShooterNPC::TakeDamage(float Damage, struct FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser)
@@ -63,6 +105,10 @@ void AShooterNPC::AttachWeaponMeshes(AShooterWeapon* WeaponToAttach)
 	// attach the weapon meshes
 	WeaponToAttach->GetFirstPersonMesh()->AttachToComponent(GetFirstPersonMesh(), AttachmentRule, FirstPersonWeaponSocket);
 	WeaponToAttach->GetThirdPersonMesh()->AttachToComponent(GetMesh(), AttachmentRule, FirstPersonWeaponSocket);
+
+	// nobody sees the weapon's first person mesh either
+	WeaponToAttach->GetFirstPersonMesh()->SetComponentTickEnabled(false);
+	WeaponToAttach->GetFirstPersonMesh()->SetHiddenInGame(true);
 }
 
 void AShooterNPC::PlayFiringMontage(UAnimMontage* Montage)
@@ -188,6 +234,16 @@ void AShooterNPC::Die()
 		GM->IncrementTeamScore(TeamByte);
 	}
 
+	// stop managing our update rates and restore them to full so the ragdoll simulates smoothly
+	if (UShooterSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UShooterSignificanceSubsystem>())
+	{
+		Significance->UnregisterNPC(this);
+		SetSignificanceTier(EShooterSignificanceTier::High, Significance->GetTierSettings(EShooterSignificanceTier::High));
+	}
+
+	// stop dashing, hooking or crossing a traversal link, so we don't stay weightless
+	ResetTraversalState();
+
 	// disable capsule collision
 	GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 
@@ -195,10 +251,27 @@ void AShooterNPC::Die()
 	GetCharacterMovement()->StopMovementImmediately();
 	GetCharacterMovement()->StopActiveMovement();
 
-	// enable ragdoll physics on the third person mesh
-	GetMesh()->SetCollisionProfileName(RagdollCollisionProfile);
-	GetMesh()->SetSimulatePhysics(true);
-	GetMesh()->SetPhysicsBlendWeight(1.0f);
+	// ragdoll if there's room in the budget, otherwise fall back to the death animation
+	UShooterRagdollSubsystem* Ragdolls = GetWorld()->GetSubsystem<UShooterRagdollSubsystem>();
+
+	if (!Ragdolls || Ragdolls->TryStartRagdoll(this))
+	{
+		// enable ragdoll physics on the third person mesh
+		GetMesh()->SetCollisionProfileName(RagdollCollisionProfile);
+		GetMesh()->SetSimulatePhysics(true);
+		GetMesh()->SetPhysicsBlendWeight(1.0f);
+
+	} else if (DeathAnimation) {
+
+		GetMesh()->PlayAnimation(DeathAnimation, false);
+
+	} else {
+
+		UE_LOG(LogTemporalDash, Warning, TEXT("%s has no death animation to fall back on while the ragdoll budget is full, freezing its pose instead"), *GetClass()->GetName());
+
+		// hold the current pose so the corpse doesn't keep running its locomotion
+		GetMesh()->bPauseAnims = true;
+	}
 
 	// schedule actor destruction
 	GetWorld()->GetTimerManager().SetTimer(DeathTimer, this, &AShooterNPC::DeferredDestruction, DeferredDestructionTime, false);
@@ -206,9 +279,34 @@ void AShooterNPC::Die()
 
 void AShooterNPC::DeferredDestruction()
 {
+	// try to keep this NPC around for the next spawn
+	if (UShooterNPCPoolSubsystem* NPCPool = GetWorld()->GetSubsystem<UShooterNPCPoolSubsystem>())
+	{
+		if (NPCPool->ReleaseNPC(this))
+		{
+			return;
+		}
+	}
+
+	// the pool is full. Destroy the controller we kept for pooling along with the pawn
+	if (AController* OwningController = GetController())
+	{
+		OwningController->Destroy();
+	}
+
 	Destroy();
 }
 
+void AShooterNPC::SpawnWeapon()
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Owner = this;
+	SpawnParams.Instigator = this;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	Weapon = GetWorld()->SpawnActor<AShooterWeapon>(WeaponClass, GetActorTransform(), SpawnParams);
+}
+
 void AShooterNPC::StartShooting(AActor* ActorToShoot)
 {
 	// save the aim target
@@ -235,3 +333,162 @@ void AShooterNPC::StopShooting()
 		Weapon->StopFiring();
 	}
 }
+
+void AShooterNPC::SetSignificanceTier(EShooterSignificanceTier Tier, const FShooterSignificanceTierSettings& Settings)
+{
+	SignificanceTier = Tier;
+
+	// throttle movement.
+	// Actor tick is left alone since it only runs while dashing or hooked and needs to run at full rate then
+	GetCharacterMovement()->SetComponentTickInterval(Settings.MovementTickInterval);
+
+	// let the animation budget allocator pick the update rate if it's running, otherwise throttle the mesh tick directly
+	IAnimationBudgetAllocator* AnimBudget = IAnimationBudgetAllocator::Get(GetWorld());
+	USkeletalMeshComponentBudgeted* BudgetedMesh = Cast<USkeletalMeshComponentBudgeted>(GetMesh());
+
+	if (AnimBudget && AnimBudget->GetEnabled() && BudgetedMesh)
+	{
+		AnimBudget->SetComponentSignificance(BudgetedMesh, Settings.AnimSignificance, false, false, true, Settings.bAnimInterpolation);
+
+	} else {
+
+		GetMesh()->SetComponentTickInterval(Settings.AnimTickInterval);
+	}
+
+	// throttle the controller's StateTree and perception
+	if (AShooterAIController* AIController = Cast<AShooterAIController>(GetController()))
+	{
+		AIController->ApplySignificanceSettings(Settings);
+	}
+}
+
+void AShooterNPC::FreezeRagdoll()
+{
+	// stop simulating but keep the last simulated pose
+	GetMesh()->SetSimulatePhysics(false);
+	GetMesh()->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	GetMesh()->bNoSkeletonUpdate = true;
+}
+
+void AShooterNPC::ReturnToPool()
+{
+	// clear the death timer in case we were pooled early
+	GetWorld()->GetTimerManager().ClearTimer(DeathTimer);
+
+	// stop the weapon
+	StopShooting();
+	CurrentAimTarget = nullptr;
+
+	// we may be pooled early, while still dashing, hooking or traversing
+	ResetTraversalState();
+
+	// stop managing our update rates
+	if (UShooterSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UShooterSignificanceSubsystem>())
+	{
+		Significance->UnregisterNPC(this);
+		SetSignificanceTier(EShooterSignificanceTier::High, Significance->GetTierSettings(EShooterSignificanceTier::High));
+	}
+
+	// release our ragdoll slot
+	if (UShooterRagdollSubsystem* Ragdolls = GetWorld()->GetSubsystem<UShooterRagdollSubsystem>())
+	{
+		Ragdolls->StopRagdoll(this);
+	}
+
+	// stop the ragdoll and put the mesh back on the capsule
+	GetMesh()->SetSimulatePhysics(false);
+	GetMesh()->bNoSkeletonUpdate = false;
+	GetMesh()->SetPhysicsBlendWeight(0.0f);
+	GetMesh()->SetCollisionProfileName(MeshCollisionProfile);
+	GetMesh()->AttachToComponent(GetCapsuleComponent(), FAttachmentTransformRules::KeepRelativeTransform);
+	GetMesh()->SetRelativeTransform(MeshRelativeTransform);
+
+	// stop animating and moving while pooled. The animation budget would turn the mesh tick back on, so leave it too
+	if (USkeletalMeshComponentBudgeted* BudgetedMesh = Cast<USkeletalMeshComponentBudgeted>(GetMesh()))
+	{
+		if (IAnimationBudgetAllocator* AnimBudget = IAnimationBudgetAllocator::Get(GetWorld()))
+		{
+			AnimBudget->UnregisterComponent(BudgetedMesh);
+		}
+	}
+
+	GetMesh()->SetComponentTickEnabled(false);
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->SetComponentTickEnabled(false);
+
+	// hide and disable collision
+	GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	SetActorHiddenInGame(true);
+
+	if (IsValid(Weapon))
+	{
+		Weapon->SetActorHiddenInGame(true);
+	}
+
+	// stop the StateTree and perception
+	if (AShooterAIController* AIController = Cast<AShooterAIController>(GetController()))
+	{
+		AIController->DeactivateForPool();
+	}
+}
+
+void AShooterNPC::ReuseFromPool(const FTransform& Transform)
+{
+	// move to the spawn location
+	SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+
+	// clear any jumps or presses left over from the last life
+	ResetTraversalState();
+
+	// reset health
+	CurrentHP = GetClass()->GetDefaultObject<AShooterNPC>()->CurrentHP;
+	bIsDead = false;
+	bIsShooting = false;
+
+	// restore collision, movement and animation
+	GetCapsuleComponent()->SetCollisionEnabled(CapsuleCollision);
+	GetCharacterMovement()->SetComponentTickEnabled(true);
+	GetCharacterMovement()->SetMovementMode(MOVE_Walking);
+	GetMesh()->SetComponentTickEnabled(true);
+
+	if (USkeletalMeshComponentBudgeted* BudgetedMesh = Cast<USkeletalMeshComponentBudgeted>(GetMesh()))
+	{
+		if (IAnimationBudgetAllocator* AnimBudget = IAnimationBudgetAllocator::Get(GetWorld()))
+		{
+			AnimBudget->RegisterComponent(BudgetedMesh);
+		}
+	}
+
+	// go back to the anim blueprint if we played the death animation, or unfreeze it if we didn't have one
+	if (GetMesh()->GetAnimationMode() != EAnimationMode::AnimationBlueprint)
+	{
+		GetMesh()->SetAnimationMode(EAnimationMode::AnimationBlueprint);
+	}
+
+	GetMesh()->bPauseAnims = false;
+
+	SetActorHiddenInGame(false);
+
+	// refill the weapon, or replace it if it was discarded
+	if (IsValid(Weapon))
+	{
+		Weapon->RefillAmmo();
+		Weapon->SetActorHiddenInGame(false);
+
+	} else {
+
+		SpawnWeapon();
+	}
+
+	// have our update rates managed again
+	if (UShooterSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UShooterSignificanceSubsystem>())
+	{
+		Significance->RegisterNPC(this);
+	}
+
+	// restart the StateTree and perception
+	if (AShooterAIController* AIController = Cast<AShooterAIController>(GetController()))
+	{
+		AIController->ReactivateFromPool();
+	}
+}
@@ -5,11 +5,13 @@
 #include "CoreMinimal.h"
 #include "TemporalDashCharacter.h"
 #include "ShooterWeaponHolder.h"
+#include "ShooterSignificanceSubsystem.h"
 #include "ShooterNPC.generated.h"
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FPawnDeathDelegate);
 
 class AShooterWeapon;
+class UAnimationAsset;
 
 /**
  *  A simple AI-controlled shooter game NPC
@@ -33,6 +35,10 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Damage")
 	FName RagdollCollisionProfile = FName("Ragdoll");
 
+	/** Animation to play on death when the ragdoll budget is full. Holds its last frame. Without one, the pose is frozen where it was */
+	UPROPERTY(EditAnywhere, Category="Damage")
+	TObjectPtr<UAnimationAsset> DeathAnimation;
+
 	/** Time to wait after death before destroying this actor */
 	UPROPERTY(EditAnywhere, Category="Damage")
 	float DeferredDestructionTime = 5.0f;
@@ -84,11 +90,22 @@ protected:
 	/** Deferred destruction on death timer */
 	FTimerHandle DeathTimer;
 
+	/** Current significance tier. Set by the significance subsystem */
+	EShooterSignificanceTier SignificanceTier = EShooterSignificanceTier::High;
+
+	/** Mesh state saved on BeginPlay, restored when the ragdoll is reset for pooling */
+	FName MeshCollisionProfile;
+	FTransform MeshRelativeTransform;
+	ECollisionEnabled::Type CapsuleCollision = ECollisionEnabled::QueryAndPhysics;
+
 public:
 
 	/** Delegate called when this NPC dies */
 	FPawnDeathDelegate OnPawnDeath;
 
+	/** Constructor */
+	AShooterNPC(const FObjectInitializer& ObjectInitializer);
+
 protected:
 
 	/** Gameplay initialization */
@@ -143,9 +160,12 @@ protected:
 	/** Called when HP is depleted and the character should die */
 	void Die();
 
-	/** Called after death to destroy the actor */
+	/** Called after death to return the actor to the NPC pool, or destroy it if the pool is full */
 	void DeferredDestruction();
 
+	/** Spawns and attaches the weapon */
+	void SpawnWeapon();
+
 public:
 
 	/** Signals this character to start shooting at the passed actor */
@@ -153,4 +173,19 @@ public:
 
 	/** Signals this character to stop shooting */
 	void StopShooting();
+
+	/** Applies the update rates for a new significance tier to this NPC and its controller */
+	void SetSignificanceTier(EShooterSignificanceTier Tier, const FShooterSignificanceTierSettings& Settings);
+
+	/** Returns the current significance tier */
+	EShooterSignificanceTier GetSignificanceTier() const { return SignificanceTier; };
+
+	/** Stops the ragdoll simulation and holds the current pose. Called by the ragdoll budget once the ragdoll comes to rest */
+	void FreezeRagdoll();
+
+	/** Resets the ragdoll, hides this NPC and stops its controller so it can wait in the NPC pool */
+	void ReturnToPool();
+
+	/** Brings this NPC back from the NPC pool at a new transform with full health and ammo */
+	void ReuseFromPool(const FTransform& Transform);
 };
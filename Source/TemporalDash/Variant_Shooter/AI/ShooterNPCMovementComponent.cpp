@@ -0,0 +1,83 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/AI/ShooterNPCMovementComponent.h"
+#include "TemporalDash.h"
+
+DECLARE_CYCLE_STAT(TEXT("NPC Movement Walking"), STAT_ShooterNPCMovementWalking, STATGROUP_ShooterAI);
+DECLARE_CYCLE_STAT(TEXT("NPC Movement Nav Walking"), STAT_ShooterNPCMovementNavWalking, STATGROUP_ShooterAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("NPCs Walking"), STAT_ShooterNPCsWalking, STATGROUP_ShooterAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("NPCs Nav Walking"), STAT_ShooterNPCsNavWalking, STATGROUP_ShooterAI);
+
+double UShooterNPCMovementComponent::WalkingTickTime = 0.0;
+int64 UShooterNPCMovementComponent::NumWalkingTicks = 0;
+double UShooterNPCMovementComponent::NavWalkingTickTime = 0.0;
+int64 UShooterNPCMovementComponent::NumNavWalkingTicks = 0;
+
+UShooterNPCMovementComponent::UShooterNPCMovementComponent()
+{
+	// nav walking follows the navmesh polygons and only traces down to the geometry now and then to keep the feet on it
+	bSweepWhileNavWalking = false;
+	bProjectNavMeshWalking = true;
+	NavMeshProjectionInterval = 0.2f;
+	NavMeshProjectionHeightScaleUp = 0.67f;
+	NavMeshProjectionHeightScaleDown = 1.0f;
+
+	// nav walking needs an agent that can walk
+	NavAgentProps.bCanWalk = true;
+}
+
+void UShooterNPCMovementComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	const bool bNavWalking = MovementMode == MOVE_NavWalking;
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
+	{
+		CONDITIONAL_SCOPE_CYCLE_COUNTER(STAT_ShooterNPCMovementWalking, !bNavWalking);
+		CONDITIONAL_SCOPE_CYCLE_COUNTER(STAT_ShooterNPCMovementNavWalking, bNavWalking);
+
+		Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	}
+
+	const double TickTime = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+
+	if (bNavWalking)
+	{
+		NavWalkingTickTime += TickTime;
+		++NumNavWalkingTicks;
+		INC_DWORD_STAT(STAT_ShooterNPCsNavWalking);
+
+	} else {
+
+		WalkingTickTime += TickTime;
+		++NumWalkingTicks;
+		INC_DWORD_STAT(STAT_ShooterNPCsWalking);
+	}
+}
+
+void UShooterNPCMovementComponent::SetUseNavWalking(bool bNavWalking)
+{
+	// don't interrupt falling, flying or any custom movement
+	if (bNavWalking && MovementMode == MOVE_Walking)
+	{
+		SetMovementMode(MOVE_NavWalking);
+
+	} else if (!bNavWalking && MovementMode == MOVE_NavWalking) {
+
+		SetMovementMode(MOVE_Walking);
+	}
+}
+
+void UShooterNPCMovementComponent::DumpTickCost()
+{
+	const double WalkingCost = NumWalkingTicks > 0 ? WalkingTickTime / NumWalkingTicks * 1000000.0 : 0.0;
+	const double NavWalkingCost = NumNavWalkingTicks > 0 ? NavWalkingTickTime / NumNavWalkingTicks * 1000000.0 : 0.0;
+
+	UE_LOG(LogTemporalDash, Display, TEXT("NPC movement: walking %.1fus per NPC tick (%lld ticks), nav walking %.1fus per NPC tick (%lld ticks). Saved %.1fus per nav walking NPC tick"),
+		WalkingCost, NumWalkingTicks, NavWalkingCost, NumNavWalkingTicks, WalkingCost - NavWalkingCost);
+}
+
+static FAutoConsoleCommand CmdDumpMovementCost(
+	TEXT("ShooterAI.DumpMovementCost"),
+	TEXT("Logs the average NPC movement tick cost with full walking physics and with nav walking"),
+	FConsoleCommandDelegate::CreateStatic(&UShooterNPCMovementComponent::DumpTickCost));
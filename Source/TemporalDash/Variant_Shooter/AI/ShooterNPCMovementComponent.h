@@ -0,0 +1,40 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "ShooterNPCMovementComponent.generated.h"
+
+/**
+ *  Character movement for shooter NPCs
+ *  Low significance NPCs can switch to nav walking, which follows the navmesh instead of sweeping for floors and step ups
+ *  Keeps track of the tick cost in each mode so the savings can be reported
+ */
+UCLASS()
+class TEMPORALDASH_API UShooterNPCMovementComponent : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Total tick time and tick count in each mode, across all NPCs */
+	static double WalkingTickTime;
+	static int64 NumWalkingTicks;
+	static double NavWalkingTickTime;
+	static int64 NumNavWalkingTicks;
+
+public:
+
+	/** Constructor */
+	UShooterNPCMovementComponent();
+
+	/** Measures the tick cost for the current movement mode */
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/** Switches between nav walking and full walking physics. Only affects NPCs that are on the ground */
+	void SetUseNavWalking(bool bNavWalking);
+
+	/** Logs the average tick cost per NPC in each mode */
+	static void DumpTickCost();
+};
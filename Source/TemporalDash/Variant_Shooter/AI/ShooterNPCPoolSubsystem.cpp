@@ -0,0 +1,101 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/AI/ShooterNPCPoolSubsystem.h"
+#include "TemporalDash.h"
+#include "ShooterNPC.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("NPC Pool Spawn"), STAT_ShooterNPCPoolSpawn, STATGROUP_ShooterAI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("NPC Pool Reuses"), STAT_ShooterNPCPoolReuses, STATGROUP_ShooterAI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("NPC Pool New Spawns"), STAT_ShooterNPCPoolNewSpawns, STATGROUP_ShooterAI);
+
+bool UShooterNPCPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterNPCPoolSubsystem::Deinitialize()
+{
+	Pool.Empty();
+
+	Super::Deinitialize();
+}
+
+AShooterNPC* UShooterNPCPoolSubsystem::SpawnNPC(TSubclassOf<AShooterNPC> NPCClass, const FTransform& Transform)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShooterNPCPoolSpawn);
+
+	if (!NPCClass)
+	{
+		return nullptr;
+	}
+
+	// reuse a pooled NPC if we have one
+	if (FShooterNPCPoolBucket* Bucket = Pool.Find(NPCClass))
+	{
+		while (!Bucket->NPCs.IsEmpty())
+		{
+			AShooterNPC* NPC = Bucket->NPCs.Pop(EAllowShrinking::No);
+
+			// skip NPCs destroyed while pooled, e.g. by a level unload
+			if (IsValid(NPC))
+			{
+				INC_DWORD_STAT(STAT_ShooterNPCPoolReuses);
+
+				NPC->ReuseFromPool(Transform);
+				return NPC;
+			}
+		}
+	}
+
+	// nothing pooled, so spawn a new one
+	INC_DWORD_STAT(STAT_ShooterNPCPoolNewSpawns);
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	return GetWorld()->SpawnActor<AShooterNPC>(NPCClass, Transform, SpawnParams);
+}
+
+void UShooterNPCPoolSubsystem::PrewarmNPCs(TSubclassOf<AShooterNPC> NPCClass, int32 Count, const FTransform& Transform)
+{
+	if (!NPCClass)
+	{
+		return;
+	}
+
+	// don't spawn more than the pool can hold
+	const int32 NumToSpawn = FMath::Min(Count, MaxPooledPerClass - Pool.FindOrAdd(NPCClass).NPCs.Num());
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	for (int32 i = 0; i < NumToSpawn; ++i)
+	{
+		if (AShooterNPC* NPC = GetWorld()->SpawnActor<AShooterNPC>(NPCClass, Transform, SpawnParams))
+		{
+			ReleaseNPC(NPC);
+		}
+	}
+}
+
+bool UShooterNPCPoolSubsystem::ReleaseNPC(AShooterNPC* NPC)
+{
+	if (!IsValid(NPC))
+	{
+		return false;
+	}
+
+	FShooterNPCPoolBucket& Bucket = Pool.FindOrAdd(NPC->GetClass());
+
+	if (Bucket.NPCs.Num() >= MaxPooledPerClass)
+	{
+		return false;
+	}
+
+	NPC->ReturnToPool();
+	Bucket.NPCs.Add(NPC);
+
+	return true;
+}
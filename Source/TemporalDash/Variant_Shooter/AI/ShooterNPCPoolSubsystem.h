@@ -0,0 +1,69 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterNPCPoolSubsystem.generated.h"
+
+class AShooterNPC;
+
+/** Pooled NPCs of a single class */
+USTRUCT()
+struct FShooterNPCPoolBucket
+{
+	GENERATED_BODY()
+
+	/** NPCs waiting to be reused */
+	UPROPERTY()
+	TArray<TObjectPtr<AShooterNPC>> NPCs;
+};
+
+/**
+ *  Reuses dead shooter NPCs instead of destroying them and spawning new ones
+ *  Pooled NPCs keep their AI controller, StateTree, perception and weapon, so reusing one
+ *  only resets its state instead of constructing and initializing all of them again
+ */
+UCLASS(config=Game)
+class TEMPORALDASH_API UShooterNPCPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Max number of pooled NPCs kept for each class. Extra NPCs are destroyed */
+	UPROPERTY(config, EditAnywhere, Category="NPC Pool", meta = (ClampMin = 0))
+	int32 MaxPooledPerClass = 16;
+
+	/** Pooled NPCs by class */
+	UPROPERTY(Transient)
+	TMap<TSubclassOf<AShooterNPC>, FShooterNPCPoolBucket> Pool;
+
+public:
+
+	/** Only game worlds run AI */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Drops the pooled NPCs */
+	virtual void Deinitialize() override;
+
+	/**
+	 *  Spawns an NPC, reusing a pooled one of the same class if there's one available
+	 *  @param NPCClass class of NPC to spawn
+	 *  @param Transform spawn transform
+	 */
+	UFUNCTION(BlueprintCallable, Category="NPC Pool")
+	AShooterNPC* SpawnNPC(TSubclassOf<AShooterNPC> NPCClass, const FTransform& Transform);
+
+	/**
+	 *  Spawns NPCs straight into the pool, so later waves don't pay for spawning them
+	 *  @param NPCClass class of NPC to spawn
+	 *  @param Count number of NPCs to add to the pool
+	 *  @param Transform where to spawn the NPCs. They stay hidden there until reused
+	 */
+	UFUNCTION(BlueprintCallable, Category="NPC Pool")
+	void PrewarmNPCs(TSubclassOf<AShooterNPC> NPCClass, int32 Count, const FTransform& Transform);
+
+	/** Deactivates an NPC and adds it to the pool. Returns false if its class pool is full, in which case the NPC should be destroyed */
+	bool ReleaseNPC(AShooterNPC* NPC);
+};
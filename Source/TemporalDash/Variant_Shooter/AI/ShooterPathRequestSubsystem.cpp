@@ -0,0 +1,240 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/AI/ShooterPathRequestSubsystem.h"
+#include "TemporalDash.h"
+#include "ShooterAIController.h"
+#include "ShooterNPC.h"
+#include "NavigationSystem.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Path Request Submission"), STAT_ShooterPathRequestTick, STATGROUP_ShooterAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Path Requests Queued"), STAT_ShooterPathRequestsQueued, STATGROUP_ShooterAI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Path Requests Submitted"), STAT_ShooterPathRequestsSubmitted, STATGROUP_ShooterAI);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Path Request Peak Frame (ms)"), STAT_ShooterPathRequestPeakFrame, STATGROUP_ShooterAI);
+
+bool UShooterPathRequestSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UShooterPathRequestSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterPathRequestSubsystem, STATGROUP_Tickables);
+}
+
+void UShooterPathRequestSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	SCOPE_CYCLE_COUNTER(STAT_ShooterPathRequestTick);
+
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
+	// gather the queued requests along with their NPC's significance
+	struct FQueuedRequest
+	{
+		FPathRequest* Request;
+		EShooterSignificanceTier Tier;
+	};
+
+	TArray<FQueuedRequest, TInlineAllocator<64>> Queued;
+
+	for (auto It = Requests.CreateIterator(); It; ++It)
+	{
+		FPathRequest& Request = It.Value();
+		AShooterAIController* Controller = Request.Controller.Get();
+
+		// drop requests from controllers that are gone
+		if (!Controller)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		if (Request.Status == EShooterPathRequestStatus::Pending && !Request.bSubmitted)
+		{
+			const AShooterNPC* NPC = Cast<AShooterNPC>(Controller->GetPawn());
+			Queued.Add({ &Request, NPC ? NPC->GetSignificanceTier() : EShooterSignificanceTier::High });
+		}
+	}
+
+	SET_DWORD_STAT(STAT_ShooterPathRequestsQueued, Queued.Num());
+
+	// most significant NPCs first, then the ones that have waited the longest
+	Queued.Sort([](const FQueuedRequest& A, const FQueuedRequest& B)
+	{
+		return A.Tier != B.Tier ? A.Tier < B.Tier : A.Request->QueueTime < B.Request->QueueTime;
+	});
+
+	// synchronous queries resolve everything right away, like a plain move request would
+	const int32 NumToSubmit = bUseAsyncQueries ? FMath::Min(Queued.Num(), MaxSubmissionsPerFrame) : Queued.Num();
+
+	for (int32 i = 0; i < NumToSubmit; ++i)
+	{
+		if (!SubmitRequest(*Queued[i].Request))
+		{
+			FinishRequest(*Queued[i].Request, false, nullptr);
+		}
+	}
+
+	// track the longest frame spent on path requests, including any results that arrived since the last tick
+	FrameCycles += FPlatformTime::Cycles64() - StartCycles;
+
+	PeakFrameTime = FMath::Max(PeakFrameTime, FPlatformTime::ToSeconds64(FrameCycles));
+	FrameCycles = 0;
+
+	SET_FLOAT_STAT(STAT_ShooterPathRequestPeakFrame, PeakFrameTime * 1000.0);
+}
+
+void UShooterPathRequestSubsystem::RequestPath(AShooterAIController* Controller, const FVector& Goal)
+{
+	if (!IsValid(Controller))
+	{
+		return;
+	}
+
+	// replace any previous request
+	CancelRequest(Controller);
+
+	FPathRequest& Request = Requests.Add(Controller);
+	Request.Controller = Controller;
+	Request.Goal = Goal;
+	Request.QueueTime = GetWorld()->GetTimeSeconds();
+}
+
+EShooterPathRequestStatus UShooterPathRequestSubsystem::GetPathResult(const AShooterAIController* Controller, FNavPathSharedPtr& OutPath) const
+{
+	const FPathRequest* Request = Requests.Find(Controller);
+
+	if (!Request)
+	{
+		return EShooterPathRequestStatus::None;
+	}
+
+	OutPath = Request->Path;
+
+	return Request->Status;
+}
+
+void UShooterPathRequestSubsystem::CancelRequest(const AShooterAIController* Controller)
+{
+	FPathRequest Request;
+
+	if (!Requests.RemoveAndCopyValue(Controller, Request))
+	{
+		return;
+	}
+
+	// stop the query if it's still running
+	if (Request.bSubmitted && Request.Status == EShooterPathRequestStatus::Pending)
+	{
+		if (UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld()))
+		{
+			NavSys->AbortAsyncFindPathRequest(Request.QueryId);
+		}
+	}
+}
+
+bool UShooterPathRequestSubsystem::SubmitRequest(FPathRequest& Request)
+{
+	AShooterAIController* Controller = Request.Controller.Get();
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+
+	if (!Controller || !NavSys)
+	{
+		return false;
+	}
+
+	// let the controller pick the nav data, filter and start location, same as it would for a regular move
+	FPathFindingQuery Query;
+
+	if (!Controller->BuildPathfindingQuery(FAIMoveRequest(Request.Goal), Query))
+	{
+		return false;
+	}
+
+	Request.bSubmitted = true;
+
+	++NumSubmitted;
+	INC_DWORD_STAT(STAT_ShooterPathRequestsSubmitted);
+
+	if (bUseAsyncQueries)
+	{
+		Request.QueryId = NavSys->FindPathAsync(Controller->GetNavAgentPropertiesRef(), Query, FNavPathQueryDelegate::CreateUObject(this, &UShooterPathRequestSubsystem::OnPathFound), EPathFindingMode::Regular);
+
+		return Request.QueryId != INVALID_NAVQUERYID;
+	}
+
+	const FPathFindingResult Result = NavSys->FindPathSync(Controller->GetNavAgentPropertiesRef(), Query, EPathFindingMode::Regular);
+	FinishRequest(Request, Result.IsSuccessful(), Result.Path);
+
+	return true;
+}
+
+void UShooterPathRequestSubsystem::OnPathFound(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path)
+{
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
+	for (TPair<TObjectKey<AShooterAIController>, FPathRequest>& Pair : Requests)
+	{
+		FPathRequest& Request = Pair.Value;
+
+		if (Request.bSubmitted && Request.QueryId == QueryId && Request.Status == EShooterPathRequestStatus::Pending)
+		{
+			FinishRequest(Request, Result == ENavigationQueryResult::Success && Path.IsValid(), Path);
+			break;
+		}
+	}
+
+	FrameCycles += FPlatformTime::Cycles64() - StartCycles;
+}
+
+void UShooterPathRequestSubsystem::FinishRequest(FPathRequest& Request, bool bSuccess, FNavPathSharedPtr Path)
+{
+	const double WaitTime = GetWorld()->GetTimeSeconds() - Request.QueueTime;
+	TotalWaitTime += WaitTime;
+	PeakWaitTime = FMath::Max(PeakWaitTime, WaitTime);
+
+	if (bSuccess)
+	{
+		// keep the path up to date when the navmesh changes under it, like a regular move would
+		Path->EnableRecalculationOnInvalidation(true);
+
+		Request.Path = Path;
+		Request.Status = EShooterPathRequestStatus::Succeeded;
+		++NumSucceeded;
+
+	} else {
+
+		Request.Path = nullptr;
+		Request.Status = EShooterPathRequestStatus::Failed;
+		++NumFailed;
+	}
+}
+
+void UShooterPathRequestSubsystem::DumpStats()
+{
+	const int64 NumFinished = NumSucceeded + NumFailed;
+	const double AverageWait = NumFinished > 0 ? TotalWaitTime / NumFinished * 1000.0 : 0.0;
+
+	UE_LOG(LogTemporalDash, Display, TEXT("Path requests (%s): %lld submitted, %lld succeeded, %lld failed. Wait %.1fms average, %.1fms peak. Longest frame spike %.3fms"),
+		bUseAsyncQueries ? TEXT("async") : TEXT("sync"), NumSubmitted, NumSucceeded, NumFailed, AverageWait, PeakWaitTime * 1000.0, PeakFrameTime * 1000.0);
+
+	// reset the peaks so the next dump covers a fresh window
+	PeakFrameTime = 0.0;
+	PeakWaitTime = 0.0;
+}
+
+static void DumpPathRequests(UWorld* World)
+{
+	if (UShooterPathRequestSubsystem* PathRequests = World->GetSubsystem<UShooterPathRequestSubsystem>())
+	{
+		PathRequests->DumpStats();
+	}
+}
+
+static FAutoConsoleCommandWithWorld CmdDumpPathRequests(
+	TEXT("ShooterAI.DumpPathRequests"),
+	TEXT("Logs the NPC path request counters and the longest path request frame spike, then resets the peaks"),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&DumpPathRequests));
@@ -0,0 +1,116 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "NavigationSystemTypes.h"
+#include "ShooterPathRequestSubsystem.generated.h"
+
+class AShooterAIController;
+
+/** State of an NPC's path request */
+enum class EShooterPathRequestStatus : uint8
+{
+	/** The NPC has no path request */
+	None,
+
+	/** The request is queued or the query is running. Check again next frame */
+	Pending,
+
+	/** A path was found */
+	Succeeded,
+
+	/** No path could be found */
+	Failed
+};
+
+/**
+ *  Queues NPC path requests and runs them as async navmesh queries on worker threads
+ *  Only a limited number of queries are submitted each frame, most significant NPCs first,
+ *  so a whole wave asking for paths at once doesn't stall the game thread
+ *  Each NPC controller has at most one request. Asking again replaces the previous one
+ */
+UCLASS(config=Game)
+class TEMPORALDASH_API UShooterPathRequestSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Max number of path queries submitted each frame */
+	UPROPERTY(config, EditAnywhere, Category="Path Requests", meta = (ClampMin = 1))
+	int32 MaxSubmissionsPerFrame = 8;
+
+	/** If false, every queued request is resolved synchronously on the game thread as soon as it's processed. Used to compare against async queries */
+	UPROPERTY(config, EditAnywhere, Category="Path Requests")
+	bool bUseAsyncQueries = true;
+
+	/** A path request for an NPC */
+	struct FPathRequest
+	{
+		TWeakObjectPtr<AShooterAIController> Controller;
+		FVector Goal = FVector::ZeroVector;
+		FNavPathSharedPtr Path;
+		double QueueTime = 0.0;
+		uint32 QueryId = INVALID_NAVQUERYID;
+		EShooterPathRequestStatus Status = EShooterPathRequestStatus::Pending;
+		bool bSubmitted = false;
+	};
+
+	/** Path requests by controller */
+	TMap<TObjectKey<AShooterAIController>, FPathRequest> Requests;
+
+	/** Game thread time spent on path requests since the last tick */
+	uint64 FrameCycles = 0;
+
+	/** Longest game thread time spent on path requests in a single frame */
+	double PeakFrameTime = 0.0;
+
+	/** Request counters */
+	int64 NumSubmitted = 0;
+	int64 NumSucceeded = 0;
+	int64 NumFailed = 0;
+
+	/** Total and longest time requests spent waiting for their path */
+	double TotalWaitTime = 0.0;
+	double PeakWaitTime = 0.0;
+
+public:
+
+	/** Only game worlds run AI */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Submits the next batch of queued path requests */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for the tickable */
+	virtual TStatId GetStatId() const override;
+
+	/** Queues a path request from the controller's pawn to the goal, replacing any previous request */
+	void RequestPath(AShooterAIController* Controller, const FVector& Goal);
+
+	/**
+	 *  Returns the state of the controller's path request
+	 *  @param OutPath found path, once the request succeeds
+	 */
+	EShooterPathRequestStatus GetPathResult(const AShooterAIController* Controller, FNavPathSharedPtr& OutPath) const;
+
+	/** Drops the controller's path request, aborting its query if it's running */
+	void CancelRequest(const AShooterAIController* Controller);
+
+	/** Logs the request counters and the longest frame spike, then resets the peaks */
+	void DumpStats();
+
+protected:
+
+	/** Builds and submits the query for a request. Returns false if it couldn't be submitted */
+	bool SubmitRequest(FPathRequest& Request);
+
+	/** Stores the result of a finished async query */
+	void OnPathFound(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path);
+
+	/** Updates a request with its query result */
+	void FinishRequest(FPathRequest& Request, bool bSuccess, FNavPathSharedPtr Path);
+};
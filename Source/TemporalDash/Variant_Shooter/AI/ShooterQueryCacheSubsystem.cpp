@@ -0,0 +1,219 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/AI/ShooterQueryCacheSubsystem.h"
+#include "TemporalDash.h"
+#include "ShooterAIController.h"
+#include "EnvironmentQuery/EnvQuery.h"
+#include "EnvironmentQuery/EnvQueryManager.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Query Cache Hits"), STAT_ShooterQueryCacheHits, STATGROUP_ShooterAI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Query Cache Misses"), STAT_ShooterQueryCacheMisses, STATGROUP_ShooterAI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Query Cache Joined In Flight"), STAT_ShooterQueryCacheJoined, STATGROUP_ShooterAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Query Cache Reservations"), STAT_ShooterQueryCacheReservations, STATGROUP_ShooterAI);
+
+bool UShooterQueryCacheSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+EShooterQueryClaim UShooterQueryCacheSubsystem::TryClaimLocation(UEnvQuery* Query, AShooterAIController* Querier, FVector& OutLocation)
+{
+	if (!Query || !IsValid(Querier) || !Querier->GetPawn())
+	{
+		return EShooterQueryClaim::Failed;
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	// drop old results about once a second
+	if (Now - LastEvictionTime > 1.0)
+	{
+		EvictExpired(Now);
+		LastEvictionTime = Now;
+	}
+
+	const FQueryKey Key = MakeKey(Query, Querier);
+
+	FQueryEntry* Entry = Cache.Find(Key);
+
+	// someone is already running this query, wait for it
+	if (Entry && Entry->bPending)
+	{
+		bool bAlreadyWaiting = false;
+		Entry->Waiters.Add(Querier, &bAlreadyWaiting);
+
+		if (!bAlreadyWaiting)
+		{
+			++NumJoined;
+			INC_DWORD_STAT(STAT_ShooterQueryCacheJoined);
+		}
+
+		return EShooterQueryClaim::Pending;
+	}
+
+	// fresh results?
+	if (Entry && Now - Entry->Time <= ResultLifetime)
+	{
+		// picking up the results we waited on isn't a hit, that was already counted
+		if (!Entry->Waiters.Contains(Querier))
+		{
+			++NumHits;
+			INC_DWORD_STAT(STAT_ShooterQueryCacheHits);
+		}
+
+		return ClaimLocation(*Entry, Querier, OutLocation) ? EShooterQueryClaim::Claimed : EShooterQueryClaim::Failed;
+	}
+
+	// run the query
+	++NumMisses;
+	INC_DWORD_STAT(STAT_ShooterQueryCacheMisses);
+
+	FQueryEntry& NewEntry = Cache.Add(Key);
+	NewEntry.Waiters.Add(Querier);
+	NewEntry.bPending = true;
+
+	FEnvQueryRequest Request(Query, Querier);
+	const int32 QueryId = Request.Execute(EEnvQueryRunMode::AllMatching, FQueryFinishedSignature::CreateUObject(this, &UShooterQueryCacheSubsystem::OnQueryFinished, Key));
+
+	// the query couldn't start
+	if (QueryId == INDEX_NONE)
+	{
+		Cache.Remove(Key);
+		return EShooterQueryClaim::Failed;
+	}
+
+	return EShooterQueryClaim::Pending;
+}
+
+void UShooterQueryCacheSubsystem::ReleaseReservation(const AShooterAIController* Querier)
+{
+	Reservations.Remove(Querier);
+}
+
+UShooterQueryCacheSubsystem::FQueryKey UShooterQueryCacheSubsystem::MakeKey(UEnvQuery* Query, const AShooterAIController* Querier) const
+{
+	// the target context falls back to the controller itself when there's no target
+	const AActor* Target = Querier->GetCurrentTarget();
+
+	if (!IsValid(Target))
+	{
+		Target = Querier;
+	}
+
+	const FVector TargetLocation = Target == Querier ? Querier->GetPawn()->GetActorLocation() : Target->GetActorLocation();
+	const FVector QuerierLocation = Querier->GetPawn()->GetActorLocation();
+
+	FQueryKey Key;
+	Key.Query = Query;
+	Key.Target = FObjectKey(Target);
+	Key.TargetCell = FIntVector(FMath::FloorToInt(TargetLocation.X / TargetQuantization), FMath::FloorToInt(TargetLocation.Y / TargetQuantization), FMath::FloorToInt(TargetLocation.Z / TargetQuantization));
+	Key.QuerierCell = FIntVector(FMath::FloorToInt(QuerierLocation.X / QuerierQuantization), FMath::FloorToInt(QuerierLocation.Y / QuerierQuantization), FMath::FloorToInt(QuerierLocation.Z / QuerierQuantization));
+
+	return Key;
+}
+
+bool UShooterQueryCacheSubsystem::ClaimLocation(const FQueryEntry& Entry, const AShooterAIController* Querier, FVector& OutLocation)
+{
+	const float ReservationRadiusSquared = FMath::Square(ReservationRadius);
+	const TObjectKey<AShooterAIController> QuerierKey(Querier);
+
+	for (const FVector& Location : Entry.Locations)
+	{
+		// skip locations near another NPC's claim
+		bool bReserved = false;
+
+		for (const TPair<TObjectKey<AShooterAIController>, FReservation>& Reservation : Reservations)
+		{
+			if (Reservation.Key != QuerierKey && FVector::DistSquared(Reservation.Value.Location, Location) <= ReservationRadiusSquared)
+			{
+				bReserved = true;
+				break;
+			}
+		}
+
+		if (bReserved)
+		{
+			continue;
+		}
+
+		// replaces any previous claim by this controller
+		Reservations.Add(QuerierKey, { Location, GetWorld()->GetTimeSeconds() });
+		SET_DWORD_STAT(STAT_ShooterQueryCacheReservations, Reservations.Num());
+
+		OutLocation = Location;
+		return true;
+	}
+
+	return false;
+}
+
+void UShooterQueryCacheSubsystem::OnQueryFinished(TSharedPtr<FEnvQueryResult> Result, FQueryKey Key)
+{
+	FQueryEntry* Entry = Cache.Find(Key);
+
+	if (!Entry)
+	{
+		return;
+	}
+
+	Entry->bPending = false;
+	Entry->Time = GetWorld()->GetTimeSeconds();
+	Entry->Locations.Reset();
+
+	// all matching results come sorted by score
+	if (Result.IsValid() && Result->IsSuccessful())
+	{
+		Entry->Locations.Reserve(Result->Items.Num());
+
+		for (int32 ItemIndex = 0; ItemIndex < Result->Items.Num(); ++ItemIndex)
+		{
+			Entry->Locations.Add(Result->GetItemAsLocation(ItemIndex));
+		}
+	}
+}
+
+void UShooterQueryCacheSubsystem::EvictExpired(double Now)
+{
+	for (auto It = Cache.CreateIterator(); It; ++It)
+	{
+		if (!It.Value().bPending && Now - It.Value().Time > ResultLifetime)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	for (auto It = Reservations.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().ResolveObjectPtr() || Now - It.Value().Time > ReservationLifetime)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	SET_DWORD_STAT(STAT_ShooterQueryCacheReservations, Reservations.Num());
+}
+
+void UShooterQueryCacheSubsystem::DumpStats() const
+{
+	const int64 NumRequests = NumHits + NumMisses + NumJoined;
+	const double HitRate = NumRequests > 0 ? 100.0 * (NumHits + NumJoined) / NumRequests : 0.0;
+
+	UE_LOG(LogTemporalDash, Display, TEXT("Query cache: %lld hits, %lld joined in flight, %lld misses (%.1f%% shared). %d cached results, %d reservations"),
+		NumHits, NumJoined, NumMisses, HitRate, Cache.Num(), Reservations.Num());
+}
+
+static void DumpQueryCache(UWorld* World)
+{
+	if (const UShooterQueryCacheSubsystem* QueryCache = World->GetSubsystem<UShooterQueryCacheSubsystem>())
+	{
+		QueryCache->DumpStats();
+	}
+}
+
+static FAutoConsoleCommandWithWorld CmdDumpQueryCache(
+	TEXT("ShooterAI.DumpQueryCache"),
+	TEXT("Logs the shared EQS query cache hit rate"),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&DumpQueryCache));
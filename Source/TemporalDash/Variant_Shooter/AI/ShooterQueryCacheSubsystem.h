@@ -0,0 +1,149 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "ShooterQueryCacheSubsystem.generated.h"
+
+class UEnvQuery;
+class AShooterAIController;
+struct FEnvQueryResult;
+
+/** Result of trying to claim a location from a shared query */
+enum class EShooterQueryClaim : uint8
+{
+	/** A location was claimed */
+	Claimed,
+
+	/** The query is still running. Try again next frame */
+	Pending,
+
+	/** The query found no locations, or all of them are claimed by other NPCs */
+	Failed
+};
+
+/**
+ *  Shares EQS location query results between NPCs
+ *  Results are cached by query template, target actor, quantized target location and quantized querier location,
+ *  so NPCs in the same area running the same query against the same target reuse one query run
+ *  Claimed locations are reserved, so two NPCs don't go for the same spot
+ */
+UCLASS(config=Game)
+class TEMPORALDASH_API UShooterQueryCacheSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Grid size used to quantize the target location. The target moving within a cell reuses the results */
+	UPROPERTY(config, EditAnywhere, Category="Query Cache", meta = (ClampMin = 1, Units = "cm"))
+	float TargetQuantization = 200.0f;
+
+	/** Grid size used to quantize the querier location. NPCs in the same cell share results */
+	UPROPERTY(config, EditAnywhere, Category="Query Cache", meta = (ClampMin = 1, Units = "cm"))
+	float QuerierQuantization = 1500.0f;
+
+	/** Max age of cached results */
+	UPROPERTY(config, EditAnywhere, Category="Query Cache", meta = (ClampMin = 0, ClampMax = 30, Units = "s"))
+	float ResultLifetime = 2.0f;
+
+	/** Locations this close to another NPC's reservation can't be claimed */
+	UPROPERTY(config, EditAnywhere, Category="Query Cache", meta = (ClampMin = 0, Units = "cm"))
+	float ReservationRadius = 150.0f;
+
+	/** Reservations are released after this long, in case the NPC never claims a new location */
+	UPROPERTY(config, EditAnywhere, Category="Query Cache", meta = (ClampMin = 0, Units = "s"))
+	float ReservationLifetime = 15.0f;
+
+	/** Key for a shared query */
+	struct FQueryKey
+	{
+		TObjectKey<UEnvQuery> Query;
+		FObjectKey Target;
+		FIntVector TargetCell;
+		FIntVector QuerierCell;
+
+		bool operator==(const FQueryKey& Other) const
+		{
+			return Query == Other.Query && Target == Other.Target && TargetCell == Other.TargetCell && QuerierCell == Other.QuerierCell;
+		}
+
+		friend uint32 GetTypeHash(const FQueryKey& Key)
+		{
+			return HashCombineFast(HashCombineFast(GetTypeHash(Key.Query), GetTypeHash(Key.Target)), HashCombineFast(GetTypeHash(Key.TargetCell), GetTypeHash(Key.QuerierCell)));
+		}
+	};
+
+	/** Results of a shared query */
+	struct FQueryEntry
+	{
+		/** Result locations, best score first */
+		TArray<FVector> Locations;
+
+		/** Controllers that ran or waited on the query. Each one only counts once in the hit rate */
+		TSet<TObjectKey<AShooterAIController>> Waiters;
+
+		/** World time the results arrived */
+		double Time = 0.0;
+
+		/** True while the query is running */
+		bool bPending = true;
+	};
+
+	/** A claimed location */
+	struct FReservation
+	{
+		FVector Location;
+		double Time;
+	};
+
+	/** Cached query results */
+	TMap<FQueryKey, FQueryEntry> Cache;
+
+	/** Claimed locations by controller */
+	TMap<TObjectKey<AShooterAIController>, FReservation> Reservations;
+
+	/** Time of the last pass to drop expired results and reservations */
+	double LastEvictionTime = 0.0;
+
+	/** Cache hit counters, for the hit rate */
+	int64 NumHits = 0;
+	int64 NumMisses = 0;
+	int64 NumJoined = 0;
+
+public:
+
+	/** Only game worlds run AI */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/**
+	 *  Claims the best unreserved location from the shared results of a query
+	 *  Runs the query if there are no fresh results for this key yet, in which case this returns Pending until it's done
+	 *  @param Query EQS template to run. Should return locations
+	 *  @param Querier NPC controller running the query. Its current target is part of the key
+	 *  @param OutLocation claimed location
+	 */
+	EShooterQueryClaim TryClaimLocation(UEnvQuery* Query, AShooterAIController* Querier, FVector& OutLocation);
+
+	/** Releases the location claimed by the controller */
+	void ReleaseReservation(const AShooterAIController* Querier);
+
+	/** Logs the cache hit rate */
+	void DumpStats() const;
+
+protected:
+
+	/** Builds the cache key for a query */
+	FQueryKey MakeKey(UEnvQuery* Query, const AShooterAIController* Querier) const;
+
+	/** Claims the first location that isn't reserved by another controller */
+	bool ClaimLocation(const FQueryEntry& Entry, const AShooterAIController* Querier, FVector& OutLocation);
+
+	/** Stores the results of a finished query */
+	void OnQueryFinished(TSharedPtr<FEnvQueryResult> Result, FQueryKey Key);
+
+	/** Drops expired results and reservations */
+	void EvictExpired(double Now);
+};
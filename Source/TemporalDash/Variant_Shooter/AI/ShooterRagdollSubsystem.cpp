@@ -0,0 +1,88 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/AI/ShooterRagdollSubsystem.h"
+#include "TemporalDash.h"
+#include "ShooterNPC.h"
+#include "Components/SkeletalMeshComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("Ragdoll Budget Tick"), STAT_ShooterRagdollTick, STATGROUP_ShooterAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Active Ragdolls"), STAT_ShooterActiveRagdolls, STATGROUP_ShooterAI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Ragdolls Over Budget"), STAT_ShooterRagdollsOverBudget, STATGROUP_ShooterAI);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Ragdolls Frozen"), STAT_ShooterRagdollsFrozen, STATGROUP_ShooterAI);
+
+bool UShooterRagdollSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UShooterRagdollSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterRagdollSubsystem, STATGROUP_Tickables);
+}
+
+void UShooterRagdollSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	SCOPE_CYCLE_COUNTER(STAT_ShooterRagdollTick);
+
+	const float SettleSpeedSquared = FMath::Square(SettleSpeed);
+
+	for (int32 i = ActiveRagdolls.Num() - 1; i >= 0; --i)
+	{
+		FActiveRagdoll& Ragdoll = ActiveRagdolls[i];
+		AShooterNPC* NPC = Ragdoll.NPC.Get();
+
+		if (!NPC)
+		{
+			ActiveRagdolls.RemoveAtSwap(i, EAllowShrinking::No);
+			continue;
+		}
+
+		Ragdoll.SimulationTime += DeltaTime;
+
+		// the root body is enough to tell if the ragdoll is still tumbling
+		if (NPC->GetMesh()->GetPhysicsLinearVelocity().SizeSquared() <= SettleSpeedSquared)
+		{
+			Ragdoll.RestTime += DeltaTime;
+
+		} else {
+
+			Ragdoll.RestTime = 0.0f;
+		}
+
+		if (Ragdoll.RestTime >= SettleTime || Ragdoll.SimulationTime >= MaxSimulationTime)
+		{
+			INC_DWORD_STAT(STAT_ShooterRagdollsFrozen);
+
+			NPC->FreezeRagdoll();
+			ActiveRagdolls.RemoveAtSwap(i, EAllowShrinking::No);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_ShooterActiveRagdolls, ActiveRagdolls.Num());
+}
+
+bool UShooterRagdollSubsystem::TryStartRagdoll(AShooterNPC* NPC)
+{
+	if (ActiveRagdolls.Num() >= MaxActiveRagdolls)
+	{
+		INC_DWORD_STAT(STAT_ShooterRagdollsOverBudget);
+		return false;
+	}
+
+	FActiveRagdoll& Ragdoll = ActiveRagdolls.AddDefaulted_GetRef();
+	Ragdoll.NPC = NPC;
+
+	SET_DWORD_STAT(STAT_ShooterActiveRagdolls, ActiveRagdolls.Num());
+
+	return true;
+}
+
+void UShooterRagdollSubsystem::StopRagdoll(AShooterNPC* NPC)
+{
+	ActiveRagdolls.RemoveAllSwap([NPC](const FActiveRagdoll& Ragdoll) { return Ragdoll.NPC == NPC; }, EAllowShrinking::No);
+
+	SET_DWORD_STAT(STAT_ShooterActiveRagdolls, ActiveRagdolls.Num());
+}
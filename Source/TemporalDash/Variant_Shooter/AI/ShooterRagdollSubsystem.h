@@ -0,0 +1,73 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterRagdollSubsystem.generated.h"
+
+class AShooterNPC;
+
+/**
+ *  Limits how many dead shooter NPCs simulate ragdoll physics at once
+ *  NPCs that die while the budget is full play a death animation instead
+ *  Ragdolls that come to rest, or simulate for too long, are frozen into a static pose to free up their slot
+ */
+UCLASS(config=Game)
+class TEMPORALDASH_API UShooterRagdollSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Max number of ragdolls simulating at once */
+	UPROPERTY(config, EditAnywhere, Category="Ragdolls", meta = (ClampMin = 0))
+	int32 MaxActiveRagdolls = 8;
+
+	/** Ragdolls slower than this are considered at rest */
+	UPROPERTY(config, EditAnywhere, Category="Ragdolls", meta = (ClampMin = 0, Units = "cm/s"))
+	float SettleSpeed = 5.0f;
+
+	/** Time a ragdoll needs to stay at rest before it's frozen */
+	UPROPERTY(config, EditAnywhere, Category="Ragdolls", meta = (ClampMin = 0, Units = "s"))
+	float SettleTime = 0.5f;
+
+	/** Ragdolls are frozen after simulating for this long, even if they're still moving */
+	UPROPERTY(config, EditAnywhere, Category="Ragdolls", meta = (ClampMin = 0, Units = "s"))
+	float MaxSimulationTime = 4.0f;
+
+	/** A simulating ragdoll */
+	struct FActiveRagdoll
+	{
+		TWeakObjectPtr<AShooterNPC> NPC;
+
+		/** Time spent simulating */
+		float SimulationTime = 0.0f;
+
+		/** Time spent at rest */
+		float RestTime = 0.0f;
+	};
+
+	/** Currently simulating ragdolls */
+	TArray<FActiveRagdoll> ActiveRagdolls;
+
+public:
+
+	/** Only game worlds run AI */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Freezes ragdolls that came to rest */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for the tickable */
+	virtual TStatId GetStatId() const override;
+
+	/** Claims a ragdoll slot for the NPC. Returns false if the budget is full */
+	bool TryStartRagdoll(AShooterNPC* NPC);
+
+	/** Releases the NPC's ragdoll slot, if it has one */
+	void StopRagdoll(AShooterNPC* NPC);
+
+	/** Returns the number of simulating ragdolls */
+	int32 GetNumActiveRagdolls() const { return ActiveRagdolls.Num(); };
+};
@@ -0,0 +1,195 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/AI/ShooterSensingSubsystem.h"
+#include "TemporalDash.h"
+#include "ShooterAIController.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Async/ParallelFor.h"
+
+DECLARE_CYCLE_STAT(TEXT("Sensing Pre-Pass"), STAT_ShooterSensingPrePass, STATGROUP_ShooterAI);
+DECLARE_CYCLE_STAT(TEXT("Sensing Gather"), STAT_ShooterSensingGather, STATGROUP_ShooterAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sensing Pairs"), STAT_ShooterSensingPairs, STATGROUP_ShooterAI);
+
+void FShooterSensingTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Subsystem)
+	{
+		Subsystem->RunPrePass();
+	}
+}
+
+FString FShooterSensingTickFunction::DiagnosticMessage()
+{
+	return TEXT("FShooterSensingTickFunction");
+}
+
+FName FShooterSensingTickFunction::DiagnosticContext(bool bDetailed)
+{
+	return FName(TEXT("ShooterSensing"));
+}
+
+bool UShooterSensingSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterSensingSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// run before anything else in the frame that might read the results
+	TickFunction.Subsystem = this;
+	TickFunction.bCanEverTick = true;
+	TickFunction.bStartWithTickEnabled = true;
+	TickFunction.bRunOnAnyThread = false;
+	TickFunction.TickGroup = TG_PrePhysics;
+	TickFunction.RegisterTickFunction(InWorld.PersistentLevel);
+}
+
+void UShooterSensingSubsystem::Deinitialize()
+{
+	if (TickFunction.IsTickFunctionRegistered())
+	{
+		TickFunction.UnRegisterTickFunction();
+	}
+
+	TickFunction.Subsystem = nullptr;
+
+	Super::Deinitialize();
+}
+
+void UShooterSensingSubsystem::RegisterController(AShooterAIController* Controller)
+{
+	if (IsValid(Controller))
+	{
+		Controllers.AddUnique(Controller);
+	}
+}
+
+void UShooterSensingSubsystem::UnregisterController(AShooterAIController* Controller)
+{
+	Controllers.RemoveSingleSwap(Controller, EAllowShrinking::No);
+}
+
+const FShooterSensingResult* UShooterSensingSubsystem::GetSensing(const AActor* NPC, const AActor* Threat) const
+{
+	const int32* NPCIndex = NPCIndices.Find(FObjectKey(NPC));
+	const int32* ThreatIndex = ThreatIndices.Find(FObjectKey(Threat));
+
+	if (!NPCIndex || !ThreatIndex)
+	{
+		return nullptr;
+	}
+
+	return &Results[*NPCIndex * ThreatLocations.Num() + *ThreatIndex];
+}
+
+void UShooterSensingSubsystem::RunPrePass()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShooterSensingPrePass);
+
+	NPCIndices.Reset();
+	ThreatIndices.Reset();
+	NPCLocations.Reset();
+	NPCForwards.Reset();
+	NPCTargets.Reset();
+	ThreatLocations.Reset();
+	ThreatForwards.Reset();
+
+	// adds a threat column, or returns the existing one
+	auto AddThreat = [this](const AActor* Threat)
+	{
+		int32& ThreatIndex = ThreatIndices.FindOrAdd(FObjectKey(Threat), INDEX_NONE);
+
+		if (ThreatIndex == INDEX_NONE)
+		{
+			ThreatIndex = ThreatLocations.Num();
+			ThreatLocations.Add(Threat->GetActorLocation());
+			ThreatForwards.Add(Threat->GetActorForwardVector());
+		}
+
+		return ThreatIndex;
+	};
+
+	// gather the transforms on the game thread
+	{
+		SCOPE_CYCLE_COUNTER(STAT_ShooterSensingGather);
+
+		for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+		{
+			if (const APawn* PlayerPawn = It->IsValid() ? (*It)->GetPawn() : nullptr)
+			{
+				AddThreat(PlayerPawn);
+			}
+		}
+
+		for (int32 i = Controllers.Num() - 1; i >= 0; --i)
+		{
+			const AShooterAIController* Controller = Controllers[i].Get();
+
+			if (!Controller)
+			{
+				Controllers.RemoveAtSwap(i, EAllowShrinking::No);
+				continue;
+			}
+
+			const APawn* NPC = Controller->GetPawn();
+
+			if (!NPC)
+			{
+				continue;
+			}
+
+			NPCIndices.Add(FObjectKey(NPC), NPCLocations.Num());
+			NPCLocations.Add(NPC->GetActorLocation());
+			NPCForwards.Add(NPC->GetActorForwardVector());
+
+			const AActor* Target = Controller->GetCurrentTarget();
+			NPCTargets.Add(IsValid(Target) ? AddThreat(Target) : INDEX_NONE);
+		}
+	}
+
+	const int32 NumThreats = ThreatLocations.Num();
+	const int32 NumNPCs = NPCLocations.Num();
+
+	Results.SetNumUninitialized(NumNPCs * NumThreats, EAllowShrinking::No);
+
+	INC_DWORD_STAT_BY(STAT_ShooterSensingPairs, NumNPCs * NumThreats);
+
+	if (NumThreats == 0)
+	{
+		return;
+	}
+
+	// compute the pairs. Each NPC writes its own row
+	ParallelFor(TEXT("ShooterSensing"), NumNPCs, MinBatchSize, [this, NumThreats](int32 NPCIndex)
+	{
+		const FVector& NPCLocation = NPCLocations[NPCIndex];
+		const FVector& NPCForward = NPCForwards[NPCIndex];
+
+		for (int32 ThreatIndex = 0; ThreatIndex < NumThreats; ++ThreatIndex)
+		{
+			const FVector ToThreat = ThreatLocations[ThreatIndex] - NPCLocation;
+			const float Distance = ToThreat.Size();
+			const FVector ThreatDir = Distance > UE_KINDA_SMALL_NUMBER ? ToThreat / Distance : FVector::ZeroVector;
+
+			FShooterSensingResult& Result = Results[NPCIndex * NumThreats + ThreatIndex];
+			Result.FacingDot = FVector::DotProduct(ThreatDir, NPCForward);
+
+			// closer threats that are looking our way are more dangerous
+			const float Proximity = 1.0f - FMath::Clamp(Distance / ThreatRange, 0.0f, 1.0f);
+			const float Awareness = FVector::DotProduct(ThreatForwards[ThreatIndex], -ThreatDir) * 0.5f + 0.5f;
+
+			Result.ThreatScore = Proximity * (0.5f + 0.5f * Awareness);
+
+			if (NPCTargets[NPCIndex] == ThreatIndex)
+			{
+				Result.ThreatScore += CurrentTargetBonus;
+			}
+		}
+	});
+}
@@ -0,0 +1,132 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineBaseTypes.h"
+#include "UObject/ObjectKey.h"
+#include "ShooterSensingSubsystem.generated.h"
+
+class AShooterAIController;
+class UShooterSensingSubsystem;
+
+/** Precomputed spatial relation between an NPC and a threat */
+struct FShooterSensingResult
+{
+	/** Dot product between the NPC's facing and the direction to the threat */
+	float FacingDot = -1.0f;
+
+	/** How threatening the threat is to this NPC, from 0 to 1 plus the current target bonus */
+	float ThreatScore = 0.0f;
+};
+
+/**
+ *  Tick function for the sensing pre-pass
+ *  Runs in PrePhysics and is a prerequisite of the NPC StateTree components, so results are ready before any StateTree ticks
+ */
+USTRUCT()
+struct FShooterSensingTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	/** Subsystem to run the pre-pass on */
+	UShooterSensingSubsystem* Subsystem = nullptr;
+
+	/** Runs the pre-pass */
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+
+	/** Returns the tick function name for diagnostics */
+	virtual FString DiagnosticMessage() override;
+
+	/** Returns the tick function context for diagnostics */
+	virtual FName DiagnosticContext(bool bDetailed) override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FShooterSensingTickFunction> : public TStructOpsTypeTraitsBase2<FShooterSensingTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+/**
+ *  Computes facing and threat scores between all shooter NPCs and their threats once per frame
+ *  NPC and threat transforms are gathered into contiguous arrays on the game thread, then the NPC-threat pairs run in a parallel loop
+ *  StateTree conditions and tasks read the results instead of computing them one by one. Sense Enemies uses the threat scores to decide
+ *  whether a newly seen threat is worth switching targets for
+ *  Threats are the player pawns plus each NPC's current target
+ */
+UCLASS(config=Game)
+class TEMPORALDASH_API UShooterSensingSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Distance at which a threat's score drops to zero */
+	UPROPERTY(config, EditAnywhere, Category="Sensing", meta = (ClampMin = 1, Units = "cm"))
+	float ThreatRange = 5000.0f;
+
+	/** Score added for the NPC's current target, so a new threat has to be clearly more dangerous to pull it away */
+	UPROPERTY(config, EditAnywhere, Category="Sensing", meta = (ClampMin = 0, ClampMax = 1))
+	float CurrentTargetBonus = 0.5f;
+
+	/** Min number of NPCs per parallel task */
+	UPROPERTY(config, EditAnywhere, Category="Sensing", meta = (ClampMin = 1))
+	int32 MinBatchSize = 16;
+
+	/** Pre-pass tick function */
+	FShooterSensingTickFunction TickFunction;
+
+	/** Registered NPC controllers */
+	TArray<TWeakObjectPtr<AShooterAIController>> Controllers;
+
+	/** Row index for each NPC pawn in the current frame's results */
+	TMap<FObjectKey, int32> NPCIndices;
+
+	/** Column index for each threat in the current frame's results */
+	TMap<FObjectKey, int32> ThreatIndices;
+
+	/** NPC transforms, gathered each frame */
+	TArray<FVector> NPCLocations;
+	TArray<FVector> NPCForwards;
+
+	/** Column of each NPC's current target, or INDEX_NONE */
+	TArray<int32> NPCTargets;
+
+	/** Threat transforms, gathered each frame */
+	TArray<FVector> ThreatLocations;
+	TArray<FVector> ThreatForwards;
+
+	/** Results for each NPC and threat pair, by NPC row then threat column */
+	TArray<FShooterSensingResult> Results;
+
+public:
+
+	/** Only game worlds run AI */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Registers the pre-pass tick function */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Unregisters the pre-pass tick function */
+	virtual void Deinitialize() override;
+
+	/** Adds an NPC controller to the pre-pass */
+	void RegisterController(AShooterAIController* Controller);
+
+	/** Removes an NPC controller from the pre-pass */
+	void UnregisterController(AShooterAIController* Controller);
+
+	/** Returns the pre-pass tick function, so other ticks can depend on it */
+	FShooterSensingTickFunction& GetTickFunction() { return TickFunction; };
+
+	/** Returns this frame's results between an NPC pawn and a threat, or nullptr if the pair wasn't computed */
+	const FShooterSensingResult* GetSensing(const AActor* NPC, const AActor* Threat) const;
+
+	/** Gathers the transforms and computes the results for this frame */
+	void RunPrePass();
+};
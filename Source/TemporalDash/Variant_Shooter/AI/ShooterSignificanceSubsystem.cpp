@@ -0,0 +1,291 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/AI/ShooterSignificanceSubsystem.h"
+#include "TemporalDash.h"
+#include "ShooterNPC.h"
+#include "ShooterAIController.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "ShooterNPCPoolSubsystem.h"
+#include "ShooterNPCMovementComponent.h"
+#include "IAnimationBudgetAllocator.h"
+#include "AnimationBudgetAllocatorParameters.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "TimerManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Significance Tick"), STAT_ShooterSignificanceTick, STATGROUP_ShooterAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("NPCs High"), STAT_ShooterSignificanceHigh, STATGROUP_ShooterAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("NPCs Medium"), STAT_ShooterSignificanceMedium, STATGROUP_ShooterAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("NPCs Low"), STAT_ShooterSignificanceLow, STATGROUP_ShooterAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("NPCs Dormant"), STAT_ShooterSignificanceDormant, STATGROUP_ShooterAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Significance Tier Changes"), STAT_ShooterSignificanceTierChanges, STATGROUP_ShooterAI);
+
+UShooterSignificanceSubsystem::UShooterSignificanceSubsystem()
+{
+	// set up the default tiers
+	FShooterSignificanceTierSettings& High = TierSettings.AddDefaulted_GetRef();
+	High.MaxDistance = 2500.0f;
+	High.MaxCount = 16;
+
+	FShooterSignificanceTierSettings& Medium = TierSettings.AddDefaulted_GetRef();
+	Medium.MaxDistance = 5000.0f;
+	Medium.MaxCount = 48;
+	Medium.ControllerTickInterval = 0.05f;
+	Medium.MovementTickInterval = 0.033f;
+	Medium.AnimTickInterval = 0.033f;
+	Medium.StateTreeTickInterval = 0.1f;
+	Medium.AnimSignificance = 0.6f;
+
+	FShooterSignificanceTierSettings& Low = TierSettings.AddDefaulted_GetRef();
+	Low.MaxDistance = 10000.0f;
+	Low.ControllerTickInterval = 0.2f;
+	Low.MovementTickInterval = 0.1f;
+	Low.AnimTickInterval = 0.1f;
+	Low.StateTreeTickInterval = 0.25f;
+	Low.AnimSignificance = 0.3f;
+	Low.bAnimInterpolation = false;
+	Low.bNavWalking = true;
+
+	FShooterSignificanceTierSettings& Dormant = TierSettings.AddDefaulted_GetRef();
+	Dormant.MaxDistance = UE_BIG_NUMBER;
+	Dormant.ControllerTickInterval = 0.5f;
+	Dormant.MovementTickInterval = 0.25f;
+	Dormant.AnimTickInterval = 0.5f;
+	Dormant.StateTreeTickInterval = 0.5f;
+	Dormant.AnimSignificance = 0.05f;
+	Dormant.bAnimInterpolation = false;
+	Dormant.bNavWalking = true;
+	Dormant.bSightEnabled = false;
+}
+
+bool UShooterSignificanceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterSignificanceSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (IAnimationBudgetAllocator* AnimBudget = IAnimationBudgetAllocator::Get(&InWorld))
+	{
+		FAnimationBudgetAllocatorParameters Parameters;
+		Parameters.BudgetInMs = AnimationBudgetMs;
+
+		AnimBudget->SetParameters(Parameters);
+		AnimBudget->SetEnabled(bUseAnimationBudget);
+	}
+}
+
+TStatId UShooterSignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterSignificanceSubsystem, STATGROUP_Tickables);
+}
+
+void UShooterSignificanceSubsystem::RegisterNPC(AShooterNPC* NPC)
+{
+	if (IsValid(NPC))
+	{
+		NPCs.AddUnique(NPC);
+	}
+}
+
+void UShooterSignificanceSubsystem::UnregisterNPC(AShooterNPC* NPC)
+{
+	NPCs.RemoveSingleSwap(NPC, EAllowShrinking::No);
+}
+
+const FShooterSignificanceTierSettings& UShooterSignificanceSubsystem::GetTierSettings(EShooterSignificanceTier Tier) const
+{
+	// config may have overridden the tiers with fewer entries, so fall back to the last one
+	if (TierSettings.IsEmpty())
+	{
+		static const FShooterSignificanceTierSettings FullRate;
+		return FullRate;
+	}
+
+	return TierSettings[FMath::Min(static_cast<int32>(Tier), TierSettings.Num() - 1)];
+}
+
+void UShooterSignificanceSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShooterSignificanceTick);
+
+	Super::Tick(DeltaTime);
+
+	// get the player's view. Without one there's nothing to score against
+	APlayerController* PC = GetWorld()->GetFirstPlayerController();
+
+	if (!PC || TierSettings.IsEmpty())
+	{
+		return;
+	}
+
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	// score all NPCs
+	ScoredNPCs.Reset();
+
+	for (int32 i = NPCs.Num() - 1; i >= 0; --i)
+	{
+		AShooterNPC* NPC = NPCs[i].Get();
+
+		if (!NPC)
+		{
+			NPCs.RemoveAtSwap(i, EAllowShrinking::No);
+			continue;
+		}
+
+		float Score = FVector::Dist(ViewLocation, NPC->GetActorLocation());
+
+		// NPCs in a fight matter more
+		const AShooterAIController* AIController = Cast<AShooterAIController>(NPC->GetController());
+		const bool bInCombat = AIController && AIController->GetCurrentTarget();
+
+		if (bInCombat)
+		{
+			Score *= CombatDistanceScale;
+		}
+
+		// NPCs we can't see matter less
+		const bool bOnScreen = NPC->WasRecentlyRendered(0.2f);
+
+		if (!bOnScreen)
+		{
+			Score *= OffscreenDistanceScale;
+		}
+
+		ScoredNPCs.Add({ NPC, Score, bInCombat || bOnScreen });
+	}
+
+	// most significant first
+	ScoredNPCs.Sort([](const FScoredNPC& A, const FScoredNPC& B) { return A.Score < B.Score; });
+
+	// fill the tiers in order
+	const int32 LastTier = FMath::Min(TierSettings.Num(), static_cast<int32>(EShooterSignificanceTier::Dormant) + 1) - 1;
+
+	int32 TierCounts[static_cast<int32>(EShooterSignificanceTier::Dormant) + 1] = {};
+
+	for (const FScoredNPC& Scored : ScoredNPCs)
+	{
+		const int32 CurrentTier = static_cast<int32>(Scored.NPC->GetSignificanceTier());
+
+		int32 NewTier = 0;
+
+		for (; NewTier < LastTier; ++NewTier)
+		{
+			const FShooterSignificanceTierSettings& Settings = TierSettings[NewTier];
+
+			// make it easier to stay in the current tier than to move into it
+			const float MaxDistance = Settings.MaxDistance + (NewTier == CurrentTier ? HysteresisDistance : 0.0f);
+
+			const bool bHasRoom = Settings.MaxCount <= 0 || TierCounts[NewTier] < Settings.MaxCount;
+
+			if (Scored.Score <= MaxDistance && bHasRoom)
+			{
+				break;
+			}
+		}
+
+		++TierCounts[NewTier];
+
+		if (NewTier != CurrentTier)
+		{
+			Scored.NPC->SetSignificanceTier(static_cast<EShooterSignificanceTier>(NewTier), TierSettings[NewTier]);
+
+			INC_DWORD_STAT(STAT_ShooterSignificanceTierChanges);
+		}
+
+		// go back to full physics as soon as the NPC comes into view or engages, even before its tier changes
+		if (UShooterNPCMovementComponent* NPCMovement = Cast<UShooterNPCMovementComponent>(Scored.NPC->GetCharacterMovement()))
+		{
+			NPCMovement->SetUseNavWalking(TierSettings[NewTier].bNavWalking && !Scored.bNeedsFullMovement);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_ShooterSignificanceHigh, TierCounts[static_cast<int32>(EShooterSignificanceTier::High)]);
+	SET_DWORD_STAT(STAT_ShooterSignificanceMedium, TierCounts[static_cast<int32>(EShooterSignificanceTier::Medium)]);
+	SET_DWORD_STAT(STAT_ShooterSignificanceLow, TierCounts[static_cast<int32>(EShooterSignificanceTier::Low)]);
+	SET_DWORD_STAT(STAT_ShooterSignificanceDormant, TierCounts[static_cast<int32>(EShooterSignificanceTier::Dormant)]);
+}
+
+static void RunAnimationBenchmark(const TArray<FString>& Args, UWorld* World)
+{
+	// usage: ShooterAI.AnimBenchmark <NPC class path> [NPC count] [seconds per phase]
+	UClass* NPCClass = Args.IsValidIndex(0) ? LoadClass<AShooterNPC>(nullptr, *Args[0]) : nullptr;
+	const int32 NumNPCs = Args.IsValidIndex(1) ? FCString::Atoi(*Args[1]) : 100;
+	const float PhaseTime = Args.IsValidIndex(2) ? FCString::Atof(*Args[2]) : 10.0f;
+
+	UShooterNPCPoolSubsystem* NPCPool = World->GetSubsystem<UShooterNPCPoolSubsystem>();
+	IAnimationBudgetAllocator* AnimBudget = IAnimationBudgetAllocator::Get(World);
+	const APawn* Player = World->GetFirstPlayerController() ? World->GetFirstPlayerController()->GetPawn() : nullptr;
+
+	if (!NPCClass || !NPCPool || !AnimBudget || !Player)
+	{
+		UE_LOG(LogTemporalDash, Warning, TEXT("Usage: ShooterAI.AnimBenchmark <NPC class path> [NPC count] [seconds per phase]. Needs a game world with a player pawn"));
+		return;
+	}
+
+	// spawn the NPCs in a grid in front of the player, facing them
+	const int32 Columns = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumNPCs)));
+	const float Spacing = 200.0f;
+	const FVector Forward = Player->GetActorForwardVector().GetSafeNormal2D();
+	const FVector Right = FVector::CrossProduct(FVector::UpVector, Forward);
+	const FVector GridOrigin = Player->GetActorLocation() + Forward * 1000.0f - Right * (Columns - 1) * Spacing * 0.5f;
+
+	for (int32 i = 0; i < NumNPCs; ++i)
+	{
+		const FVector Location = GridOrigin + Forward * (i / Columns) * Spacing + Right * (i % Columns) * Spacing;
+		NPCPool->SpawnNPC(NPCClass, FTransform((-Forward).Rotation(), Location));
+	}
+
+	// first phase runs every mesh at full rate, second phase runs under the budget.
+	// The CSV capture has the animation game thread and worker timings, split by the phase events
+	const bool bWasEnabled = AnimBudget->GetEnabled();
+	AnimBudget->SetEnabled(false);
+
+#if CSV_PROFILER
+	FCsvProfiler::Get()->BeginCapture();
+#endif
+	CSV_EVENT_GLOBAL(TEXT("AnimBudgetOff"));
+
+	UE_LOG(LogTemporalDash, Display, TEXT("Animation benchmark: %d NPCs, %.1fs without the animation budget, then %.1fs with it"), NumNPCs, PhaseTime, PhaseTime);
+
+	FTimerHandle PhaseTimer;
+	World->GetTimerManager().SetTimer(PhaseTimer, FTimerDelegate::CreateWeakLambda(World, [World, PhaseTime, bWasEnabled]()
+	{
+		if (IAnimationBudgetAllocator* Budget = IAnimationBudgetAllocator::Get(World))
+		{
+			Budget->SetEnabled(true);
+		}
+
+		CSV_EVENT_GLOBAL(TEXT("AnimBudgetOn"));
+
+		FTimerHandle EndTimer;
+		World->GetTimerManager().SetTimer(EndTimer, FTimerDelegate::CreateWeakLambda(World, [World, bWasEnabled]()
+		{
+			CSV_EVENT_GLOBAL(TEXT("AnimBenchmarkEnd"));
+
+#if CSV_PROFILER
+			FCsvProfiler::Get()->EndCapture();
+#endif
+
+			if (IAnimationBudgetAllocator* Budget = IAnimationBudgetAllocator::Get(World))
+			{
+				Budget->SetEnabled(bWasEnabled);
+			}
+
+			UE_LOG(LogTemporalDash, Display, TEXT("Animation benchmark done. Compare the Animation timings between the AnimBudgetOff and AnimBudgetOn events in the CSV capture"));
+
+		}), PhaseTime, false);
+
+	}), PhaseTime, false);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CmdAnimationBenchmark(
+	TEXT("ShooterAI.AnimBenchmark"),
+	TEXT("Spawns NPCs in front of the player and captures a CSV profile with the animation budget off, then on. Args: <NPC class path> [NPC count] [seconds per phase]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunAnimationBenchmark));
@@ -0,0 +1,152 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterSignificanceSubsystem.generated.h"
+
+class AShooterNPC;
+
+/** Update tier for a shooter NPC. Lower tiers update less often */
+UENUM(BlueprintType)
+enum class EShooterSignificanceTier : uint8
+{
+	/** Close to the player or in combat nearby. Full rate updates */
+	High,
+
+	/** Mid range. Slightly throttled updates */
+	Medium,
+
+	/** Far away or off screen. Heavily throttled updates */
+	Low,
+
+	/** Very far away. Minimal updates and no sight */
+	Dormant
+};
+
+/** Update rates for a significance tier */
+USTRUCT(BlueprintType)
+struct FShooterSignificanceTierSettings
+{
+	GENERATED_BODY()
+
+	/** Max score (scaled distance to the player) to be placed in this tier */
+	UPROPERTY(EditAnywhere, Category="Significance", meta = (ClampMin = 0, Units = "cm"))
+	float MaxDistance = 0.0f;
+
+	/** Max number of NPCs in this tier. Closest NPCs win, the rest fall to lower tiers. Zero is unlimited */
+	UPROPERTY(EditAnywhere, Category="Significance", meta = (ClampMin = 0))
+	int32 MaxCount = 0;
+
+	/** Tick interval for the AI controller */
+	UPROPERTY(EditAnywhere, Category="Significance", meta = (ClampMin = 0, ClampMax = 2, Units = "s"))
+	float ControllerTickInterval = 0.0f;
+
+	/** Tick interval for the character movement component */
+	UPROPERTY(EditAnywhere, Category="Significance", meta = (ClampMin = 0, ClampMax = 2, Units = "s"))
+	float MovementTickInterval = 0.0f;
+
+	/** Tick interval for the skeletal meshes. Drives the animation update rate when the animation budget is off */
+	UPROPERTY(EditAnywhere, Category="Significance", meta = (ClampMin = 0, ClampMax = 2, Units = "s"))
+	float AnimTickInterval = 0.0f;
+
+	/** If true, NPCs in this tier move with nav walking instead of full walking physics while off screen and out of combat */
+	UPROPERTY(EditAnywhere, Category="Significance")
+	bool bNavWalking = false;
+
+	/** Significance given to the animation budget allocator. More significant meshes get a bigger share of the budget */
+	UPROPERTY(EditAnywhere, Category="Significance", meta = (ClampMin = 0, ClampMax = 1))
+	float AnimSignificance = 1.0f;
+
+	/** If true, the animation budget allocator interpolates between the frames it skips */
+	UPROPERTY(EditAnywhere, Category="Significance")
+	bool bAnimInterpolation = true;
+
+	/** Tick interval for the StateTree component */
+	UPROPERTY(EditAnywhere, Category="Significance", meta = (ClampMin = 0, ClampMax = 2, Units = "s"))
+	float StateTreeTickInterval = 0.0f;
+
+	/** If false, the sight sense is disabled on the NPC's perception component */
+	UPROPERTY(EditAnywhere, Category="Significance")
+	bool bSightEnabled = true;
+};
+
+/**
+ *  Sorts all shooter NPCs into significance tiers every frame and throttles their updates per tier
+ *  NPCs are scored by distance to the player's view, scaled down while in combat and up while off screen
+ *  The lowest scores fill the higher tiers first, up to each tier's max distance and count
+ */
+UCLASS(config=Game)
+class TEMPORALDASH_API UShooterSignificanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Update settings for each tier, indexed by EShooterSignificanceTier */
+	UPROPERTY(config, EditAnywhere, Category="Significance")
+	TArray<FShooterSignificanceTierSettings> TierSettings;
+
+	/** If true, NPC animation is throttled by the animation budget allocator instead of the tier's anim tick interval */
+	UPROPERTY(config, EditAnywhere, Category="Animation Budget")
+	bool bUseAnimationBudget = true;
+
+	/** Game thread time the animation budget allocator aims to spend on NPC animation each frame */
+	UPROPERTY(config, EditAnywhere, Category="Animation Budget", meta = (ClampMin = 0.1, Units = "ms"))
+	float AnimationBudgetMs = 1.0f;
+
+	/** Distance scale for NPCs that have a target. Keeps fights at full rate from further away */
+	UPROPERTY(config, EditAnywhere, Category="Significance", meta = (ClampMin = 0, ClampMax = 1))
+	float CombatDistanceScale = 0.5f;
+
+	/** Distance scale for NPCs that haven't been rendered recently */
+	UPROPERTY(config, EditAnywhere, Category="Significance", meta = (ClampMin = 1, ClampMax = 10))
+	float OffscreenDistanceScale = 2.0f;
+
+	/** Extra distance an NPC must move past a tier's max distance before it drops out of it. Avoids thrashing at the edges */
+	UPROPERTY(config, EditAnywhere, Category="Significance", meta = (ClampMin = 0, Units = "cm"))
+	float HysteresisDistance = 300.0f;
+
+	/** Registered NPCs */
+	TArray<TWeakObjectPtr<AShooterNPC>> NPCs;
+
+	/** Scored NPC, used for sorting */
+	struct FScoredNPC
+	{
+		AShooterNPC* NPC;
+		float Score;
+
+		/** True if the NPC is on screen or in combat, so it needs full movement physics */
+		bool bNeedsFullMovement;
+	};
+
+	/** Scratch array reused each frame */
+	TArray<FScoredNPC> ScoredNPCs;
+
+public:
+
+	/** Constructor */
+	UShooterSignificanceSubsystem();
+
+	/** Only game worlds run AI */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Configures the animation budget allocator */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Scores, sorts and updates the tiers of all registered NPCs */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for the tickable */
+	virtual TStatId GetStatId() const override;
+
+	/** Adds an NPC to the significance updates */
+	void RegisterNPC(AShooterNPC* NPC);
+
+	/** Removes an NPC from the significance updates */
+	void UnregisterNPC(AShooterNPC* NPC);
+
+	/** Returns the update settings for the passed tier */
+	const FShooterSignificanceTierSettings& GetTierSettings(EShooterSignificanceTier Tier) const;
+};
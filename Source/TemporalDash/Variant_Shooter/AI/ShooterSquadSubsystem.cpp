@@ -0,0 +1,171 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/AI/ShooterSquadSubsystem.h"
+#include "TemporalDash.h"
+#include "ShooterAIController.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Squad LOS Checks Saved"), STAT_ShooterSquadChecksSaved, STATGROUP_ShooterAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Squad Sightings Published"), STAT_ShooterSquadSightingsPublished, STATGROUP_ShooterAI);
+
+bool UShooterSquadSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UShooterSquadSubsystem::RegisterMember(AShooterAIController* Member, FName TeamTag)
+{
+	if (IsValid(Member))
+	{
+		Squads.FindOrAdd(TeamTag).Members.AddUnique(Member);
+	}
+}
+
+void UShooterSquadSubsystem::UnregisterMember(AShooterAIController* Member, FName TeamTag)
+{
+	if (FShooterSquad* Squad = Squads.Find(TeamTag))
+	{
+		Squad->Members.RemoveSingleSwap(Member, EAllowShrinking::No);
+
+		// drop any sightings this member reported
+		Squad->Sightings.RemoveAllSwap([Member](const FShooterSquadSighting& Sighting) { return Sighting.Reporter == Member; }, EAllowShrinking::No);
+	}
+}
+
+void UShooterSquadSubsystem::PublishSighting(AShooterAIController* Reporter, AActor* Target)
+{
+	if (!IsValid(Reporter) || !IsValid(Target) || !Reporter->GetPawn())
+	{
+		return;
+	}
+
+	FShooterSquad* Squad = Squads.Find(Reporter->GetTeamTag());
+
+	if (!Squad)
+	{
+		return;
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	// drop expired or invalid sightings while we're here
+	Squad->Sightings.RemoveAllSwap([this, Now](const FShooterSquadSighting& Sighting)
+	{
+		return !Sighting.Target.IsValid() || !Sighting.Reporter.IsValid() || Now - Sighting.Time > SightingLifetime;
+	}, EAllowShrinking::No);
+
+	// keep one sighting per target and reporter
+	FShooterSquadSighting* Sighting = Squad->Sightings.FindByPredicate([Reporter, Target](const FShooterSquadSighting& Existing)
+	{
+		return Existing.Reporter == Reporter && Existing.Target == Target;
+	});
+
+	if (!Sighting)
+	{
+		Sighting = &Squad->Sightings.AddDefaulted_GetRef();
+		Sighting->Reporter = Reporter;
+		Sighting->Target = Target;
+	}
+
+	Sighting->TargetLocation = Target->GetActorLocation();
+	Sighting->ReporterLocation = Reporter->GetPawn()->GetActorLocation();
+	Sighting->Time = Now;
+
+	INC_DWORD_STAT(STAT_ShooterSquadSightingsPublished);
+}
+
+const FShooterSquadSighting* UShooterSquadSubsystem::FindSighting(const AShooterAIController* Member, const AActor* Target)
+{
+	if (!IsValid(Member) || !Member->GetPawn() || !IsValid(Target))
+	{
+		return nullptr;
+	}
+
+	const FShooterSquad* Squad = Squads.Find(Member->GetTeamTag());
+
+	if (!Squad)
+	{
+		return nullptr;
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	const FVector MemberLocation = Member->GetPawn()->GetActorLocation();
+
+	const FShooterSquadSighting* Best = nullptr;
+
+	for (const FShooterSquadSighting& Sighting : Squad->Sightings)
+	{
+		if (Sighting.Target == Target && CanShareSighting(Sighting, Member, MemberLocation, Now))
+		{
+			if (!Best || Sighting.Time > Best->Time)
+			{
+				Best = &Sighting;
+			}
+		}
+	}
+
+	if (Best)
+	{
+		INC_DWORD_STAT(STAT_ShooterSquadChecksSaved);
+	}
+
+	return Best;
+}
+
+const FShooterSquadSighting* UShooterSquadSubsystem::FindAnySighting(const AShooterAIController* Member, FName TargetTag)
+{
+	if (!IsValid(Member) || !Member->GetPawn())
+	{
+		return nullptr;
+	}
+
+	const FShooterSquad* Squad = Squads.Find(Member->GetTeamTag());
+
+	if (!Squad)
+	{
+		return nullptr;
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	const FVector MemberLocation = Member->GetPawn()->GetActorLocation();
+
+	const FShooterSquadSighting* Best = nullptr;
+
+	for (const FShooterSquadSighting& Sighting : Squad->Sightings)
+	{
+		const AActor* Target = Sighting.Target.Get();
+
+		if (Target && Target->ActorHasTag(TargetTag) && CanShareSighting(Sighting, Member, MemberLocation, Now))
+		{
+			if (!Best || Sighting.Time > Best->Time)
+			{
+				Best = &Sighting;
+			}
+		}
+	}
+
+	if (Best)
+	{
+		INC_DWORD_STAT(STAT_ShooterSquadChecksSaved);
+	}
+
+	return Best;
+}
+
+bool UShooterSquadSubsystem::CanShareSighting(const FShooterSquadSighting& Sighting, const AShooterAIController* Member, const FVector& MemberLocation, double Now) const
+{
+	// ignore our own sightings, those came from our own checks
+	if (Sighting.Reporter == Member || !Sighting.Reporter.IsValid())
+	{
+		return false;
+	}
+
+	if (Now - Sighting.Time > SightingLifetime)
+	{
+		return false;
+	}
+
+	return FVector::DistSquared(Sighting.ReporterLocation, MemberLocation) <= FMath::Square(SquadRadius);
+}
@@ -0,0 +1,90 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterSquadSubsystem.generated.h"
+
+class AShooterAIController;
+
+/** A confirmed sighting shared with the rest of the squad */
+struct FShooterSquadSighting
+{
+	/** Actor that was seen */
+	TWeakObjectPtr<AActor> Target;
+
+	/** Where the target was seen */
+	FVector TargetLocation = FVector::ZeroVector;
+
+	/** Where the reporting NPC was when it saw the target */
+	FVector ReporterLocation = FVector::ZeroVector;
+
+	/** Squad member that saw the target */
+	TWeakObjectPtr<AShooterAIController> Reporter;
+
+	/** World time of the sighting */
+	double Time = 0.0;
+};
+
+/**
+ *  Groups shooter NPCs into squads by team tag and shares their confirmed sightings
+ *  A member that sees an enemy publishes it to the squad blackboard. Nearby members can then act on it
+ *  without running their own line of sight checks
+ */
+UCLASS(config=Game)
+class TEMPORALDASH_API UShooterSquadSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Max distance between a member and the reporter for a sighting to be shared with it */
+	UPROPERTY(config, EditAnywhere, Category="Squad", meta = (ClampMin = 0, Units = "cm"))
+	float SquadRadius = 3000.0f;
+
+	/** Max age of a sighting before it's no longer shared */
+	UPROPERTY(config, EditAnywhere, Category="Squad", meta = (ClampMin = 0, ClampMax = 10, Units = "s"))
+	float SightingLifetime = 1.0f;
+
+	/** Members and shared sightings for a team */
+	struct FShooterSquad
+	{
+		TArray<TWeakObjectPtr<AShooterAIController>> Members;
+		TArray<FShooterSquadSighting> Sightings;
+	};
+
+	/** Squads, keyed by team tag */
+	TMap<FName, FShooterSquad> Squads;
+
+public:
+
+	/** Only game worlds run AI */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Adds a controller to its team's squad */
+	void RegisterMember(AShooterAIController* Member, FName TeamTag);
+
+	/** Removes a controller from its team's squad */
+	void UnregisterMember(AShooterAIController* Member, FName TeamTag);
+
+	/** Publishes a confirmed sighting of the target to the reporter's squad */
+	void PublishSighting(AShooterAIController* Reporter, AActor* Target);
+
+	/**
+	 *  Returns a fresh sighting of the target reported by another squad member within the squad radius
+	 *  Counts as a saved line of sight check when found
+	 */
+	const FShooterSquadSighting* FindSighting(const AShooterAIController* Member, const AActor* Target);
+
+	/**
+	 *  Returns the freshest sighting of any actor with the passed tag reported by another squad member within the squad radius
+	 *  Counts as a saved line of sight check when found
+	 */
+	const FShooterSquadSighting* FindAnySighting(const AShooterAIController* Member, FName TargetTag);
+
+protected:
+
+	/** Returns true if the sighting can be shared with the member */
+	bool CanShareSighting(const FShooterSquadSighting& Sighting, const AShooterAIController* Member, const FVector& MemberLocation, double Now) const;
+};
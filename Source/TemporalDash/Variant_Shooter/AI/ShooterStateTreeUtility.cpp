@@ -7,8 +7,58 @@
 #include "Camera/CameraComponent.h"
 #include "AIController.h"
 #include "Perception/AIPerceptionComponent.h"
+#include "Perception/AISense_Sight.h"
 #include "ShooterAIController.h"
 #include "StateTreeAsyncExecutionContext.h"
+#include "TemporalDashTraversalLink.h"
+#include "ShooterVisibilitySubsystem.h"
+#include "ShooterSquadSubsystem.h"
+#include "ShooterQueryCacheSubsystem.h"
+#include "ShooterSensingSubsystem.h"
+#include "ShooterPathRequestSubsystem.h"
+#include "Navigation/PathFollowingComponent.h"
+#include "GameFramework/CharacterMovementComponent.h"
+
+/** Returns the dot product between the character's facing and the direction to the target, from the sensing pre-pass if it has it */
+static float GetSensingFacingDot(const AShooterNPC* Character, const AActor* Target)
+{
+	if (const UShooterSensingSubsystem* Sensing = Character->GetWorld()->GetSubsystem<UShooterSensingSubsystem>())
+	{
+		if (const FShooterSensingResult* Result = Sensing->GetSensing(Character, Target))
+		{
+			return Result->FacingDot;
+		}
+	}
+
+	// not in this frame's pre-pass, so compute it here
+	const FVector TargetDir = (Target->GetActorLocation() - Character->GetActorLocation()).GetSafeNormal();
+
+	return FVector::DotProduct(TargetDir, Character->GetActorForwardVector());
+}
+
+/** Returns true if a newly seen actor is more of a threat than the current target, going by the sensing pre-pass scores */
+static bool ShouldSwitchTarget(const AShooterNPC* Character, const AActor* CurrentTarget, const AActor* NewTarget)
+{
+	if (!IsValid(CurrentTarget) || CurrentTarget == NewTarget)
+	{
+		return true;
+	}
+
+	if (const UShooterSensingSubsystem* Sensing = Character->GetWorld()->GetSubsystem<UShooterSensingSubsystem>())
+	{
+		const FShooterSensingResult* CurrentResult = Sensing->GetSensing(Character, CurrentTarget);
+		const FShooterSensingResult* NewResult = Sensing->GetSensing(Character, NewTarget);
+
+		// the current target's score includes the target bonus, so we don't flip between threats of similar danger
+		if (CurrentResult && NewResult)
+		{
+			return NewResult->ThreatScore > CurrentResult->ThreatScore;
+		}
+	}
+
+	// no scores for this pair, so go with the latest sighting
+	return true;
+}
 
 bool FStateTreeLineOfSightToTargetCondition::TestCondition(FStateTreeExecutionContext& Context) const
 {
@@ -21,9 +71,7 @@ bool FStateTreeLineOfSightToTargetCondition::TestCondition(FStateTreeExecutionCo
 	}
 	
 	// check if the character is facing towards the target
-	const FVector TargetDir = (InstanceData.Target->GetActorLocation() - InstanceData.Character->GetActorLocation()).GetSafeNormal();
-
-	const float FacingDot = FVector::DotProduct(TargetDir, InstanceData.Character->GetActorForwardVector());
+	const float FacingDot = GetSensingFacingDot(InstanceData.Character, InstanceData.Target);
 	const float MaxDot = FMath::Cos(FMath::DegreesToRadians(InstanceData.LineOfSightConeAngle));
 
 	// is the facing outside of our cone half angle?
@@ -32,35 +80,16 @@ bool FStateTreeLineOfSightToTargetCondition::TestCondition(FStateTreeExecutionCo
 		return !InstanceData.bMustHaveLineOfSight;
 	}
 
-	// get the target's bounding box
-	FVector CenterOfMass, Extent;
-	InstanceData.Target->GetActorBounds(true, CenterOfMass, Extent, false);
-
-	// divide the vertical extent by the number of line of sight checks we'll do
-	const float ExtentZOffset = Extent.Z * 2.0f / InstanceData.NumberOfVerticalLineOfSightChecks;
-
 	// get the character's camera location as the source for the line checks
 	const FVector Start = InstanceData.Character->GetFirstPersonCameraComponent()->GetComponentLocation();
 
-	// ignore the character and target. We want to ensure there's an unobstructed trace not counting them
-	FCollisionQueryParams QueryParams;
-	QueryParams.AddIgnoredActor(InstanceData.Character);
-	QueryParams.AddIgnoredActor(InstanceData.Target);
-
-	FHitResult OutHit;
-
-	// run a number of vertically offset line traces to the target location
-	for (int32 i = 0; i < InstanceData.NumberOfVerticalLineOfSightChecks - 1; ++i)
+	// read the latest batched result. The traces run async, so a new target reads as not visible for a frame or two
+	if (UShooterVisibilitySubsystem* Visibility = InstanceData.Character->GetWorld()->GetSubsystem<UShooterVisibilitySubsystem>())
 	{
-		// calculate the endpoint for the trace
-		const FVector End = CenterOfMass + FVector(0.0f, 0.0f, Extent.Z - ExtentZOffset * i);
-
-		InstanceData.Character->GetWorld()->LineTraceSingleByChannel(OutHit, Start, End, ECC_Visibility, QueryParams);
+		const int32 NumTraces = FMath::Max(InstanceData.NumberOfVerticalLineOfSightChecks - 1, 1);
 
-		// is the trace unobstructed?
-		if (!OutHit.bBlockingHit)
+		if (Visibility->GetLineOfSight(InstanceData.Character, InstanceData.Target, Start, NumTraces) == EShooterVisibility::Visible)
 		{
-			// we only need one unobstructed trace, so terminate early
 			return InstanceData.bMustHaveLineOfSight;
 		}
 	}
@@ -211,151 +240,283 @@ FText FStateTreeShootAtTargetTask::GetDescription(const FGuid& ID, FStateTreeDat
 }
 #endif // WITH_EDITOR
 
-EStateTreeRunStatus FStateTreeSenseEnemiesTask::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+/** Returns the line of sight between a sensing NPC and a sensed actor, from a squad member's fresh sighting or the batched traces */
+static EShooterVisibility GetSenseLineOfSight(const FStateTreeSenseEnemiesInstanceData& InstanceData, AActor* SensedActor)
 {
-	// have we transitioned from another state?
-	if (Transition.ChangeType == EStateTreeStateChangeType::Changed)
+	UWorld* World = InstanceData.Character->GetWorld();
+
+	UShooterSquadSubsystem* Squad = World->GetSubsystem<UShooterSquadSubsystem>();
+
+	// did a nearby squad member just see it? Then we can skip our own check
+	if (Squad && Squad->FindSighting(InstanceData.Controller, SensedActor))
 	{
-		// get the instance data
-		FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+		return EShooterVisibility::Visible;
+	}
+
+	UShooterVisibilitySubsystem* Visibility = World->GetSubsystem<UShooterVisibilitySubsystem>();
+	const EShooterVisibility Result = Visibility ? Visibility->GetLineOfSight(InstanceData.Character, SensedActor, InstanceData.Character->GetActorLocation()) : EShooterVisibility::Unknown;
+
+	// share confirmed sightings with the squad
+	if (Squad && Result == EShooterVisibility::Visible)
+	{
+		Squad->PublishSighting(InstanceData.Controller, SensedActor);
+	}
 
-		// bind the perception updated delegate on the controller
-		InstanceData.Controller->OnShooterPerceptionUpdated.BindLambda(
-			[WeakContext = Context.MakeWeakExecutionContext()](AActor* SensedActor, const FAIStimulus& Stimulus)
+	return Result;
+}
+
+/** Updates the Sense Enemies task outputs from a sensed actor */
+static void ProcessSensedActor(FStateTreeSenseEnemiesInstanceData& InstanceData, AActor* SensedActor, bool bDirectLOS, const FVector& StimulusLocation, float StimulusStrength)
+{
+	// check if we have a direct line of sight to the stimulus
+	if (bDirectLOS)
+	{
+		// stay on the current target unless the new one is more of a threat
+		if (!ShouldSwitchTarget(InstanceData.Character, InstanceData.TargetActor, SensedActor))
+		{
+			return;
+		}
+
+		// set the controller's target
+		InstanceData.Controller->SetCurrentTarget(SensedActor);
+
+		// set the task output
+		InstanceData.TargetActor = SensedActor;
+
+		// set the flags
+		InstanceData.bHasTarget = true;
+		InstanceData.bHasInvestigateLocation = false;
+
+	// no direct line of sight to target
+	} else {
+
+		// if we already have a target, ignore the partial sense and keep on them
+		if (!IsValid(InstanceData.TargetActor))
+		{
+			// is this stimulus stronger than the last one we had?
+			if (StimulusStrength > InstanceData.LastStimulusStrength)
 			{
-				// get the instance data inside the lambda
-				const FStateTreeStrongExecutionContext StrongContext = WeakContext.MakeStrongExecutionContext();
+				// update the stimulus strength
+				InstanceData.LastStimulusStrength = StimulusStrength;
 
-				if (FInstanceDataType* LambdaInstanceData = StrongContext.GetInstanceDataPtr<FInstanceDataType>())
-				{
-					if (SensedActor->ActorHasTag(LambdaInstanceData->SenseTag))
-					{
-						bool bDirectLOS = false;
-
-						// calculate the direction of the stimulus
-						const FVector StimulusDir = (Stimulus.StimulusLocation - LambdaInstanceData->Character->GetActorLocation()).GetSafeNormal();
-
-						// infer the angle from the dot product between the character facing and the stimulus direction
-						const float DirDot = FVector::DotProduct(StimulusDir, LambdaInstanceData->Character->GetActorForwardVector());
-						const float MaxDot = FMath::Cos(FMath::DegreesToRadians(LambdaInstanceData->DirectLineOfSightCone));
-
-						// is the direction within our perception cone?
-						if (DirDot >= MaxDot)
-						{
-							// run a line trace between the character and the sensed actor
-							FCollisionQueryParams QueryParams;
-							QueryParams.AddIgnoredActor(LambdaInstanceData->Character);
-							QueryParams.AddIgnoredActor(SensedActor);
-
-							FHitResult OutHit;
-
-							// we have direct line of sight if this trace is unobstructed
-							bDirectLOS = !LambdaInstanceData->Character->GetWorld()->LineTraceSingleByChannel(OutHit, LambdaInstanceData->Character->GetActorLocation(), SensedActor->GetActorLocation(), ECC_Visibility, QueryParams);
-
-						}
-
-						// check if we have a direct line of sight to the stimulus
-						if (bDirectLOS)
-						{
-							// set the controller's target
-							LambdaInstanceData->Controller->SetCurrentTarget(SensedActor);
-
-							// set the task output
-							LambdaInstanceData->TargetActor = SensedActor;
-
-							// set the flags
-							LambdaInstanceData->bHasTarget = true;
-							LambdaInstanceData->bHasInvestigateLocation = false;
-
-						// no direct line of sight to target
-						} else {
-
-							// if we already have a target, ignore the partial sense and keep on them
-							if (!IsValid(LambdaInstanceData->TargetActor))
-							{
-								// is this stimulus stronger than the last one we had?
-								if (Stimulus.Strength > LambdaInstanceData->LastStimulusStrength)
-								{
-									// update the stimulus strength
-									LambdaInstanceData->LastStimulusStrength = Stimulus.Strength;
-
-									// set the investigate location
-									LambdaInstanceData->InvestigateLocation = Stimulus.StimulusLocation;
-
-									// set the investigate flag
-									LambdaInstanceData->bHasInvestigateLocation = true;
-								}
-							}
-						}
-					}
-				}
+				// set the investigate location
+				InstanceData.InvestigateLocation = StimulusLocation;
+
+				// set the investigate flag
+				InstanceData.bHasInvestigateLocation = true;
 			}
-		);
+		}
+	}
+}
+
+/** Handles a sensed actor being forgotten */
+static void ProcessForgottenActor(FStateTreeSenseEnemiesInstanceData& InstanceData, AActor* SensedActor)
+{
+	// drop any pending sight confirmation for this actor
+	InstanceData.PendingSights.RemoveAll([SensedActor](const FShooterPendingSight& Pending) { return Pending.Actor == SensedActor; });
+
+	bool bForget = false;
+
+	// are we forgetting the current target?
+	if (SensedActor == InstanceData.TargetActor)
+	{
+		bForget = true;
+
+	} else {
+
+		// are we forgetting about a partial sense?
+		if (!IsValid(InstanceData.TargetActor))
+		{
+			bForget = true;
+		}
+	}
+
+	if (bForget)
+	{
+		// clear the target
+		InstanceData.TargetActor = nullptr;
+
+		// clear the flags
+		InstanceData.bHasInvestigateLocation = false;
+		InstanceData.bHasTarget = false;
+
+		// reset the stimulus strength
+		InstanceData.LastStimulusStrength = 0.0f;
+
+		// clear the target on the controller
+		InstanceData.Controller->ClearCurrentTarget();
+		InstanceData.Controller->ClearFocus(EAIFocusPriority::Gameplay);
+	}
+}
+
+/** Handles a perception update on a sensed actor */
+static void ProcessUpdatedActor(FStateTreeSenseEnemiesInstanceData& InstanceData, AActor* SensedActor, const FShooterPerceptionEvent& Event)
+{
+	if (!SensedActor->ActorHasTag(InstanceData.SenseTag))
+	{
+		return;
+	}
+
+	bool bDirectLOS = false;
+
+	float DirDot;
+
+	// sight stimuli come from the actor itself, so use the pre-pass facing
+	if (Event.Type == UAISense::GetSenseID<UAISense_Sight>())
+	{
+		DirDot = GetSensingFacingDot(InstanceData.Character, SensedActor);
+
+	} else {
+
+		// calculate the direction of the stimulus
+		const FVector StimulusDir = (Event.StimulusLocation - InstanceData.Character->GetActorLocation()).GetSafeNormal();
+
+		// infer the angle from the dot product between the character facing and the stimulus direction
+		DirDot = FVector::DotProduct(StimulusDir, InstanceData.Character->GetActorForwardVector());
+	}
 
-		// bind the perception forgotten delegate on the controller
-		InstanceData.Controller->OnShooterPerceptionForgotten.BindLambda(
-			[WeakContext = Context.MakeWeakExecutionContext()](AActor* SensedActor)
+	const float MaxDot = FMath::Cos(FMath::DegreesToRadians(InstanceData.DirectLineOfSightCone));
+
+	// is the direction within our perception cone?
+	if (DirDot >= MaxDot)
+	{
+		// get the batched line of sight between the character and the sensed actor
+		const EShooterVisibility Visibility = GetSenseLineOfSight(InstanceData, SensedActor);
+
+		// no result yet, so wait for the async traces and finish processing the stimulus on a later tick
+		if (Visibility == EShooterVisibility::Unknown)
+		{
+			// a newer stimulus from the same actor replaces the old one, but keeps its wait time
+			FShooterPendingSight* Pending = InstanceData.PendingSights.FindByPredicate([SensedActor](const FShooterPendingSight& Other) { return Other.Actor == SensedActor; });
+
+			if (!Pending)
 			{
-				// get the instance data inside the lambda
-				FInstanceDataType* LambdaInstanceData = WeakContext.MakeStrongExecutionContext().GetInstanceDataPtr<FInstanceDataType>();
+				Pending = &InstanceData.PendingSights.AddDefaulted_GetRef();
+				Pending->Actor = SensedActor;
+				Pending->Time = SensedActor->GetWorld()->GetTimeSeconds();
+			}
 
-				if (!LambdaInstanceData)
-				{
-					return;
-				}
+			Pending->StimulusLocation = Event.StimulusLocation;
+			Pending->StimulusStrength = Event.Strength;
+			return;
+		}
 
-				bool bForget = false;
+		// we have direct line of sight if the traces were unobstructed
+		bDirectLOS = Visibility == EShooterVisibility::Visible;
+	}
 
-				// are we forgetting the current target?
-				if (SensedActor == LambdaInstanceData->TargetActor)
-				{
-					bForget = true;
+	ProcessSensedActor(InstanceData, SensedActor, bDirectLOS, Event.StimulusLocation, Event.Strength);
+}
 
-				} else {
+/** Processes the perception events buffered on the controller since the last tick, then any pending line of sight or squad sighting */
+static void ProcessPerceptionEvents(FStateTreeSenseEnemiesInstanceData& InstanceData)
+{
+	if (!InstanceData.Controller || !InstanceData.Character)
+	{
+		return;
+	}
 
-					// are we forgetting about a partial sense?
-					if (!IsValid(LambdaInstanceData->TargetActor))
-					{
-						bForget = true;
-					}
-				}
+	// events come newest first. Only the newest event for each actor and sense matters, so a hearing or damage event can't hide a sighting.
+	// Forgetting an actor makes every older event about it moot
+	TArray<TPair<AActor*, FAISenseID>, TInlineAllocator<8>> ProcessedSenses;
+	TArray<AActor*, TInlineAllocator<4>> ForgottenActors;
 
-				if (bForget)
-				{
-					// clear the target
-					LambdaInstanceData->TargetActor = nullptr;
+	InstanceData.Controller->ConsumePerceptionEvents([&InstanceData, &ProcessedSenses, &ForgottenActors](const FShooterPerceptionEvent& Event)
+	{
+		AActor* SensedActor = Event.Actor.Get();
 
-					// clear the flags
-					LambdaInstanceData->bHasInvestigateLocation = false;
-					LambdaInstanceData->bHasTarget = false;
+		if (!SensedActor || ForgottenActors.Contains(SensedActor))
+		{
+			return;
+		}
 
-					// reset the stimulus strength
-					LambdaInstanceData->LastStimulusStrength = 0.0f;
+		if (Event.bForgotten)
+		{
+			ForgottenActors.Add(SensedActor);
+			ProcessForgottenActor(InstanceData, SensedActor);
+			return;
+		}
 
-					// clear the target on the controller
-					LambdaInstanceData->Controller->ClearCurrentTarget();
-					LambdaInstanceData->Controller->ClearFocus(EAIFocusPriority::Gameplay);
-				}
+		const TPair<AActor*, FAISenseID> Sense(SensedActor, Event.Type);
+
+		if (ProcessedSenses.Contains(Sense))
+		{
+			return;
+		}
+
+		ProcessedSenses.Add(Sense);
+
+		ProcessUpdatedActor(InstanceData, SensedActor, Event);
+	});
 
+	// are we waiting on line of sight results?
+	if (InstanceData.PendingSights.IsEmpty())
+	{
+		// without a target of our own, act on anything a nearby squad member has just seen
+		if (!IsValid(InstanceData.TargetActor))
+		{
+			if (UShooterSquadSubsystem* Squad = InstanceData.Character->GetWorld()->GetSubsystem<UShooterSquadSubsystem>())
+			{
+				if (const FShooterSquadSighting* Sighting = Squad->FindAnySighting(InstanceData.Controller, InstanceData.SenseTag))
+				{
+					ProcessSensedActor(InstanceData, Sighting->Target.Get(), true, Sighting->TargetLocation, 1.0f);
+				}
 			}
-		);
+		}
+
+		return;
 	}
 
-	return EStateTreeRunStatus::Running;
+	const double Now = InstanceData.Character->GetWorld()->GetTimeSeconds();
+
+	// process the resolved stimuli in the order they were received
+	for (int32 i = 0; i < InstanceData.PendingSights.Num(); )
+	{
+		const FShooterPendingSight Pending = InstanceData.PendingSights[i];
+		AActor* PendingActor = Pending.Actor.Get();
+
+		if (!PendingActor)
+		{
+			InstanceData.PendingSights.RemoveAt(i, EAllowShrinking::No);
+			continue;
+		}
+
+		const EShooterVisibility Visibility = GetSenseLineOfSight(InstanceData, PendingActor);
+
+		// keep waiting unless we've waited too long, in which case treat it as a partial sense
+		if (Visibility == EShooterVisibility::Unknown && Now - Pending.Time <= InstanceData.MaxSightConfirmationTime)
+		{
+			++i;
+			continue;
+		}
+
+		InstanceData.PendingSights.RemoveAt(i, EAllowShrinking::No);
+
+		ProcessSensedActor(InstanceData, PendingActor, Visibility == EShooterVisibility::Visible, Pending.StimulusLocation, Pending.StimulusStrength);
+	}
 }
 
-void FStateTreeSenseEnemiesTask::ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+EStateTreeRunStatus FStateTreeSenseEnemiesTask::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
 {
-	// have we transitioned to another state?
+	// have we transitioned from another state?
 	if (Transition.ChangeType == EStateTreeStateChangeType::Changed)
 	{
 		// get the instance data
 		FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
 
-		// unbind the perception delegates
-		InstanceData.Controller->OnShooterPerceptionUpdated.Unbind();
-		InstanceData.Controller->OnShooterPerceptionForgotten.Unbind();
+		// drop anything that was sensed while no state was listening
+		InstanceData.Controller->ClearPerceptionEvents();
 	}
+
+	return EStateTreeRunStatus::Running;
+}
+
+EStateTreeRunStatus FStateTreeSenseEnemiesTask::Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const
+{
+	// process everything sensed since the last tick in one batch
+	ProcessPerceptionEvents(Context.GetInstanceData(*this));
+
+	return EStateTreeRunStatus::Running;
 }
 
 #if WITH_EDITOR
@@ -363,4 +524,304 @@ FText FStateTreeSenseEnemiesTask::GetDescription(const FGuid& ID, FStateTreeData
 {
 	return FText::FromString("<b>Sense Enemies</b>");
 }
-#endif // WITH_EDITOR
\ No newline at end of file
+#endif // WITH_EDITOR
+
+////////////////////////////////////////////////////////////////////
+
+void FStateTreeSenseEnemiesEvaluator::TreeStart(FStateTreeExecutionContext& Context) const
+{
+	// get the instance data
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+	// drop anything that was sensed before the tree started
+	if (InstanceData.Controller)
+	{
+		InstanceData.Controller->ClearPerceptionEvents();
+	}
+}
+
+void FStateTreeSenseEnemiesEvaluator::Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const
+{
+	// process everything sensed since the last tick in one batch
+	ProcessPerceptionEvents(Context.GetInstanceData(*this));
+}
+
+#if WITH_EDITOR
+FText FStateTreeSenseEnemiesEvaluator::GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting /*= EStateTreeNodeFormatting::Text*/) const
+{
+	return FText::FromString("<b>Sense Enemies</b>");
+}
+#endif // WITH_EDITOR
+
+////////////////////////////////////////////////////////////////////
+
+EStateTreeRunStatus FStateTreePerformTraversalTask::Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const
+{
+	// get the instance data
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+	ATemporalDashCharacter* Character = InstanceData.Character;
+	ATemporalDashTraversalLink* Link = Character ? Character->GetPendingTraversalLink() : nullptr;
+
+	// nothing to traverse
+	if (!Link)
+	{
+		InstanceData.bTraversing = false;
+		return EStateTreeRunStatus::Running;
+	}
+
+	const double Now = Character->GetWorld()->GetTimeSeconds();
+
+	// is this a new link?
+	if (!InstanceData.bTraversing && InstanceData.TraversalStartTime <= 0.0)
+	{
+		InstanceData.TraversalStartTime = Now;
+	}
+
+	// give up if the ability doesn't become available or we got stuck, path following will recover
+	if (Now - InstanceData.TraversalStartTime > InstanceData.MaxTraversalTime)
+	{
+		Character->FinishPendingTraversal();
+
+		InstanceData.bTraversing = false;
+		InstanceData.TraversalStartTime = 0.0;
+
+		return EStateTreeRunStatus::Running;
+	}
+
+	if (!InstanceData.bTraversing)
+	{
+		// start crossing the link. This may fail while the ability recharges, so we keep trying
+		if (Link->GetTraversalType() == ETemporalDashTraversalType::Hook)
+		{
+			InstanceData.bTraversing = Character->HookToPoint(Link->GetHookPoint());
+
+		} else {
+
+			InstanceData.bTraversing = Character->DashInDirection(Character->GetPendingTraversalDestination() - Character->GetActorLocation());
+		}
+
+	} else {
+
+		// wait until the ability is done and we're back on the ground
+		const bool bLanded = Character->GetCharacterMovement()->IsMovingOnGround();
+
+		if (!Character->IsDashing() && !Character->IsHooked() && bLanded)
+		{
+			Character->FinishPendingTraversal();
+
+			InstanceData.bTraversing = false;
+			InstanceData.TraversalStartTime = 0.0;
+		}
+	}
+
+	return EStateTreeRunStatus::Running;
+}
+
+void FStateTreePerformTraversalTask::ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	// get the instance data
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+	// don't leave path following paused on a link
+	if (InstanceData.Character)
+	{
+		InstanceData.Character->FinishPendingTraversal();
+	}
+
+	InstanceData.bTraversing = false;
+	InstanceData.TraversalStartTime = 0.0;
+}
+
+#if WITH_EDITOR
+FText FStateTreePerformTraversalTask::GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting /*= EStateTreeNodeFormatting::Text*/) const
+{
+	return FText::FromString("<b>Perform Traversal</b>");
+}
+#endif // WITH_EDITOR
+
+////////////////////////////////////////////////////////////////////
+
+/** Tries to claim a location from the shared query and converts the result to a run status */
+static EStateTreeRunStatus ClaimSharedQueryLocation(FStateTreeClaimSharedQueryLocationInstanceData& InstanceData)
+{
+	UShooterQueryCacheSubsystem* QueryCache = InstanceData.Controller->GetWorld()->GetSubsystem<UShooterQueryCacheSubsystem>();
+
+	if (!QueryCache)
+	{
+		return EStateTreeRunStatus::Failed;
+	}
+
+	switch (QueryCache->TryClaimLocation(InstanceData.QueryTemplate, InstanceData.Controller, InstanceData.ResultLocation))
+	{
+	case EShooterQueryClaim::Claimed:
+		return EStateTreeRunStatus::Succeeded;
+
+	case EShooterQueryClaim::Pending:
+		return EStateTreeRunStatus::Running;
+
+	default:
+		return EStateTreeRunStatus::Failed;
+	}
+}
+
+EStateTreeRunStatus FStateTreeClaimSharedQueryLocationTask::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	// get the instance data
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+	InstanceData.StartTime = InstanceData.Controller->GetWorld()->GetTimeSeconds();
+
+	return ClaimSharedQueryLocation(InstanceData);
+}
+
+EStateTreeRunStatus FStateTreeClaimSharedQueryLocationTask::Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const
+{
+	// get the instance data
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+	const EStateTreeRunStatus Status = ClaimSharedQueryLocation(InstanceData);
+
+	// give up if the query is taking too long
+	if (Status == EStateTreeRunStatus::Running && InstanceData.Controller->GetWorld()->GetTimeSeconds() - InstanceData.StartTime > InstanceData.MaxWaitTime)
+	{
+		return EStateTreeRunStatus::Failed;
+	}
+
+	return Status;
+}
+
+#if WITH_EDITOR
+FText FStateTreeClaimSharedQueryLocationTask::GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting /*= EStateTreeNodeFormatting::Text*/) const
+{
+	return FText::FromString("<b>Claim Shared Query Location</b>");
+}
+#endif // WITH_EDITOR
+
+////////////////////////////////////////////////////////////////////
+
+EStateTreeRunStatus FStateTreeMoveToAsyncPathTask::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	// get the instance data
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+	UShooterPathRequestSubsystem* PathRequests = InstanceData.Controller->GetWorld()->GetSubsystem<UShooterPathRequestSubsystem>();
+
+	if (!PathRequests)
+	{
+		return EStateTreeRunStatus::Failed;
+	}
+
+	// queue the path request and wait for it on tick
+	PathRequests->RequestPath(InstanceData.Controller, InstanceData.Destination);
+
+	InstanceData.RequestTime = InstanceData.Controller->GetWorld()->GetTimeSeconds();
+	InstanceData.MoveRequestId = 0;
+	InstanceData.bMoving = false;
+
+	return EStateTreeRunStatus::Running;
+}
+
+EStateTreeRunStatus FStateTreeMoveToAsyncPathTask::Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const
+{
+	// get the instance data
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+	AShooterAIController* Controller = InstanceData.Controller;
+
+	// are we following the path already?
+	if (InstanceData.bMoving)
+	{
+		// was our move replaced by another one?
+		if (Controller->GetCurrentMoveRequestID() != FAIRequestID(InstanceData.MoveRequestId))
+		{
+			return EStateTreeRunStatus::Failed;
+		}
+
+		// has the move ended?
+		if (Controller->GetMoveStatus() == EPathFollowingStatus::Idle)
+		{
+			const UPathFollowingComponent* PathFollowing = Controller->GetPathFollowingComponent();
+			return PathFollowing && PathFollowing->DidMoveReachGoal() ? EStateTreeRunStatus::Succeeded : EStateTreeRunStatus::Failed;
+		}
+
+		return EStateTreeRunStatus::Running;
+	}
+
+	UShooterPathRequestSubsystem* PathRequests = Controller->GetWorld()->GetSubsystem<UShooterPathRequestSubsystem>();
+
+	if (!PathRequests)
+	{
+		return EStateTreeRunStatus::Failed;
+	}
+
+	FNavPathSharedPtr Path;
+
+	switch (PathRequests->GetPathResult(Controller, Path))
+	{
+	case EShooterPathRequestStatus::Pending:
+
+		// give up if the path is taking too long
+		if (Controller->GetWorld()->GetTimeSeconds() - InstanceData.RequestTime > InstanceData.MaxPathWaitTime)
+		{
+			PathRequests->CancelRequest(Controller);
+			return EStateTreeRunStatus::Failed;
+		}
+
+		return EStateTreeRunStatus::Running;
+
+	case EShooterPathRequestStatus::Succeeded:
+		break;
+
+	default:
+		return EStateTreeRunStatus::Failed;
+	}
+
+	// we own the path now, so the request can go
+	PathRequests->CancelRequest(Controller);
+
+	// follow the path we were given instead of having the controller find one
+	FAIMoveRequest MoveRequest(InstanceData.Destination);
+	MoveRequest.SetAcceptanceRadius(InstanceData.AcceptableRadius);
+
+	const FAIRequestID MoveRequestId = Controller->RequestMove(MoveRequest, Path);
+
+	if (!MoveRequestId.IsValid())
+	{
+		return EStateTreeRunStatus::Failed;
+	}
+
+	InstanceData.MoveRequestId = MoveRequestId.GetID();
+	InstanceData.bMoving = true;
+
+	return EStateTreeRunStatus::Running;
+}
+
+void FStateTreeMoveToAsyncPathTask::ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	// get the instance data
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+	AShooterAIController* Controller = InstanceData.Controller;
+
+	// drop the path request if it's still waiting
+	if (UShooterPathRequestSubsystem* PathRequests = Controller->GetWorld()->GetSubsystem<UShooterPathRequestSubsystem>())
+	{
+		PathRequests->CancelRequest(Controller);
+	}
+
+	// stop our move, but leave any move started by someone else alone
+	if (InstanceData.bMoving && Controller->GetCurrentMoveRequestID() == FAIRequestID(InstanceData.MoveRequestId))
+	{
+		Controller->StopMovement();
+	}
+
+	InstanceData.bMoving = false;
+}
+
+#if WITH_EDITOR
+FText FStateTreeMoveToAsyncPathTask::GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting /*= EStateTreeNodeFormatting::Text*/) const
+{
+	return FText::FromString("<b>Move To (Async Path)</b>");
+}
+#endif // WITH_EDITOR
@@ -5,12 +5,15 @@
 #include "CoreMinimal.h"
 #include "StateTreeTaskBase.h"
 #include "StateTreeConditionBase.h"
+#include "StateTreeEvaluatorBase.h"
 
 #include "ShooterStateTreeUtility.generated.h"
 
 class AShooterNPC;
 class AAIController;
 class AShooterAIController;
+class UEnvQuery;
+class ATemporalDashCharacter;
 
 /**
  *  Instance data struct for the FStateTreeLineOfSightToTargetCondition condition
@@ -239,7 +242,32 @@ struct FStateTreeShootAtTargetTask : public FStateTreeTaskCommonBase
 ////////////////////////////////////////////////////////////////////
 
 /**
- *  Instance data struct for the Sense Enemies StateTree task
+ *  Sight stimulus waiting on a line of sight result
+ */
+USTRUCT()
+struct FShooterPendingSight
+{
+	GENERATED_BODY()
+
+	/** Sensed actor */
+	UPROPERTY()
+	TWeakObjectPtr<AActor> Actor;
+
+	/** Location of the stimulus */
+	UPROPERTY()
+	FVector StimulusLocation = FVector::ZeroVector;
+
+	/** Strength of the stimulus */
+	UPROPERTY()
+	float StimulusStrength = 0.0f;
+
+	/** World time the stimulus was received */
+	UPROPERTY()
+	double Time = 0.0;
+};
+
+/**
+ *  Instance data struct for the Sense Enemies StateTree task and evaluator
  */
 USTRUCT()
 struct FStateTreeSenseEnemiesInstanceData
@@ -281,6 +309,14 @@ struct FStateTreeSenseEnemiesInstanceData
 	/** Strength of the last processed stimulus */
 	UPROPERTY(EditAnywhere)
 	float LastStimulusStrength = 0.0f;
+
+	/** Max time to wait on a line of sight result before treating the stimulus as a partial sense */
+	UPROPERTY(EditAnywhere, Category = Parameter, meta = (ClampMin = 0, Units = "s"))
+	float MaxSightConfirmationTime = 0.5f;
+
+	/** Sight stimuli waiting on a line of sight result, in the order they were received. At most one per actor */
+	UPROPERTY()
+	TArray<FShooterPendingSight> PendingSights;
 };
 
 /**
@@ -298,6 +334,83 @@ struct FStateTreeSenseEnemiesTask : public FStateTreeTaskCommonBase
 	/** Runs when the owning state is entered */
 	virtual EStateTreeRunStatus EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
 
+	/** Processes the perception events buffered on the controller since the last tick */
+	virtual EStateTreeRunStatus Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const override;
+
+#if WITH_EDITOR
+	virtual FText GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting = EStateTreeNodeFormatting::Text) const override;
+#endif // WITH_EDITOR
+};
+
+/**
+ *  StateTree evaluator to have an NPC process AI Perceptions and sense nearby enemies
+ *  Runs for the whole tree, so the targeting outputs are available to every state without a task in each of them
+ *  Use either this or the Sense Enemies task in a tree, since both consume the same perception events
+ */
+USTRUCT(meta=(DisplayName="Sense Enemies", Category="Shooter"))
+struct FStateTreeSenseEnemiesEvaluator : public FStateTreeEvaluatorCommonBase
+{
+	GENERATED_BODY()
+
+	/* Ensure we're using the correct instance data struct */
+	using FInstanceDataType = FStateTreeSenseEnemiesInstanceData;
+	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
+
+	/** Runs when the tree starts */
+	virtual void TreeStart(FStateTreeExecutionContext& Context) const override;
+
+	/** Processes the perception events buffered on the controller since the last tick */
+	virtual void Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const override;
+
+#if WITH_EDITOR
+	virtual FText GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting = EStateTreeNodeFormatting::Text) const override;
+#endif // WITH_EDITOR
+};
+
+////////////////////////////////////////////////////////////////////
+
+/**
+ *  Instance data struct for the Perform Traversal StateTree task
+ */
+USTRUCT()
+struct FStateTreePerformTraversalInstanceData
+{
+	GENERATED_BODY()
+
+	/** Character crossing the traversal links */
+	UPROPERTY(EditAnywhere, Category = Context)
+	TObjectPtr<ATemporalDashCharacter> Character;
+
+	/** Max time to wait for the ability and to cross the link before giving up and resuming path following */
+	UPROPERTY(EditAnywhere, Category = Parameter, meta = (ClampMin = 0, Units = "s"))
+	float MaxTraversalTime = 3.0f;
+
+	/** True while a dash or hook is crossing the pending link */
+	UPROPERTY()
+	bool bTraversing = false;
+
+	/** World time the pending link was first processed */
+	UPROPERTY()
+	double TraversalStartTime = 0.0;
+};
+
+/**
+ *  StateTree task to have an NPC cross dash and hook navigation links
+ *  Path following pauses when it reaches a traversal link. This task performs the dash or hook and resumes it when done
+ *  Meant to run in a parent state alongside the movement tasks
+ */
+USTRUCT(meta=(DisplayName="Perform Traversal", Category="Shooter"))
+struct FStateTreePerformTraversalTask : public FStateTreeTaskCommonBase
+{
+	GENERATED_BODY()
+
+	/* Ensure we're using the correct instance data struct */
+	using FInstanceDataType = FStateTreePerformTraversalInstanceData;
+	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
+
+	/** Runs while the owning state is active */
+	virtual EStateTreeRunStatus Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const override;
+
 	/** Runs when the owning state is ended */
 	virtual void ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
 
@@ -306,4 +419,126 @@ struct FStateTreeSenseEnemiesTask : public FStateTreeTaskCommonBase
 #endif // WITH_EDITOR
 };
 
-////////////////////////////////////////////////////////////////////
\ No newline at end of file
+////////////////////////////////////////////////////////////////////
+
+/**
+ *  Instance data struct for the Claim Shared Query Location StateTree task
+ */
+USTRUCT()
+struct FStateTreeClaimSharedQueryLocationInstanceData
+{
+	GENERATED_BODY()
+
+	/** NPC controller running the query */
+	UPROPERTY(EditAnywhere, Category = Context)
+	TObjectPtr<AShooterAIController> Controller;
+
+	/** EQS template to run. Should return locations, such as cover or flank points */
+	UPROPERTY(EditAnywhere, Category = Parameter)
+	TObjectPtr<UEnvQuery> QueryTemplate;
+
+	/** Max time to wait for the query results */
+	UPROPERTY(EditAnywhere, Category = Parameter, meta = (ClampMin = 0, Units = "s"))
+	float MaxWaitTime = 1.0f;
+
+	/** Claimed location */
+	UPROPERTY(EditAnywhere, Category = Output)
+	FVector ResultLocation = FVector::ZeroVector;
+
+	/** World time the task started waiting */
+	UPROPERTY()
+	double StartTime = 0.0;
+};
+
+/**
+ *  StateTree task to claim a location from an EQS query shared with other NPCs
+ *  NPCs in the same area running the same query against the same target reuse its results,
+ *  and locations claimed by other NPCs are skipped
+ */
+USTRUCT(meta=(DisplayName="Claim Shared Query Location", Category="Shooter"))
+struct FStateTreeClaimSharedQueryLocationTask : public FStateTreeTaskCommonBase
+{
+	GENERATED_BODY()
+
+	/* Ensure we're using the correct instance data struct */
+	using FInstanceDataType = FStateTreeClaimSharedQueryLocationInstanceData;
+	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
+
+	/** Runs when the owning state is entered */
+	virtual EStateTreeRunStatus EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
+
+	/** Waits for the shared query results */
+	virtual EStateTreeRunStatus Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const override;
+
+#if WITH_EDITOR
+	virtual FText GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting = EStateTreeNodeFormatting::Text) const override;
+#endif // WITH_EDITOR
+};
+
+////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////
+
+/**
+ *  Instance data struct for the Move To (Async Path) StateTree task
+ */
+USTRUCT()
+struct FStateTreeMoveToAsyncPathInstanceData
+{
+	GENERATED_BODY()
+
+	/** NPC controller to move */
+	UPROPERTY(EditAnywhere, Category = Context)
+	TObjectPtr<AShooterAIController> Controller;
+
+	/** Location to move to */
+	UPROPERTY(EditAnywhere, Category = Parameter)
+	FVector Destination = FVector::ZeroVector;
+
+	/** Distance from the destination that counts as arrived */
+	UPROPERTY(EditAnywhere, Category = Parameter, meta = (ClampMin = 0, Units = "cm"))
+	float AcceptableRadius = 50.0f;
+
+	/** Max time to wait for the path before giving up */
+	UPROPERTY(EditAnywhere, Category = Parameter, meta = (ClampMin = 0, Units = "s"))
+	float MaxPathWaitTime = 1.0f;
+
+	/** World time the path was requested */
+	UPROPERTY()
+	double RequestTime = 0.0;
+
+	/** Id of the move request once the path has arrived */
+	UPROPERTY()
+	uint32 MoveRequestId = 0;
+
+	/** True once the NPC is following the path */
+	UPROPERTY()
+	bool bMoving = false;
+};
+
+/**
+ *  StateTree task to move an NPC to a location along a path found off the game thread
+ *  The path request is queued with the other NPCs' requests and the task waits for the result before moving
+ */
+USTRUCT(meta=(DisplayName="Move To (Async Path)", Category="Shooter"))
+struct FStateTreeMoveToAsyncPathTask : public FStateTreeTaskCommonBase
+{
+	GENERATED_BODY()
+
+	/* Ensure we're using the correct instance data struct */
+	using FInstanceDataType = FStateTreeMoveToAsyncPathInstanceData;
+	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
+
+	/** Runs when the owning state is entered */
+	virtual EStateTreeRunStatus EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
+
+	/** Waits for the path, then for the move to finish */
+	virtual EStateTreeRunStatus Tick(FStateTreeExecutionContext& Context, const float DeltaTime) const override;
+
+	/** Runs when the owning state is ended */
+	virtual void ExitState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
+
+#if WITH_EDITOR
+	virtual FText GetDescription(const FGuid& ID, FStateTreeDataView InstanceDataView, const IStateTreeBindingLookup& BindingLookup, EStateTreeNodeFormatting Formatting = EStateTreeNodeFormatting::Text) const override;
+#endif // WITH_EDITOR
+};
@@ -0,0 +1,125 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/AI/ShooterVisibilityGrid.h"
+#include "Algo/BinarySearch.h"
+
+FString UShooterVisibilityGrid::GetGridPackageName(const FString& MapPackageName)
+{
+	return MapPackageName + TEXT("_VisibilityGrid");
+}
+
+int32 UShooterVisibilityGrid::GetVoxelKey(const FVector& Location) const
+{
+	const FVector Local = Location - Origin;
+
+	return GetVoxelKey(FIntVector(
+		FMath::FloorToInt(Local.X / CellSize),
+		FMath::FloorToInt(Local.Y / CellSize),
+		FMath::FloorToInt(Local.Z / CellHeight)));
+}
+
+int32 UShooterVisibilityGrid::GetVoxelKey(const FIntVector& Voxel) const
+{
+	if (Voxel.X < 0 || Voxel.Y < 0 || Voxel.Z < 0 || Voxel.X >= Dimensions.X || Voxel.Y >= Dimensions.Y || Voxel.Z >= Dimensions.Z)
+	{
+		return INDEX_NONE;
+	}
+
+	return (Voxel.Z * Dimensions.Y + Voxel.Y) * Dimensions.X + Voxel.X;
+}
+
+FVector UShooterVisibilityGrid::GetVoxelCenter(const FIntVector& Voxel) const
+{
+	return Origin + FVector((Voxel.X + 0.5f) * CellSize, (Voxel.Y + 0.5f) * CellSize, (Voxel.Z + 0.5f) * CellHeight);
+}
+
+void UShooterVisibilityGrid::FindCells(const FVector& Location, TArray<int32, TInlineAllocator<4>>& OutCells) const
+{
+	OutCells.Reset();
+
+	const FVector Local = Location - Origin;
+	const FIntVector Voxel(
+		FMath::FloorToInt(Local.X / CellSize),
+		FMath::FloorToInt(Local.Y / CellSize),
+		FMath::FloorToInt(Local.Z / CellHeight));
+
+	// a floor in the location's own voxel may be right below it
+	const int32 Key = GetVoxelKey(Voxel);
+
+	if (Key == INDEX_NONE)
+	{
+		return;
+	}
+
+	const int32 CellIndex = Algo::BinarySearch(CellKeys, Key);
+
+	if (CellIndex != INDEX_NONE)
+	{
+		OutCells.Add(CellIndex);
+	}
+
+	// floors in the voxels below were sampled up to the sample height above them. Their highest possible floor is the top of their voxel
+	const float HeightAboveVoxel = Local.Z - Voxel.Z * CellHeight;
+
+	for (int32 Below = 1; Below <= Voxel.Z && HeightAboveVoxel + (Below - 1) * CellHeight <= SampleHeight; ++Below)
+	{
+		const int32 BelowIndex = Algo::BinarySearch(CellKeys, GetVoxelKey(Voxel - FIntVector(0, 0, Below)));
+
+		if (BelowIndex != INDEX_NONE)
+		{
+			OutCells.Add(BelowIndex);
+		}
+	}
+}
+
+bool UShooterVisibilityGrid::IsPotentiallyVisible(int32 CellA, int32 CellB) const
+{
+	const int32 Row = FMath::Max(CellA, CellB);
+	const int32 Column = FMath::Min(CellA, CellB);
+
+	// treat anything out of range as visible so we never reject a pair we don't know about
+	if (Column < 0 || !RowStarts.IsValidIndex(Row + 1))
+	{
+		return true;
+	}
+
+	// the bit flips at every toggle up to and including the column
+	const TConstArrayView<uint16> Toggles = MakeArrayView(RowToggles).Slice(RowStarts[Row], RowStarts[Row + 1] - RowStarts[Row]);
+	const int32 NumFlips = Algo::UpperBound(Toggles, uint16(Column));
+
+	return (NumFlips & 1) != 0;
+}
+
+void UShooterVisibilityGrid::SetBakedData(TArray<int32>&& InCellKeys, const TArray<TBitArray<>>& Rows)
+{
+	check(InCellKeys.Num() <= MaxNumCells);
+
+	CellKeys = MoveTemp(InCellKeys);
+
+	RowStarts.Reset(Rows.Num() + 1);
+	RowToggles.Reset();
+
+	// encode each row as the columns where it flips
+	for (const TBitArray<>& Row : Rows)
+	{
+		RowStarts.Add(RowToggles.Num());
+
+		bool bPrevious = false;
+
+		for (int32 Column = 0; Column < Row.Num(); ++Column)
+		{
+			const bool bVisible = Row[Column];
+
+			if (bVisible != bPrevious)
+			{
+				RowToggles.Add(uint16(Column));
+				bPrevious = !bPrevious;
+			}
+		}
+	}
+
+	RowStarts.Add(RowToggles.Num());
+
+	RowToggles.Shrink();
+}
@@ -0,0 +1,99 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ShooterVisibilityGrid.generated.h"
+
+/**
+ *  Baked potentially visible set for AI line of sight
+ *  The level is split into voxels and only voxels with walkable navmesh are kept as cells
+ *  Each cell pair stores one bit, set if any sample at AI eye heights in one cell can see any sample in the other
+ *  A cleared bit means the pair was fully occluded by static geometry when baked, so it can be rejected without a trace
+ *  The matrix is symmetric, so only the lower triangle is stored, and each row is run length encoded
+ *  as the columns where the bits flip. Nearby cells mostly see the same things, so rows are a handful of runs instead of one bit per cell
+ *  Generated per map by the ShooterVisibilityGrid commandlet and saved next to it as <MapName>_VisibilityGrid
+ */
+UCLASS()
+class TEMPORALDASH_API UShooterVisibilityGrid : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	/** World location of the min corner of the voxel grid */
+	UPROPERTY(VisibleAnywhere, Category="Visibility Grid")
+	FVector Origin = FVector::ZeroVector;
+
+	/** Horizontal voxel size */
+	UPROPERTY(VisibleAnywhere, Category="Visibility Grid", meta = (Units = "cm"))
+	float CellSize = 400.0f;
+
+	/** Vertical voxel size */
+	UPROPERTY(VisibleAnywhere, Category="Visibility Grid", meta = (Units = "cm"))
+	float CellHeight = 200.0f;
+
+	/** Number of voxels along each axis */
+	UPROPERTY(VisibleAnywhere, Category="Visibility Grid")
+	FIntVector Dimensions = FIntVector::ZeroValue;
+
+	/** Max distance that was baked. Pairs further apart are always potentially visible */
+	UPROPERTY(VisibleAnywhere, Category="Visibility Grid", meta = (Units = "cm"))
+	float MaxDistance = 0.0f;
+
+	/** Highest sample above the floor of each cell. Locations higher above every walkable floor weren't baked */
+	UPROPERTY(VisibleAnywhere, Category="Visibility Grid", meta = (Units = "cm"))
+	float SampleHeight = 0.0f;
+
+protected:
+
+	/** Sorted voxel keys of the walkable cells. A cell's index in this array is its index in the matrix */
+	UPROPERTY()
+	TArray<int32> CellKeys;
+
+	/** Start of each row's runs in RowToggles, plus one past the end of the last row */
+	UPROPERTY()
+	TArray<int32> RowStarts;
+
+	/** Lower triangle rows, including the diagonal, stored back to back as the sorted columns where the bits flip. Every row starts cleared */
+	UPROPERTY()
+	TArray<uint16> RowToggles;
+
+public:
+
+	/** Returns the name of the grid package for the passed map package */
+	static FString GetGridPackageName(const FString& MapPackageName);
+
+	/** Max number of walkable cells a grid can hold, so columns fit the run encoding */
+	static constexpr int32 MaxNumCells = MAX_uint16;
+
+	/** Returns the number of walkable cells */
+	int32 GetNumCells() const { return CellKeys.Num(); };
+
+	/** Returns the size of the encoded matrix in bytes */
+	int64 GetMatrixSize() const { return RowStarts.GetAllocatedSize() + RowToggles.GetAllocatedSize(); }
+
+	/** Returns the voxel key for a location, or INDEX_NONE if it's outside the grid */
+	int32 GetVoxelKey(const FVector& Location) const;
+
+	/** Returns the voxel key for voxel coordinates, or INDEX_NONE if they're outside the grid */
+	int32 GetVoxelKey(const FIntVector& Voxel) const;
+
+	/** Returns the center of a voxel */
+	FVector GetVoxelCenter(const FIntVector& Voxel) const;
+
+	/**
+	 *  Finds the cells whose samples could cover the location: the cell in its own voxel, and the cells below it
+	 *  whose floor could be within the sample height. The location sees whatever any of them see
+	 *  @param Location location to find the cells for
+	 *  @param OutCells cells covering the location. Empty if the location wasn't baked, e.g. it's off the grid or too high above the floor
+	 */
+	void FindCells(const FVector& Location, TArray<int32, TInlineAllocator<4>>& OutCells) const;
+
+	/** Returns false if the two cells were fully occluded from each other when baked */
+	bool IsPotentiallyVisible(int32 CellA, int32 CellB) const;
+
+	/** Replaces the baked data. Cell keys must be sorted and rows hold the bits for every lower or equal cell */
+	void SetBakedData(TArray<int32>&& InCellKeys, const TArray<TBitArray<>>& Rows);
+};
@@ -0,0 +1,218 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/AI/ShooterVisibilityGridCommandlet.h"
+#include "TemporalDash.h"
+#include "ShooterVisibilityGrid.h"
+#include "TemporalDashCharacter.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Pawn.h"
+#include "NavigationSystem.h"
+#include "NavMesh/RecastNavMesh.h"
+#include "Async/ParallelFor.h"
+
+UShooterVisibilityGridCommandlet::UShooterVisibilityGridCommandlet()
+{
+	// make sure the navmesh matches the level geometry, since it decides which cells exist
+	bBuildNavigation = true;
+}
+
+bool UShooterVisibilityGridCommandlet::ProcessWorld(UWorld* World, const TMap<FString, FString>& ParamVals)
+{
+	// read the grid settings
+	if (const FString* Value = ParamVals.Find(TEXT("CellSize")))
+	{
+		CellSize = FMath::Max(50.0f, FCString::Atof(**Value));
+	}
+
+	if (const FString* Value = ParamVals.Find(TEXT("CellHeight")))
+	{
+		CellHeight = FMath::Max(50.0f, FCString::Atof(**Value));
+	}
+
+	if (const FString* Value = ParamVals.Find(TEXT("MaxDistance")))
+	{
+		MaxDistance = FMath::Max(0.0f, FCString::Atof(**Value));
+	}
+
+	// read the sample heights from the character that will use the grid
+	const ATemporalDashCharacter* CharacterDefaults = GetCharacterDefaults(ParamVals);
+
+	const float CapsuleHalfHeight = CharacterDefaults->GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight();
+	const float EyeZ = CapsuleHalfHeight + CharacterDefaults->BaseEyeHeight;
+
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World);
+	ARecastNavMesh* NavMesh = NavSys ? Cast<ARecastNavMesh>(NavSys->GetDefaultNavDataInstance(FNavigationSystem::DontCreate)) : nullptr;
+
+	if (!NavMesh)
+	{
+		UE_LOG(LogTemporalDash, Error, TEXT("No navmesh found. Add a Nav Mesh Bounds Volume to the map"));
+		return false;
+	}
+
+	const FBox Bounds = NavMesh->GetBounds();
+
+	if (!Bounds.IsValid)
+	{
+		UE_LOG(LogTemporalDash, Error, TEXT("The navmesh is empty"));
+		return false;
+	}
+
+	// find or create the grid asset next to the map
+	UShooterVisibilityGrid* Grid = FindOrCreateMapAsset<UShooterVisibilityGrid>(World, &UShooterVisibilityGrid::GetGridPackageName);
+
+	Grid->Origin = Bounds.Min;
+	Grid->CellSize = CellSize;
+	Grid->CellHeight = CellHeight;
+	Grid->MaxDistance = MaxDistance;
+	Grid->SampleHeight = EyeZ;
+
+	const FVector Size = Bounds.GetSize();
+	Grid->Dimensions = FIntVector(
+		FMath::Max(1, FMath::CeilToInt(Size.X / CellSize)),
+		FMath::Max(1, FMath::CeilToInt(Size.Y / CellSize)),
+		FMath::Max(1, FMath::CeilToInt(Size.Z / CellHeight)));
+
+	// voxelize the walkable navmesh. Keys come out sorted since we walk them in order
+	TArray<int32> CellKeys;
+	TArray<FVector> CellFloors;
+
+	const FVector VoxelExtent(CellSize * 0.5f, CellSize * 0.5f, CellHeight * 0.5f);
+
+	for (int32 Z = 0; Z < Grid->Dimensions.Z; ++Z)
+	{
+		for (int32 Y = 0; Y < Grid->Dimensions.Y; ++Y)
+		{
+			for (int32 X = 0; X < Grid->Dimensions.X; ++X)
+			{
+				const FIntVector Voxel(X, Y, Z);
+
+				FNavLocation Floor;
+				if (!NavSys->ProjectPointToNavigation(Grid->GetVoxelCenter(Voxel), Floor, VoxelExtent, NavMesh))
+				{
+					continue;
+				}
+
+				// the projection may land in a neighbor voxel, which will pick it up on its own
+				const int32 Key = Grid->GetVoxelKey(Voxel);
+
+				if (Grid->GetVoxelKey(Floor.Location) != Key)
+				{
+					continue;
+				}
+
+				CellKeys.Add(Key);
+				CellFloors.Add(Floor.Location);
+			}
+		}
+	}
+
+	const int32 NumCells = CellKeys.Num();
+
+	const int32 CellLimit = FMath::Min(MaxCells, UShooterVisibilityGrid::MaxNumCells);
+
+	if (NumCells > CellLimit)
+	{
+		UE_LOG(LogTemporalDash, Error, TEXT("%d walkable cells is over the limit of %d. Use a larger -CellSize"), NumCells, CellLimit);
+		return false;
+	}
+
+	UE_LOG(LogTemporalDash, Display, TEXT("Baking visibility for %d walkable cells in a %dx%dx%d grid"), NumCells, Grid->Dimensions.X, Grid->Dimensions.Y, Grid->Dimensions.Z);
+
+	// build the samples for each cell: the center at eye and chest height, then the corners at eye height
+	const float CornerOffset = CellSize * CornerSampleOffset;
+
+	TArray<TArray<FVector>> CellSamples;
+	CellSamples.SetNum(NumCells);
+
+	for (int32 CellIndex = 0; CellIndex < NumCells; ++CellIndex)
+	{
+		const FVector& Floor = CellFloors[CellIndex];
+
+		CellSamples[CellIndex] = {
+			Floor + FVector(0.0f, 0.0f, EyeZ),
+			Floor + FVector(0.0f, 0.0f, CapsuleHalfHeight),
+			Floor + FVector(CornerOffset, CornerOffset, EyeZ),
+			Floor + FVector(-CornerOffset, CornerOffset, EyeZ),
+			Floor + FVector(CornerOffset, -CornerOffset, EyeZ),
+			Floor + FVector(-CornerOffset, -CornerOffset, EyeZ)
+		};
+	}
+
+	// pawns placed in the map shouldn't count as occluders
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShooterVisibilityGridBake), false);
+
+	for (TActorIterator<APawn> It(World); It; ++It)
+	{
+		QueryParams.AddIgnoredActor(*It);
+	}
+
+	// trace every pair in the lower triangle. Rows are independent, so spread them over the worker threads
+	TArray<TBitArray<>> Rows;
+	Rows.SetNum(NumCells);
+
+	const float MaxDistanceSquared = FMath::Square(MaxDistance);
+
+	ParallelFor(NumCells, [&](int32 CellA)
+	{
+		TBitArray<>& Row = Rows[CellA];
+		Row.Init(false, CellA + 1);
+
+		// a cell can always see itself
+		Row[CellA] = true;
+
+		for (int32 CellB = 0; CellB < CellA; ++CellB)
+		{
+			// past the baked range we can't reject anything
+			if (FVector::DistSquared(CellFloors[CellA], CellFloors[CellB]) > MaxDistanceSquared)
+			{
+				Row[CellB] = true;
+				continue;
+			}
+
+			Row[CellB] = AreCellsVisible(World, CellSamples[CellA], CellSamples[CellB], QueryParams);
+		}
+	});
+
+	Grid->SetBakedData(MoveTemp(CellKeys), Rows);
+
+	// report how much we can reject
+	int64 NumVisible = 0;
+	for (const TBitArray<>& Row : Rows)
+	{
+		NumVisible += Row.CountSetBits();
+	}
+
+	const int64 NumPairs = int64(NumCells) * (NumCells + 1) / 2;
+	UE_LOG(LogTemporalDash, Display, TEXT("%lld of %lld cell pairs are potentially visible (%.1f%% rejectable)"), NumVisible, NumPairs, NumPairs > 0 ? 100.0 * (NumPairs - NumVisible) / NumPairs : 0.0);
+	UE_LOG(LogTemporalDash, Display, TEXT("Encoded matrix is %.1f KB, down from %.1f KB as a bitset"), Grid->GetMatrixSize() / 1024.0, (NumPairs + 7) / 8 / 1024.0);
+
+	return SaveMapAsset(Grid);
+}
+
+bool UShooterVisibilityGridCommandlet::AreCellsVisible(const UWorld* World, const TArray<FVector>& SamplesA, const TArray<FVector>& SamplesB, const FCollisionQueryParams& QueryParams)
+{
+	FHitResult Hit;
+
+	// trace matching samples, then the centers to every sample on the other side. Most pairs are decided by the first few traces
+	for (int32 i = 0; i < SamplesA.Num(); ++i)
+	{
+		if (!World->LineTraceSingleByChannel(Hit, SamplesA[i], SamplesB[i], ECC_Visibility, QueryParams))
+		{
+			return true;
+		}
+	}
+
+	for (int32 i = 1; i < SamplesA.Num(); ++i)
+	{
+		if (!World->LineTraceSingleByChannel(Hit, SamplesA[0], SamplesB[i], ECC_Visibility, QueryParams)
+			|| !World->LineTraceSingleByChannel(Hit, SamplesA[i], SamplesB[0], ECC_Visibility, QueryParams))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,50 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TemporalDashWorldCommandlet.h"
+#include "ShooterVisibilityGridCommandlet.generated.h"
+
+/**
+ *  Offline generator for the AI visibility grid
+ *  Voxelizes the walkable navmesh of the map and traces between the AI eye height samples of every cell pair
+ *  Saves the result as a UShooterVisibilityGrid asset next to the map, which the visibility subsystem picks up at runtime
+ *  The grid isn't referenced by the map, so its folder needs to be always cooked for packaged builds
+ *  Usage: UnrealEditor-Cmd.exe TemporalDash.uproject -run=ShooterVisibilityGrid -Map=/Game/Path/To/Map [-CellSize=400] [-CellHeight=200] [-MaxDistance=8000] [-Character=/Game/Path/To/BP_NPC.BP_NPC_C]
+ */
+UCLASS()
+class TEMPORALDASH_API UShooterVisibilityGridCommandlet : public UTemporalDashWorldCommandlet
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Horizontal voxel size */
+	float CellSize = 400.0f;
+
+	/** Vertical voxel size */
+	float CellHeight = 200.0f;
+
+	/** Pairs further apart than this aren't traced and are always potentially visible. Should cover the AI sight range */
+	float MaxDistance = 8000.0f;
+
+	/** Max number of walkable cells. Baking time grows with the square of the cell count. Can't go over UShooterVisibilityGrid::MaxNumCells */
+	int32 MaxCells = 24000;
+
+	/** Horizontal offset of the corner samples from the cell center, as a fraction of the cell size */
+	float CornerSampleOffset = 0.3f;
+
+public:
+
+	/** Constructor */
+	UShooterVisibilityGridCommandlet();
+
+protected:
+
+	/** Bakes the grid for the loaded map */
+	virtual bool ProcessWorld(UWorld* World, const TMap<FString, FString>& ParamVals) override;
+
+	/** Returns true if any trace between the two cells' samples is unobstructed */
+	static bool AreCellsVisible(const UWorld* World, const TArray<FVector>& SamplesA, const TArray<FVector>& SamplesB, const FCollisionQueryParams& QueryParams);
+};
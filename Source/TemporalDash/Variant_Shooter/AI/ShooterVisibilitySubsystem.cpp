@@ -0,0 +1,329 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Variant_Shooter/AI/ShooterVisibilitySubsystem.h"
+#include "TemporalDash.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "ShooterVisibilityGrid.h"
+#include "BreakableStructure.h"
+#include "TemporalDashMapAsset.h"
+
+DECLARE_CYCLE_STAT(TEXT("Visibility Tick"), STAT_ShooterVisibilityTick, STATGROUP_ShooterAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("LOS Queries"), STAT_ShooterVisibilityQueries, STATGROUP_ShooterAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("LOS Cache Hits"), STAT_ShooterVisibilityCacheHits, STATGROUP_ShooterAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("LOS Async Traces"), STAT_ShooterVisibilityTraces, STATGROUP_ShooterAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("LOS Queued"), STAT_ShooterVisibilityQueued, STATGROUP_ShooterAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("LOS Cached Pairs"), STAT_ShooterVisibilityCachedPairs, STATGROUP_ShooterAI);
+DECLARE_DWORD_COUNTER_STAT(TEXT("LOS Grid Rejections"), STAT_ShooterVisibilityGridRejections, STATGROUP_ShooterAI);
+
+void UShooterVisibilitySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	TraceDelegate.BindUObject(this, &UShooterVisibilitySubsystem::OnTraceCompleted);
+
+	DestructionHandle = ABreakableStructure::OnAnyStructureDestruction.AddUObject(this, &UShooterVisibilitySubsystem::OnStructureDestruction);
+}
+
+void UShooterVisibilitySubsystem::Deinitialize()
+{
+	ABreakableStructure::OnAnyStructureDestruction.Remove(DestructionHandle);
+
+	Super::Deinitialize();
+}
+
+void UShooterVisibilitySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// the grid is saved next to the map by the visibility grid commandlet
+	Grid = LoadMapSideCarAsset<UShooterVisibilityGrid>(InWorld, &UShooterVisibilityGrid::GetGridPackageName);
+
+	DirtyBounds.Reset();
+}
+
+bool UShooterVisibilitySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UShooterVisibilitySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterVisibilitySubsystem, STATGROUP_Tickables);
+}
+
+EShooterVisibility UShooterVisibilitySubsystem::GetLineOfSight(const AActor* Observer, const AActor* Target, const FVector& EyeLocation, int32 NumTargetSamples)
+{
+	if (!IsValid(Observer) || !IsValid(Target))
+	{
+		return EShooterVisibility::Unknown;
+	}
+
+	INC_DWORD_STAT(STAT_ShooterVisibilityQueries);
+
+	// reject pairs the baked grid knows are occluded before touching the cache or tracing
+	if (!IsPotentiallyVisible(EyeLocation, Target->GetActorLocation()))
+	{
+		INC_DWORD_STAT(STAT_ShooterVisibilityGridRejections);
+		return EShooterVisibility::Occluded;
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	// single traces and sampled traces can disagree, so they're cached separately
+	const FVisibilityKey Key { FObjectKey(Observer), FObjectKey(Target), NumTargetSamples };
+
+	FVisibilityEntry& Entry = Cache.FindOrAdd(Key);
+	Entry.Observer = Observer;
+	Entry.Target = Target;
+	Entry.LastQueryTime = Now;
+
+	// the latest query sets the trace start for the next refresh
+	Entry.EyeLocation = EyeLocation;
+
+	// fresh enough?
+	if (Entry.Result != EShooterVisibility::Unknown && Now - Entry.ResultTime <= MaxResultAge)
+	{
+		INC_DWORD_STAT(STAT_ShooterVisibilityCacheHits);
+		return Entry.Result;
+	}
+
+	// traces that never came back won't publish. Refresh as if there was nothing in flight
+	if (Entry.IsInFlightStale())
+	{
+		Entry.bInFlight = false;
+	}
+
+	// queue a refresh unless one is already on the way
+	if (!Entry.bQueued && !Entry.bInFlight)
+	{
+		Entry.bQueued = true;
+		SubmitQueue.Add(Key);
+	}
+
+	return Entry.Result;
+}
+
+void UShooterVisibilitySubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ShooterVisibilityTick);
+
+	Super::Tick(DeltaTime);
+
+	UWorld* World = GetWorld();
+	const double Now = World->GetTimeSeconds();
+
+	int32 TraceBudget = MaxTracesPerFrame;
+	int32 NumSubmitted = 0;
+
+	for (; NumSubmitted < SubmitQueue.Num(); ++NumSubmitted)
+	{
+		const FVisibilityKey& Key = SubmitQueue[NumSubmitted];
+
+		FVisibilityEntry* Entry = Cache.Find(Key);
+
+		// the entry may have been evicted while queued
+		if (!Entry)
+		{
+			continue;
+		}
+
+		const AActor* Observer = Entry->Observer.Get();
+		const AActor* Target = Entry->Target.Get();
+
+		if (!Observer || !Target)
+		{
+			Entry->bQueued = false;
+			continue;
+		}
+
+		const int32 NumTraces = FMath::Max(Key.NumTargetSamples, 1);
+
+		// out of budget? Always let at least one query through so big queries can't stall the queue
+		if (NumTraces > TraceBudget && TraceBudget < MaxTracesPerFrame)
+		{
+			break;
+		}
+
+		Entry->bQueued = false;
+		Entry->bInFlight = true;
+		Entry->SubmitFrame = GFrameCounter;
+
+		const uint32 QueryId = NextQueryId++;
+
+		FInFlightQuery& Query = InFlightQueries.Add(QueryId);
+		Query.Key = Key;
+		Query.NumTraces = NumTraces;
+		Query.SubmitFrame = GFrameCounter;
+
+		// ignore the observer and target. We want an unobstructed trace not counting them
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ShooterVisibility), false, Observer);
+		QueryParams.AddIgnoredActor(Target);
+
+		if (Key.NumTargetSamples <= 0)
+		{
+			World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Entry->EyeLocation, Target->GetActorLocation(), ECC_Visibility, QueryParams, FCollisionResponseParams::DefaultResponseParam, &TraceDelegate, QueryId);
+
+		} else {
+
+			// spread the traces vertically over the target bounds to try and get around low obstacles
+			FVector CenterOfMass, Extent;
+			Target->GetActorBounds(true, CenterOfMass, Extent, false);
+
+			const float ExtentZOffset = Extent.Z * 2.0f / (NumTraces + 1);
+
+			for (int32 i = 0; i < NumTraces; ++i)
+			{
+				const FVector End = CenterOfMass + FVector(0.0f, 0.0f, Extent.Z - ExtentZOffset * i);
+
+				World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Entry->EyeLocation, End, ECC_Visibility, QueryParams, FCollisionResponseParams::DefaultResponseParam, &TraceDelegate, QueryId);
+			}
+		}
+
+		TraceBudget -= NumTraces;
+		INC_DWORD_STAT_BY(STAT_ShooterVisibilityTraces, NumTraces);
+	}
+
+	SubmitQueue.RemoveAt(0, NumSubmitted, EAllowShrinking::No);
+
+	SET_DWORD_STAT(STAT_ShooterVisibilityQueued, SubmitQueue.Num());
+	SET_DWORD_STAT(STAT_ShooterVisibilityCachedPairs, Cache.Num());
+
+	// drop old entries about once a second
+	if (Now - LastEvictionTime > 1.0)
+	{
+		EvictOldEntries(Now);
+		LastEvictionTime = Now;
+	}
+}
+
+void UShooterVisibilitySubsystem::OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+	const uint32 QueryId = Datum.UserData;
+
+	// the query may have been dropped as stale
+	FInFlightQuery* QueryPtr = InFlightQueries.Find(QueryId);
+
+	if (!QueryPtr)
+	{
+		return;
+	}
+
+	FInFlightQuery& Query = *QueryPtr;
+
+	// we only need one unobstructed trace
+	const bool bBlocked = Datum.OutHits.ContainsByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; });
+
+	Query.bAnyClear |= !bBlocked;
+	++Query.NumCompleted;
+
+	if (Query.NumCompleted < Query.NumTraces)
+	{
+		return;
+	}
+
+	// publish the result
+	if (FVisibilityEntry* Entry = Cache.Find(Query.Key))
+	{
+		Entry->Result = Query.bAnyClear ? EShooterVisibility::Visible : EShooterVisibility::Occluded;
+		Entry->ResultTime = GetWorld()->GetTimeSeconds();
+		Entry->bInFlight = false;
+	}
+
+	InFlightQueries.Remove(QueryId);
+}
+
+void UShooterVisibilitySubsystem::EvictOldEntries(double Now)
+{
+	for (auto It = Cache.CreateIterator(); It; ++It)
+	{
+		const FVisibilityEntry& Entry = It.Value();
+
+		// nobody can query a pair with a destroyed actor again. The submit queue and trace callback skip missing entries
+		if (!Entry.Observer.IsValid() || !Entry.Target.IsValid())
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		// keep anything that's still waiting on traces that may come back
+		if (Entry.bQueued || (Entry.bInFlight && !Entry.IsInFlightStale()))
+		{
+			continue;
+		}
+
+		if (Now - Entry.LastQueryTime > EntryLifetime)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	// drop queries whose traces never came back
+	for (auto It = InFlightQueries.CreateIterator(); It; ++It)
+	{
+		if (GFrameCounter - It.Value().SubmitFrame > MaxInFlightFrames)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+bool UShooterVisibilitySubsystem::IsPotentiallyVisible(const FVector& From, const FVector& To) const
+{
+	if (!Grid)
+	{
+		return true;
+	}
+
+	// locations that weren't baked, e.g. off the walkable grid or high in the air, can't be rejected
+	TArray<int32, TInlineAllocator<4>> FromCells;
+	TArray<int32, TInlineAllocator<4>> ToCells;
+
+	Grid->FindCells(From, FromCells);
+	Grid->FindCells(To, ToCells);
+
+	if (FromCells.IsEmpty() || ToCells.IsEmpty())
+	{
+		return true;
+	}
+
+	// a location covered by several cells sees the union of what they see
+	for (const int32 FromCell : FromCells)
+	{
+		for (const int32 ToCell : ToCells)
+		{
+			if (Grid->IsPotentiallyVisible(FromCell, ToCell))
+			{
+				return true;
+			}
+		}
+	}
+
+	// a destructed structure may have opened up the line since the grid was baked
+	for (const FBox& Bounds : DirtyBounds)
+	{
+		if (FMath::LineBoxIntersection(Bounds, From, To, To - From))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UShooterVisibilitySubsystem::OnStructureDestruction(ABreakableStructure* Structure)
+{
+	if (!Grid || !Structure || Structure->GetWorld() != GetWorld())
+	{
+		return;
+	}
+
+	// pad the bounds by a cell, since the bake sampled lines across the cells around the structure
+	const FBox Bounds = Structure->GetComponentsBoundingBox(true).ExpandBy(Grid->CellSize);
+
+	// ignore repeated hits on the same structure
+	if (!DirtyBounds.ContainsByPredicate([&Bounds](const FBox& Existing) { return Existing.IsInside(Bounds); }))
+	{
+		DirtyBounds.Add(Bounds);
+	}
+}
@@ -0,0 +1,180 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "UObject/ObjectKey.h"
+#include "ShooterVisibilitySubsystem.generated.h"
+
+class UShooterVisibilityGrid;
+class ABreakableStructure;
+
+/** Line of sight result for an observer and target pair */
+enum class EShooterVisibility : uint8
+{
+	/** No result yet. The query was submitted and will be ready in a frame or two */
+	Unknown,
+
+	/** At least one trace towards the target was unobstructed */
+	Visible,
+
+	/** All traces towards the target were blocked */
+	Occluded
+};
+
+/**
+ *  Batches line of sight queries from all NPCs into async traces
+ *  Queries are answered from a per observer and target cache. Missing or stale results are queued,
+ *  submitted as async traces within a per-frame budget and published when the traces complete next frame
+ *  This keeps game thread trace time flat as the NPC count grows, at the cost of a frame or two of latency
+ *  If the map has a baked visibility grid, pairs it knows are occluded are rejected before any of this
+ */
+UCLASS(config=Game)
+class TEMPORALDASH_API UShooterVisibilitySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+
+	/** Max age of a cached result before it gets refreshed */
+	UPROPERTY(config, EditAnywhere, Category="Visibility", meta = (ClampMin = 0, ClampMax = 5, Units = "s"))
+	float MaxResultAge = 0.2f;
+
+	/** Max number of async traces submitted per frame. Queries over budget wait for the next frame */
+	UPROPERTY(config, EditAnywhere, Category="Visibility", meta = (ClampMin = 1, ClampMax = 1024))
+	int32 MaxTracesPerFrame = 64;
+
+	/** Cached pairs that haven't been queried for this long are dropped */
+	UPROPERTY(config, EditAnywhere, Category="Visibility", meta = (ClampMin = 0, ClampMax = 60, Units = "s"))
+	float EntryLifetime = 2.0f;
+
+	/** Async traces normally complete next frame. Queries still running after this many frames are assumed lost and resubmitted */
+	static constexpr uint64 MaxInFlightFrames = 4;
+
+	/** Key for an observer and target pair, traced with a given number of samples */
+	struct FVisibilityKey
+	{
+		FObjectKey Observer;
+		FObjectKey Target;
+
+		/** Number of vertically spread traces towards the target bounds. Zero traces to the target's location instead */
+		int32 NumTargetSamples = 0;
+
+		bool operator==(const FVisibilityKey& Other) const { return Observer == Other.Observer && Target == Other.Target && NumTargetSamples == Other.NumTargetSamples; }
+
+		friend uint32 GetTypeHash(const FVisibilityKey& Key) { return HashCombineFast(HashCombineFast(GetTypeHash(Key.Observer), GetTypeHash(Key.Target)), ::GetTypeHash(Key.NumTargetSamples)); }
+	};
+
+	/** Cached result and latest query parameters for an observer and target pair */
+	struct FVisibilityEntry
+	{
+		TWeakObjectPtr<const AActor> Observer;
+		TWeakObjectPtr<const AActor> Target;
+
+		/** Trace start, from the latest query */
+		FVector EyeLocation = FVector::ZeroVector;
+
+		EShooterVisibility Result = EShooterVisibility::Unknown;
+		double ResultTime = 0.0;
+		double LastQueryTime = 0.0;
+
+		/** True while waiting in the submission queue */
+		bool bQueued = false;
+
+		/** True while async traces are running */
+		bool bInFlight = false;
+
+		/** Frame the latest async traces were submitted on */
+		uint64 SubmitFrame = 0;
+
+		/** Returns true if the entry's async traces have been running for too long to still be expected */
+		bool IsInFlightStale() const { return bInFlight && GFrameCounter - SubmitFrame > MaxInFlightFrames; }
+	};
+
+	/** A query whose async traces are running */
+	struct FInFlightQuery
+	{
+		FVisibilityKey Key;
+		int32 NumTraces = 0;
+		int32 NumCompleted = 0;
+		bool bAnyClear = false;
+
+		/** Frame the traces were submitted on */
+		uint64 SubmitFrame = 0;
+	};
+
+	/** Cached results */
+	TMap<FVisibilityKey, FVisibilityEntry> Cache;
+
+	/** Pairs waiting to be submitted, in query order */
+	TArray<FVisibilityKey> SubmitQueue;
+
+	/** Queries waiting on async traces, by id. The id is passed to the traces as user data.
+	 *  Ids aren't reused, so traces completing after their query was dropped as stale are ignored */
+	TMap<uint32, FInFlightQuery> InFlightQueries;
+
+	/** Id for the next in flight query */
+	uint32 NextQueryId = 0;
+
+	/** Async trace completion delegate */
+	FTraceDelegate TraceDelegate;
+
+	/** Time of the last pass over the cache to drop old entries */
+	double LastEvictionTime = 0.0;
+
+	/** Baked visibility grid for the map, if one was generated */
+	UPROPERTY(Transient)
+	TObjectPtr<UShooterVisibilityGrid> Grid;
+
+	/** Bounds of breakable structures destructed since the grid was baked. Pairs whose line crosses one can't be rejected */
+	TArray<FBox> DirtyBounds;
+
+	/** Handle for the breakable structure destruction delegate */
+	FDelegateHandle DestructionHandle;
+
+public:
+
+	/** Subsystem initialization */
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** Subsystem cleanup */
+	virtual void Deinitialize() override;
+
+	/** Loads the visibility grid for the map */
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Only game worlds run AI */
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Submits queued queries as async traces */
+	virtual void Tick(float DeltaTime) override;
+
+	/** Returns the stat id for the tickable */
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 *  Returns the latest line of sight result between the observer and target
+	 *  Missing or stale results are queued for refresh. The latest known result is returned in the meantime
+	 *  @param Observer actor looking. Ignored by the traces
+	 *  @param Target actor to look at. Ignored by the traces
+	 *  @param EyeLocation location to trace from
+	 *  @param NumTargetSamples number of vertically spread traces towards the target bounds. Zero traces to the target's location
+	 */
+	EShooterVisibility GetLineOfSight(const AActor* Observer, const AActor* Target, const FVector& EyeLocation, int32 NumTargetSamples = 0);
+
+	/** Returns false if the baked visibility grid knows the two locations are occluded from each other */
+	bool IsPotentiallyVisible(const FVector& From, const FVector& To) const;
+
+protected:
+
+	/** Called when an async trace completes */
+	void OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Datum);
+
+	/** Drops entries that haven't been queried for a while or have invalid actors, and queries whose traces were lost */
+	void EvictOldEntries(double Now);
+
+	/** Marks the area of a destructed breakable structure as no longer matching the baked grid */
+	void OnStructureDestruction(ABreakableStructure* Structure);
+};
@@ -162,7 +162,7 @@ void AShooterProjectile::ProcessHit(AActor* HitActor, UPrimitiveComponent* HitCo
 
 	if (bExplodeOnHit) {
 		if (ABreakableStructure* Breakable = Cast<ABreakableStructure>(HitActor)) {
-			Breakable->OnDestruction(HitLocation);
+			Breakable->Destruct(HitLocation, HitDirection, BreakStrength);
 		}
 	}
 }
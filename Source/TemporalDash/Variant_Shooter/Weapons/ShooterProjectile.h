@@ -65,6 +65,10 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Projectile|Explosion", meta = (ClampMin = 0, ClampMax = 5000, Units = "cm"))
 	float ExplosionRadius = 500.0f;	
 
+	/** Scales the fields applied to breakable structures hit by the explosion */
+	UPROPERTY(EditAnywhere, Category="Projectile|Explosion", meta = (ClampMin = 0, ClampMax = 10))
+	float BreakStrength = 1.0f;
+
 	/** If true, this projectile has already hit another surface */
 	bool bHit = false;
 
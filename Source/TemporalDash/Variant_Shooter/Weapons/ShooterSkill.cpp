@@ -4,8 +4,53 @@
 #include "Variant_Shooter/Weapons/ShooterSkill.h"
 #include "Variant_Shooter/ShooterCharacter.h"
 #include "Variant_Shooter/Weapons/ShooterWeapon.h"
+#include "TemporalDashAbilityResourceComponent.h"
+
+void AShooterSkill::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// register our charges with the owner. Skills of the same class share them, so re-picking a skill won't reset its cooldown
+	if (UTemporalDashAbilityResourceComponent* AbilityResources = GetOwnerAbilityResources())
+	{
+		AbilityResources->RegisterAbility(GetSkillAbilityName(), SkillCharges, SkillCooldown);
+	}
+}
+
+UTemporalDashAbilityResourceComponent* AShooterSkill::GetOwnerAbilityResources() const
+{
+	const ATemporalDashCharacter* OwnerCharacter = Cast<ATemporalDashCharacter>(GetOwner());
+	return OwnerCharacter ? OwnerCharacter->GetAbilityResources() : nullptr;
+}
+
+bool AShooterSkill::CanFire() const
+{
+	const UTemporalDashAbilityResourceComponent* AbilityResources = GetOwnerAbilityResources();
+	return !AbilityResources || AbilityResources->HasCharge(GetSkillAbilityName());
+}
+
+float AShooterSkill::GetRemainingCooldown() const
+{
+	const UTemporalDashAbilityResourceComponent* AbilityResources = GetOwnerAbilityResources();
+	return AbilityResources ? AbilityResources->GetRemainingCooldown(GetSkillAbilityName()) : 0.0f;
+}
+
+int32 AShooterSkill::GetAvailableCharges() const
+{
+	const UTemporalDashAbilityResourceComponent* AbilityResources = GetOwnerAbilityResources();
+	return AbilityResources ? AbilityResources->GetAvailableCharges(GetSkillAbilityName()) : 0;
+}
 
 void AShooterSkill::FireProjectile(const FVector& TargetLocation) {
+	// spend a charge
+	if (UTemporalDashAbilityResourceComponent* AbilityResources = GetOwnerAbilityResources())
+	{
+		if (!AbilityResources->TryConsume(GetSkillAbilityName()))
+		{
+			return;
+		}
+	}
+
 	if (AShooterCharacter* OwnerCharacter = Cast<AShooterCharacter>(WeaponOwner))
 	BP_OnSkillActivate(OwnerCharacter, TargetLocation);
 }
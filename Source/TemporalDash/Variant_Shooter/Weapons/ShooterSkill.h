@@ -7,6 +7,7 @@
 #include "ShooterSkill.generated.h"
 
 class AShooterCharacter;
+class UTemporalDashAbilityResourceComponent;
 
 /**
  * 
@@ -16,11 +17,41 @@ class TEMPORALDASH_API AShooterSkill : public AShooterWeapon
 {
 	GENERATED_BODY()
 protected:
+
+	/** Time it takes to recharge a single use of this skill. Zero disables the cooldown */
+	UPROPERTY(EditAnywhere, Category="Cooldown", meta = (ClampMin = 0, ClampMax = 120, Units = "s"))
+	float SkillCooldown = 0.0f;
+
+	/** Number of times the skill can be used back to back before waiting for the cooldown */
+	UPROPERTY(EditAnywhere, Category="Cooldown", meta = (ClampMin = 1, ClampMax = 5))
+	int32 SkillCharges = 1;
+
+	/** Registers the skill's charges with the owner */
+	virtual void BeginPlay() override;
+
 	virtual void FireProjectile(const FVector& TargetLocation) override;
 
+	/** Returns the owner's ability resources component, if any */
+	UTemporalDashAbilityResourceComponent* GetOwnerAbilityResources() const;
+
 public:
 	virtual void DestroyWeapon() override;
 
+	/** Skills can only fire while they have a charge ready */
+	virtual bool CanFire() const override;
+
+	/** Returns the ability resource name used for this skill's charges */
+	UFUNCTION(BlueprintPure, Category="Cooldown")
+	FName GetSkillAbilityName() const { return GetClass()->GetFName(); }
+
+	/** Returns the time until the next skill charge is ready, or zero if ready */
+	UFUNCTION(BlueprintPure, Category="Cooldown")
+	float GetRemainingCooldown() const;
+
+	/** Returns the number of skill charges ready to be used */
+	UFUNCTION(BlueprintPure, Category="Cooldown")
+	int32 GetAvailableCharges() const;
+
 	virtual void ActivateWeapon();
 
 	/** Deactivates this weapon */
@@ -100,6 +100,13 @@ void AShooterWeapon::StartFiring()
 		// Play a dry-fire sound if needed
 		return;
 	}
+
+	// ensure the weapon is ready
+	if (!CanFire())
+	{
+		return;
+	}
+
 	// raise the firing flag
 	bIsFiring = true;
 
@@ -135,6 +142,15 @@ void AShooterWeapon::StopFiring()
 	}
 }
 
+void AShooterWeapon::RefillAmmo()
+{
+	StopFiring();
+
+	// same as a freshly spawned weapon
+	CurrentBullets = MagazineSize;
+	RemainingMagazines = FMath::Max(0, MaxMagazines - 1);
+}
+
 void AShooterWeapon::Fire()
 {
 	// ensure the player still wants to fire. They may have let go of the trigger
@@ -142,6 +158,12 @@ void AShooterWeapon::Fire()
 	{
 		return;
 	}
+
+	// ensure the weapon is still ready, e.g. a skill may have gone on cooldown
+	if (!CanFire())
+	{
+		return;
+	}
 	
 	// guard: ensure we have bullets
 	if (CurrentBullets <= 0)
@@ -264,8 +286,9 @@ void AShooterWeapon::FireProjectile(const FVector& TargetLocation)
 
 FTransform AShooterWeapon::CalculateProjectileSpawnTransform(const FVector& TargetLocation) const
 {
-	// find the muzzle location
-	const FVector MuzzleLoc = FirstPersonMesh->GetSocketLocation(MuzzleSocketName);
+	// find the muzzle location. AI doesn't animate its first person meshes, so use the third person one
+	const USkeletalMeshComponent* MuzzleMesh = PawnOwner.IsValid() && !PawnOwner->IsPlayerControlled() ? ThirdPersonMesh : FirstPersonMesh;
+	const FVector MuzzleLoc = MuzzleMesh->GetSocketLocation(MuzzleSocketName);
 
 	// calculate the spawn location ahead of the muzzle
 	const FVector SpawnLoc = MuzzleLoc + ((TargetLocation - MuzzleLoc).GetSafeNormal() * MuzzleOffset);
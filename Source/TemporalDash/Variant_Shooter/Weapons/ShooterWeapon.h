@@ -155,6 +155,9 @@ public:
 	/** Stop firing this weapon */
 	void StopFiring();
 	
+	/** Returns true if the weapon is ready to fire. Lets subclasses gate firing on extra resources */
+	virtual bool CanFire() const { return true; }
+
 	/** Returns true if the weapon has no bullets and no spare magazines */
 	bool IsEmpty() const { return CurrentBullets <= 0 && RemainingMagazines <= 0; }
 
@@ -201,5 +204,8 @@ public:
 	/** Returns true if weapon updates HUD every shot */
 	bool ShouldUpdateHUDPerShot() const { return bUpdateHUDPerShot; }
 
+	/** Stops firing and refills the magazine and spare magazines, e.g. when a pooled NPC is reused */
+	void RefillAmmo();
+
 	virtual void DestroyWeapon();
 };